@@ -2,6 +2,9 @@
 #include "CoreWindow.hpp"
 #include "ActivationFunctionContext.hpp"
 #include "FontContext.hpp"
+#include "TextBatch.hpp"
+#include "JobSystem.hpp"
+#include "CoreProfiler.hpp"
 #include "StateManager.hpp"
 #include "CoreLogger.hpp"
 #include "VehicleBuilder.hpp"
@@ -32,8 +35,11 @@ CoreEngine::~CoreEngine()
 void CoreEngine::Loop()
 {
 	CoreWindow& window = CoreWindow::GetInstance();
+	PROFILE_THREAD("Render");
 	while (window.IsOpen())
 	{
+		PROFILE_ZONE("CoreEngine::Loop");
+
 		// Clear
 		window.Clear();
 
@@ -56,6 +62,9 @@ void CoreEngine::Loop()
 		// Draw
 		m_stateManager->Draw();
 
+		// Draw texts
+		TextBatch::Draw();
+
 		// Display
 		window.Display();
 	}
@@ -65,6 +74,7 @@ bool CoreEngine::Load()
 {
 	CoreLogger::Initialize();
 	CoreWindow::Initialize();
+	JobSystem::Initialize();
 	ActivationFunctionContext::Initialize();
 	
 	if (!VehicleBuilder::Initialize())
@@ -0,0 +1,577 @@
+#include "CoreEvaluator.hpp"
+#include "CoreWindow.hpp"
+#include "CoreLogger.hpp"
+#include "JobSystem.hpp"
+#include "ActivationFunctionContext.hpp"
+#include "ArtificialNeuralNetwork.hpp"
+#include "ArtificialNeuralNetworkBuilder.hpp"
+#include "PopulationArchive.hpp"
+#include "MapBuilder.hpp"
+#include "MapPrototype.hpp"
+#include "VehicleBuilder.hpp"
+#include "VehiclePrototype.hpp"
+#include "SimulatedWorld.hpp"
+#include "FitnessSystem.hpp"
+#include "RateScheduler.hpp"
+#include "ContinuousTimer.hpp"
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+	// Returns string with JSON special characters escaped
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string result;
+		result.reserve(text.size());
+		for (const char character : text)
+		{
+			switch (character)
+			{
+				case '"':
+					result += "\\\"";
+					break;
+				case '\\':
+					result += "\\\\";
+					break;
+				case '\n':
+					result += "\\n";
+					break;
+				case '\t':
+					result += "\\t";
+					break;
+				default:
+					result += character;
+			}
+		}
+
+		return result;
+	}
+
+	// Returns string quoted for CSV if it contains separator, quote or new line
+	std::string EscapeCsv(const std::string& text)
+	{
+		if (text.find_first_of(",\"\n") == std::string::npos)
+			return text;
+
+		std::string result = "\"";
+		for (const char character : text)
+		{
+			if (character == '"')
+				result += '"';
+			result += character;
+		}
+
+		return result + "\"";
+	}
+}
+
+CoreEvaluator::CoreEvaluator(const std::vector<std::string>& arguments) :
+	m_exitCode(1),
+	m_csvFormat(false),
+	m_dynamicsType(BOX2D_DYNAMICS),
+	m_deathOnEdgeContact(false),
+	m_physicsRate(600),
+	m_sensorRate(60),
+	m_controllerRate(60),
+	m_requiredFitnessImprovement(0.05),
+	m_requiredFitnessImprovementRise(3.0),
+	m_maxTime(600.0),
+	m_numberOfWorkers(JobSystem::GetDefaultNumberOfWorkers())
+{
+	if (!ParseArguments(arguments))
+	{
+		PrintUsage();
+		return;
+	}
+
+	if (!Load())
+		return;
+
+	Evaluate();
+	if (WriteResults())
+		m_exitCode = 0;
+}
+
+CoreEvaluator::~CoreEvaluator()
+{
+	for (const auto& mapPrototype : m_mapPrototypes)
+		delete mapPrototype;
+	for (const auto& vehiclePrototype : m_vehiclePrototypes)
+		delete vehiclePrototype;
+	for (const auto& networkPrototype : m_networkPrototypes)
+		delete networkPrototype;
+}
+
+bool CoreEvaluator::InitializeHeadless(sf::Vector2f windowSize, size_t numberOfWorkers)
+{
+	// Builders validate prototypes against window size, window itself is not created
+	CoreLogger::Initialize();
+	if (windowSize.x <= 0.f || windowSize.y <= 0.f)
+		windowSize = CoreWindow::CalculateWindowSize();
+	if (windowSize.x <= 0.f || windowSize.y <= 0.f)
+		windowSize = sf::Vector2f(1600.f, 900.f); // There is no display, use 1920x1080 desktop window size
+	CoreWindow::InitializeHeadless(windowSize);
+	JobSystem::Initialize(numberOfWorkers);
+	ActivationFunctionContext::Initialize();
+	if (!VehicleBuilder::Initialize() || !MapBuilder::Initialize() || !ArtificialNeuralNetworkBuilder::Initialize())
+	{
+		std::cerr << "Cannot initialize builders" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool CoreEvaluator::ParseNumber(const std::string& text, size_t& value)
+{
+	try
+	{
+		size_t position = 0;
+		value = size_t(std::stoull(text, &position));
+		return position == text.size();
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool CoreEvaluator::ParseNumber(const std::string& text, double& value)
+{
+	try
+	{
+		size_t position = 0;
+		value = std::stod(text, &position);
+		return position == text.size();
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+bool CoreEvaluator::ParseWindowSize(const std::string& text, sf::Vector2f& windowSize)
+{
+	const size_t separator = text.find('x');
+	double width = 0.0, height = 0.0;
+	if (separator == std::string::npos ||
+		!ParseNumber(text.substr(0, separator), width) ||
+		!ParseNumber(text.substr(separator + 1), height) ||
+		width <= 0.0 || height <= 0.0)
+		return false;
+
+	windowSize = sf::Vector2f(float(width), float(height));
+	return true;
+}
+
+bool CoreEvaluator::ParseArguments(const std::vector<std::string>& arguments)
+{
+	if (arguments.empty() || arguments[0] != "--evaluate")
+		return false;
+
+	bool explicitFormat = false;
+	std::vector<std::string>* list = nullptr;
+	for (size_t i = 1; i < arguments.size(); ++i)
+	{
+		const std::string& argument = arguments[i];
+		if (argument.compare(0, 2, "--") != 0)
+		{
+			// Filenames are added to the last list option
+			if (!list)
+			{
+				std::cerr << "Unexpected argument \"" << argument << "\"" << std::endl;
+				return false;
+			}
+
+			list->push_back(argument);
+			continue;
+		}
+
+		list = nullptr;
+		if (argument == "--maps")
+			list = &m_mapFilenames;
+		else if (argument == "--vehicles")
+			list = &m_vehicleFilenames;
+		else if (argument == "--networks")
+			list = &m_networkFilenames;
+		else if (argument == "--death-on-edge-contact")
+			m_deathOnEdgeContact = true;
+		else
+		{
+			// The rest of options have value
+			if (i + 1 >= arguments.size())
+			{
+				std::cerr << "Missing value of option " << argument << std::endl;
+				return false;
+			}
+
+			const std::string& value = arguments[++i];
+			bool success = true;
+			if (argument == "--output")
+				m_outputFilename = value;
+			else if (argument == "--format")
+			{
+				success = value == "json" || value == "csv";
+				m_csvFormat = value == "csv";
+				explicitFormat = true;
+			}
+			else if (argument == "--dynamics")
+			{
+				m_dynamicsType = NUMBER_OF_DYNAMICS_TYPES;
+				for (int dynamicsType = 0; dynamicsType < NUMBER_OF_DYNAMICS_TYPES; ++dynamicsType)
+				{
+					if (value == DynamicsTypeStrings[dynamicsType])
+						m_dynamicsType = dynamicsType;
+				}
+				success = m_dynamicsType != NUMBER_OF_DYNAMICS_TYPES;
+			}
+			else if (argument == "--physics-rate")
+				success = ParseNumber(value, m_physicsRate) && m_physicsRate;
+			else if (argument == "--sensor-rate")
+				success = ParseNumber(value, m_sensorRate);
+			else if (argument == "--controller-rate")
+				success = ParseNumber(value, m_controllerRate);
+			else if (argument == "--required-fitness-improvement")
+				success = ParseNumber(value, m_requiredFitnessImprovement);
+			else if (argument == "--required-fitness-improvement-rise")
+				success = ParseNumber(value, m_requiredFitnessImprovementRise) && m_requiredFitnessImprovementRise > 0.0;
+			else if (argument == "--max-time")
+				success = ParseNumber(value, m_maxTime) && m_maxTime > 0.0;
+			else if (argument == "--workers")
+				success = ParseNumber(value, m_numberOfWorkers);
+			else if (argument == "--window-size")
+				success = ParseWindowSize(value, m_windowSize);
+			else
+			{
+				std::cerr << "Unknown option " << argument << std::endl;
+				return false;
+			}
+
+			if (!success)
+			{
+				std::cerr << "Incorrect value \"" << value << "\" of option " << argument << std::endl;
+				return false;
+			}
+		}
+	}
+
+	if (m_mapFilenames.empty() || m_vehicleFilenames.empty() || m_networkFilenames.empty())
+	{
+		std::cerr << "At least one map, vehicle and network has to be specified" << std::endl;
+		return false;
+	}
+
+	// Format is taken from output file extension unless it was specified
+	const std::string csvExtension = ".csv";
+	if (!explicitFormat && m_outputFilename.size() >= csvExtension.size())
+		m_csvFormat = m_outputFilename.compare(m_outputFilename.size() - csvExtension.size(), csvExtension.size(), csvExtension) == 0;
+
+	return true;
+}
+
+bool CoreEvaluator::Load()
+{
+	if (!InitializeHeadless(m_windowSize, m_numberOfWorkers))
+		return false;
+
+	// Load maps, map builder holds vehicle start position of the last loaded map
+	std::vector<std::pair<sf::Vector2f, double>> vehicleStarts;
+	for (const auto& filename : m_mapFilenames)
+	{
+		MapBuilder mapBuilder;
+		if (!mapBuilder.Load(filename))
+		{
+			std::cerr << "Cannot load map \"" << filename << "\": " << mapBuilder.GetLastOperationStatus().second << std::endl;
+			return false;
+		}
+
+		m_mapPrototypes.push_back(mapBuilder.Get());
+		m_mapPrototypes.back()->CalculateProperties();
+		vehicleStarts.emplace_back(mapBuilder.GetVehicleCenter(), mapBuilder.GetVehicleAngle());
+	}
+
+	// Every vehicle is placed at the start of every map
+	m_vehiclePrototypes.resize(m_mapFilenames.size() * m_vehicleFilenames.size(), nullptr);
+	m_vehicleCollisions.resize(m_vehiclePrototypes.size(), false);
+	for (size_t vehicleIndex = 0; vehicleIndex < m_vehicleFilenames.size(); ++vehicleIndex)
+	{
+		VehicleBuilder vehicleBuilder;
+		if (!vehicleBuilder.Load(m_vehicleFilenames[vehicleIndex]))
+		{
+			std::cerr << "Cannot load vehicle \"" << m_vehicleFilenames[vehicleIndex] << "\": " << vehicleBuilder.GetLastOperationStatus().second << std::endl;
+			return false;
+		}
+
+		for (size_t mapIndex = 0; mapIndex < m_mapPrototypes.size(); ++mapIndex)
+		{
+			const size_t index = mapIndex * m_vehicleFilenames.size() + vehicleIndex;
+			VehiclePrototype* vehiclePrototype = vehicleBuilder.Get();
+			vehiclePrototype->SetCenter(vehicleStarts[mapIndex].first);
+			vehiclePrototype->SetAngle(vehicleStarts[mapIndex].second);
+			vehiclePrototype->Update();
+			m_vehiclePrototypes[index] = vehiclePrototype;
+			m_vehicleCollisions[index] = m_mapPrototypes[mapIndex]->IsCollision(vehiclePrototype);
+		}
+	}
+
+	for (const auto& filename : m_networkFilenames)
+	{
+		if (!LoadNetwork(filename))
+			return false;
+	}
+
+	CoreLogger::PrintSuccess("Headless evaluation loaded " + std::to_string(m_mapPrototypes.size()) + " maps, " +
+		std::to_string(m_vehicleFilenames.size()) + " vehicles and " + std::to_string(m_networks.size()) + " networks");
+	return true;
+}
+
+bool CoreEvaluator::LoadNetwork(const std::string& filename)
+{
+	ArtificialNeuralNetworkBuilder artificialNeuralNetworkBuilder;
+	PopulationArchive populationArchive;
+	if (populationArchive.Open(filename))
+	{
+		if (!populationArchive.GetNumberOfIndividuals())
+		{
+			std::cerr << "Population archive \"" << filename << "\" is empty" << std::endl;
+			return false;
+		}
+
+		// Individuals share topology of the archive, the first individual is used to validate it
+		const Neuron* firstIndividual = populationArchive.GetIndividual(0);
+		artificialNeuralNetworkBuilder.SetNeuronLayerSizes(populationArchive.GetNeuronLayerSizes());
+		artificialNeuralNetworkBuilder.SetActivationFunctionIndexes(populationArchive.GetActivationFunctionIndexes());
+		artificialNeuralNetworkBuilder.SetBiasVector(populationArchive.GetBiasVector());
+		artificialNeuralNetworkBuilder.SetRawNeuronData(NeuronLayer(firstIndividual, firstIndividual + populationArchive.GetNumberOfWeights()));
+		ArtificialNeuralNetwork* artificialNeuralNetwork = artificialNeuralNetworkBuilder.Get();
+		if (!artificialNeuralNetwork)
+		{
+			std::cerr << "Cannot load population archive \"" << filename << "\": " << artificialNeuralNetworkBuilder.GetLastOperationStatus().second << std::endl;
+			return false;
+		}
+
+		m_networkPrototypes.push_back(artificialNeuralNetwork);
+		for (size_t i = 0; i < populationArchive.GetNumberOfIndividuals(); ++i)
+		{
+			const Neuron* individual = populationArchive.GetIndividual(i);
+			m_networks.push_back({ filename, i, m_networkPrototypes.size() - 1, NeuronLayer(individual, individual + populationArchive.GetNumberOfWeights()) });
+		}
+
+		return true;
+	}
+
+	if (!artificialNeuralNetworkBuilder.Load(filename))
+	{
+		std::cerr << "Cannot load network \"" << filename << "\": " << artificialNeuralNetworkBuilder.GetLastOperationStatus().second << std::endl;
+		return false;
+	}
+
+	ArtificialNeuralNetwork* artificialNeuralNetwork = artificialNeuralNetworkBuilder.Get();
+	artificialNeuralNetwork->SetFromRawData(artificialNeuralNetworkBuilder.GetRawNeuronData());
+	m_networkPrototypes.push_back(artificialNeuralNetwork);
+	m_networks.push_back({ filename, std::string::npos, m_networkPrototypes.size() - 1, NeuronLayer() });
+	return true;
+}
+
+void CoreEvaluator::Evaluate()
+{
+	// Every combination has its own world, combinations are independent so they are simulated in parallel
+	m_results.resize(m_mapPrototypes.size() * m_vehicleFilenames.size() * m_networks.size());
+	JobSystem::GetInstance().ParallelFor(0, m_results.size(), 1, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			EvaluateCombination(i);
+	});
+}
+
+void CoreEvaluator::EvaluateCombination(size_t index)
+{
+	Result& result = m_results[index];
+	result.m_networkIndex = index % m_networks.size();
+	result.m_vehicleIndex = (index / m_networks.size()) % m_vehicleFilenames.size();
+	result.m_mapIndex = index / (m_networks.size() * m_vehicleFilenames.size());
+
+	const size_t vehiclePrototypeIndex = result.m_mapIndex * m_vehicleFilenames.size() + result.m_vehicleIndex;
+	MapPrototype* mapPrototype = m_mapPrototypes[result.m_mapIndex];
+	VehiclePrototype* vehiclePrototype = m_vehiclePrototypes[vehiclePrototypeIndex];
+	const Network& network = m_networks[result.m_networkIndex];
+	const ArtificialNeuralNetwork* networkPrototype = m_networkPrototypes[network.m_prototypeIndex];
+	if (m_vehicleCollisions[vehiclePrototypeIndex])
+	{
+		result.m_status = STATUS_VEHICLE_COLLIDES_WITH_EDGES;
+		return;
+	}
+
+	if (networkPrototype->GetNumberOfInputNeurons() != vehiclePrototype->GetNumberOfSensors())
+	{
+		result.m_status = STATUS_NETWORK_INPUT_MISMATCH;
+		return;
+	}
+
+	ArtificialNeuralNetwork* artificialNeuralNetwork = ArtificialNeuralNetworkBuilder::Copy(networkPrototype);
+	if (!network.m_weights.empty())
+		artificialNeuralNetwork->SetFromRawData(network.m_weights.data());
+
+	// Simulation is set up the same way as in simulation state but with single vehicle
+	FitnessSystem fitnessSystem(1, mapPrototype->GetNumberOfCheckpoints(), m_requiredFitnessImprovement);
+	SimulatedWorld simulatedWorld(m_dynamicsType);
+	simulatedWorld.AddMap(mapPrototype);
+	if (m_deathOnEdgeContact)
+		simulatedWorld.EnableDeathOnEdgeContact();
+	simulatedWorld.AddCheckpointFunction(fitnessSystem.GetCheckpointFunction());
+	SimulatedVehicles simulatedVehicles(1, simulatedWorld.AddVehicle(vehiclePrototype));
+	SimulatedVehicle* simulatedVehicle = simulatedVehicles.front();
+
+	RateScheduler rateScheduler(m_physicsRate, m_sensorRate, m_controllerRate);
+	ContinuousTimer requiredFitnessImprovementRiseTimer(0.0, m_requiredFitnessImprovementRise);
+	const float timeStep = float(rateScheduler.GetPhysicsTimeStep());
+	const size_t maxNumberOfSteps = size_t(m_maxTime / rateScheduler.GetPhysicsTimeStep());
+	result.m_status = STATUS_TIMEOUT;
+	while (rateScheduler.GetStep() < maxNumberOfSteps)
+	{
+		if (rateScheduler.IsSensorTick())
+			simulatedWorld.UpdateSensors(rateScheduler.GetSensorTimeStep());
+
+		if (rateScheduler.IsControllerTick())
+			simulatedVehicle->ProcessInput(artificialNeuralNetwork->Update(simulatedVehicle->ProcessOutput()));
+
+		simulatedVehicle->Update(timeStep);
+		simulatedWorld.Step(timeStep);
+		rateScheduler.Step();
+
+		if (!simulatedVehicle->IsActive())
+		{
+			result.m_status = STATUS_CRASHED;
+			break;
+		}
+
+		if (size_t(simulatedVehicle->GetFitness()) == size_t(fitnessSystem.GetMaxFitness()))
+		{
+			result.m_status = STATUS_COMPLETED;
+			break;
+		}
+
+		// Vehicle which has not made required fitness improvement is stopped like in simulation state
+		if (requiredFitnessImprovementRiseTimer.Update(rateScheduler.GetPhysicsTimeStep()))
+		{
+			fitnessSystem.Punish(simulatedVehicles);
+			if (!simulatedVehicle->IsActive())
+			{
+				result.m_status = STATUS_STALLED;
+				break;
+			}
+		}
+	}
+
+	result.m_fitness = simulatedVehicle->GetFitness();
+	result.m_fitnessRatio = fitnessSystem.ToFitnessRatio(result.m_fitness);
+	result.m_time = double(rateScheduler.GetStep()) * rateScheduler.GetPhysicsTimeStep();
+	result.m_crashed = result.m_status == STATUS_CRASHED || result.m_status == STATUS_STALLED;
+	result.m_crashPoint = simulatedVehicle->GetCenter();
+	delete artificialNeuralNetwork;
+}
+
+bool CoreEvaluator::WriteResults() const
+{
+	if (m_outputFilename.empty())
+	{
+		m_csvFormat ? WriteCsv(std::cout) : WriteJson(std::cout);
+		std::cout.flush();
+		return bool(std::cout);
+	}
+
+	std::ofstream output(m_outputFilename);
+	if (!output.is_open())
+	{
+		std::cerr << "Cannot open output file \"" << m_outputFilename << "\"" << std::endl;
+		return false;
+	}
+
+	m_csvFormat ? WriteCsv(output) : WriteJson(output);
+	output.close();
+	if (output.fail())
+	{
+		std::cerr << "Cannot write output file \"" << m_outputFilename << "\"" << std::endl;
+		return false;
+	}
+
+	CoreLogger::PrintSuccess("Results of " + std::to_string(m_results.size()) + " combinations written to " + m_outputFilename);
+	return true;
+}
+
+void CoreEvaluator::WriteJson(std::ostream& output) const
+{
+	output.precision(std::numeric_limits<double>::max_digits10);
+	output << "{\n\t\"results\": [";
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const Result& result = m_results[i];
+		const Network& network = m_networks[result.m_networkIndex];
+		output << (i ? ",\n" : "\n") << "\t\t{ "
+			<< "\"map\": \"" << EscapeJson(m_mapFilenames[result.m_mapIndex]) << "\", "
+			<< "\"vehicle\": \"" << EscapeJson(m_vehicleFilenames[result.m_vehicleIndex]) << "\", "
+			<< "\"network\": \"" << EscapeJson(network.m_filename) << "\", "
+			<< "\"individual\": ";
+		if (network.m_individual == std::string::npos)
+			output << "null";
+		else
+			output << network.m_individual;
+		output << ", \"status\": \"" << m_statusStrings[result.m_status] << "\", "
+			<< "\"fitness\": " << result.m_fitness << ", "
+			<< "\"fitnessRatio\": " << result.m_fitnessRatio << ", "
+			<< "\"time\": " << result.m_time << ", "
+			<< "\"crashPoint\": ";
+		if (result.m_crashed)
+			output << "[" << result.m_crashPoint.x << ", " << result.m_crashPoint.y << "]";
+		else
+			output << "null";
+		output << " }";
+	}
+
+	output << "\n\t]\n}\n";
+}
+
+void CoreEvaluator::WriteCsv(std::ostream& output) const
+{
+	output.precision(std::numeric_limits<double>::max_digits10);
+	output << "map,vehicle,network,individual,status,fitness,fitness_ratio,time,crash_x,crash_y\n";
+	for (const auto& result : m_results)
+	{
+		const Network& network = m_networks[result.m_networkIndex];
+		output << EscapeCsv(m_mapFilenames[result.m_mapIndex]) << ','
+			<< EscapeCsv(m_vehicleFilenames[result.m_vehicleIndex]) << ','
+			<< EscapeCsv(network.m_filename) << ',';
+		if (network.m_individual != std::string::npos)
+			output << network.m_individual;
+		output << ',' << m_statusStrings[result.m_status] << ','
+			<< result.m_fitness << ','
+			<< result.m_fitnessRatio << ','
+			<< result.m_time << ',';
+		if (result.m_crashed)
+			output << result.m_crashPoint.x << ',' << result.m_crashPoint.y;
+		else
+			output << ',';
+		output << '\n';
+	}
+}
+
+void CoreEvaluator::PrintUsage()
+{
+	std::cerr <<
+		"Usage: --evaluate --maps <files> --vehicles <files> --networks <files> [options]\n"
+		"Every combination of map, vehicle and network is evaluated, population archives can be given as networks\n"
+		"Options:\n"
+		"  --output <file>                            Results file, results are written to the standard output if not specified\n"
+		"  --format json|csv                          Results format, taken from output file extension by default\n"
+		"  --dynamics Box2D|Kinematic                 Vehicle dynamics, Box2D by default\n"
+		"  --death-on-edge-contact                    Vehicle crashes when it touches an edge\n"
+		"  --physics-rate <hertz>                     Physics rate, 600 by default\n"
+		"  --sensor-rate <hertz>                      Sensor rate, 60 by default\n"
+		"  --controller-rate <hertz>                  Controller rate, 60 by default\n"
+		"  --required-fitness-improvement <ratio>     Required fitness improvement, 0.05 by default\n"
+		"  --required-fitness-improvement-rise <s>    Time between fitness improvement checks, 3 seconds by default\n"
+		"  --max-time <s>                             Max simulated time of one combination, 600 seconds by default\n"
+		"  --window-size <width>x<height>             Window size which maps and vehicles were created with, desktop based by default\n"
+		"  --workers <number>                         Number of worker threads, number of hardware threads minus one by default\n";
+}
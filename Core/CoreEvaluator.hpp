@@ -0,0 +1,143 @@
+#pragma once
+#include "Neural.hpp"
+#include "Genetic.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class MapPrototype;
+class VehiclePrototype;
+
+// Headless evaluation of every combination of maps, vehicles and artificial neural networks
+// Window is not created, combinations are simulated in parallel and results are written as JSON or CSV
+// Population archives can be given instead of artificial neural networks, then every individual is evaluated
+class CoreEvaluator final
+{
+public:
+
+	explicit CoreEvaluator(const std::vector<std::string>& arguments);
+
+	~CoreEvaluator();
+
+	// Returns process exit code, zero if all combinations were evaluated and results were written
+	inline int GetExitCode() const
+	{
+		return m_exitCode;
+	}
+
+	// Initializes logger, window size, job system and builders without creating window
+	// If window size is not positive it is calculated from desktop resolution
+	static bool InitializeHeadless(sf::Vector2f windowSize, size_t numberOfWorkers);
+
+	// Parses unsigned number, returns false if text is not a number
+	static bool ParseNumber(const std::string& text, size_t& value);
+
+	// Parses floating point number, returns false if text is not a number
+	static bool ParseNumber(const std::string& text, double& value);
+
+	// Parses window size given as <width>x<height>, returns false if text is incorrect
+	static bool ParseWindowSize(const std::string& text, sf::Vector2f& windowSize);
+
+private:
+
+	// Parses command line arguments, returns false if they are incorrect
+	bool ParseArguments(const std::vector<std::string>& arguments);
+
+	// Initializes builders and loads maps, vehicles and artificial neural networks
+	bool Load();
+
+	// Loads artificial neural network file or population archive
+	bool LoadNetwork(const std::string& filename);
+
+	// Evaluates all combinations in parallel
+	void Evaluate();
+
+	// Simulates single combination until vehicle finishes, crashes, stalls or runs out of time
+	void EvaluateCombination(size_t index);
+
+	// Writes results to the output file or to the standard output
+	bool WriteResults() const;
+
+	// Writes results as JSON
+	void WriteJson(std::ostream& output) const;
+
+	// Writes results as CSV
+	void WriteCsv(std::ostream& output) const;
+
+	// Prints command line usage to the standard error
+	static void PrintUsage();
+
+	// Evaluation statuses
+	enum
+	{
+		STATUS_COMPLETED,
+		STATUS_CRASHED,
+		STATUS_STALLED,
+		STATUS_TIMEOUT,
+		STATUS_VEHICLE_COLLIDES_WITH_EDGES,
+		STATUS_NETWORK_INPUT_MISMATCH,
+		STATUSES_COUNT
+	};
+
+	// Artificial neural network to evaluate, individuals of population archive share prototype
+	struct Network
+	{
+		std::string m_filename;
+		size_t m_individual; // Index in population archive, npos if network was loaded from artificial neural network file
+		size_t m_prototypeIndex;
+		NeuronLayer m_weights; // Empty if prototype weights are used
+	};
+
+	// Result of single combination
+	struct Result
+	{
+		size_t m_mapIndex = 0;
+		size_t m_vehicleIndex = 0;
+		size_t m_networkIndex = 0;
+		size_t m_status = STATUS_TIMEOUT;
+		Fitness m_fitness = 0.0;
+		Fitness m_fitnessRatio = 0.0;
+		double m_time = 0.0; // Simulated time, completion time if vehicle finished
+		bool m_crashed = false; // True if crash point is valid
+		sf::Vector2f m_crashPoint;
+	};
+
+	int m_exitCode;
+
+	// Input files
+	std::vector<std::string> m_mapFilenames;
+	std::vector<std::string> m_vehicleFilenames;
+	std::vector<std::string> m_networkFilenames;
+	std::string m_outputFilename; // Results are written to the standard output if empty
+	bool m_csvFormat;
+
+	// Simulation parameters
+	int m_dynamicsType;
+	bool m_deathOnEdgeContact;
+	size_t m_physicsRate;
+	size_t m_sensorRate;
+	size_t m_controllerRate;
+	double m_requiredFitnessImprovement;
+	double m_requiredFitnessImprovementRise;
+	double m_maxTime;
+	sf::Vector2f m_windowSize; // Calculated from desktop resolution if not specified
+	size_t m_numberOfWorkers;
+
+	// Loaded objects, vehicle prototypes are placed at the start of every map
+	std::vector<MapPrototype*> m_mapPrototypes;
+	std::vector<VehiclePrototype*> m_vehiclePrototypes; // One per map and vehicle pair
+	std::vector<bool> m_vehicleCollisions; // One per map and vehicle pair
+	std::vector<ArtificialNeuralNetwork*> m_networkPrototypes;
+	std::vector<Network> m_networks;
+	std::vector<Result> m_results;
+
+	inline static const char* const m_statusStrings[STATUSES_COUNT] = {
+		"completed",
+		"crashed",
+		"stalled",
+		"timeout",
+		"vehicle_collides_with_edges",
+		"network_input_mismatch"
+	};
+};
@@ -1,42 +1,183 @@
 #include "CoreLogger.hpp"
 #include <algorithm>
-#include <chrono>
+#include <cstring>
 #include <ctime>
 
-std::ofstream CoreLogger::m_output;
+namespace
+{
+	const char* const LevelPrefixes[CoreLogger::LEVELS_COUNT] = {
+		"Debug: ",
+		"Message: ",
+		"Success: ",
+		"Warning: ",
+		"Error: "
+	};
+}
+
+void CoreLogger::PrintWarning(const std::string& message)
+{
+	Print(LEVEL_WARNING, message);
+}
+
+void CoreLogger::PrintError(const std::string& message)
+{
+	Print(LEVEL_ERROR, message);
+}
 
-void CoreLogger::PrintWarning(std::string message)
+void CoreLogger::PrintSuccess(const std::string& message)
 {
-	PrintInternal("Warning: ", message);
+	Print(LEVEL_SUCCESS, message);
 }
 
-void CoreLogger::PrintError(std::string message)
+void CoreLogger::PrintMessage(const std::string& message)
 {
-	PrintInternal("Error: ", message);
+	Print(LEVEL_MESSAGE, message);
 }
 
-void CoreLogger::PrintSuccess(std::string message)
+void CoreLogger::Print(size_t level, const std::string& message, size_t numberOfSuppressedMessages)
 {
-	PrintInternal("Success: ", message);
+	level = std::min<size_t>(level, LEVEL_ERROR);
+	if (level < m_minimumLevel.load(std::memory_order_relaxed))
+		return;
+
+	// Producer is counted before it checks running state so that terminate cannot miss its message
+	m_numberOfProducers.fetch_add(1);
+	if (m_running.load())
+	{
+		if (!Push(level, message, numberOfSuppressedMessages))
+			m_numberOfDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_numberOfProducers.fetch_sub(1, std::memory_order_release);
 }
 
-void CoreLogger::PrintMessage(std::string message)
+void CoreLogger::SetMinimumLevel(size_t level)
 {
-	PrintInternal("Message: ", message);
+	m_minimumLevel.store(std::min<size_t>(level, LEVEL_ERROR));
 }
 
 void CoreLogger::Initialize()
 {
+	if (m_running.load())
+		return;
+
 	const auto now = std::chrono::system_clock::now();
 	std::time_t cnow = std::chrono::system_clock::to_time_t(now);
 	std::string filename = std::ctime(&cnow);
 	std::replace(filename.begin(), filename.end(), ' ', '_');
 	std::replace(filename.begin(), filename.end(), ':', '_');
 	m_output.open(filename.substr(0, filename.size() - 1) + ".log");
+	if (!m_output.is_open())
+		return;
+
+	// Ring buffer is allocated once, after terminate all its slots are free again and positions are kept
+	if (!m_slots)
+	{
+		m_slots = std::make_unique<Slot[]>(m_capacity);
+		for (size_t i = 0; i < m_capacity; ++i)
+			m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+		m_enqueuePosition.store(0);
+		m_dequeuePosition = 0;
+	}
+
+	m_running.store(true);
+	m_thread = std::thread(Run);
+}
+
+void CoreLogger::Terminate()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_running.load())
+			return;
+		m_running.store(false);
+	}
+
+	m_condition.notify_one();
+	if (m_thread.joinable())
+		m_thread.join();
+
+	// Producers which have seen logger running finish their messages, all claimed slots are written
+	while (m_numberOfProducers.load(std::memory_order_acquire) || m_dequeuePosition != m_enqueuePosition.load(std::memory_order_acquire))
+	{
+		if (!Drain())
+			std::this_thread::yield();
+	}
+
+	// Messages dropped by the last producers are reported too
+	Drain();
+	m_output.flush();
+	m_output.close();
+}
+
+bool CoreLogger::Push(size_t level, const std::string& message, size_t numberOfSuppressedMessages)
+{
+	// Producers claim consecutive positions, slot is free when its sequence equals the position
+	size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+	Slot* slot = nullptr;
+	while (true)
+	{
+		slot = &m_slots[position & (m_capacity - 1)];
+		const size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+		const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+		if (difference == 0)
+		{
+			if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+			return false;
+		else
+			position = m_enqueuePosition.load(std::memory_order_relaxed);
+	}
+
+	// Too long messages are truncated
+	slot->m_level = level;
+	slot->m_numberOfSuppressedMessages = numberOfSuppressedMessages;
+	slot->m_length = std::min(message.size(), sizeof(slot->m_text));
+	std::memcpy(slot->m_text, message.data(), slot->m_length);
+	slot->m_sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+size_t CoreLogger::Drain()
+{
+	size_t numberOfWrittenMessages = 0;
+	while (true)
+	{
+		Slot& slot = m_slots[m_dequeuePosition & (m_capacity - 1)];
+		if (slot.m_sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+			break;
+
+		m_output << LevelPrefixes[slot.m_level];
+		m_output.write(slot.m_text, std::streamsize(slot.m_length));
+		if (slot.m_numberOfSuppressedMessages)
+			m_output << " (" << slot.m_numberOfSuppressedMessages << " similar messages suppressed)";
+		m_output << '\n';
+
+		// Slot is handed back to producers for the next lap of the ring buffer
+		slot.m_sequence.store(m_dequeuePosition + m_capacity, std::memory_order_release);
+		++m_dequeuePosition;
+		++numberOfWrittenMessages;
+	}
+
+	const size_t numberOfDroppedMessages = m_numberOfDroppedMessages.exchange(0, std::memory_order_relaxed);
+	if (numberOfDroppedMessages)
+		m_output << LevelPrefixes[LEVEL_WARNING] << numberOfDroppedMessages << " messages were dropped because log buffer was full\n";
+	return numberOfWrittenMessages;
 }
 
-void CoreLogger::PrintInternal(const char* prefix, std::string& message)
+void CoreLogger::Run()
 {
-	if (m_output.is_open())
-		m_output << prefix << message << std::endl;
+	// Producers do not notify, writer wakes up periodically and flushes the file when there is nothing more to write
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_running.load())
+	{
+		lock.unlock();
+		const size_t numberOfWrittenMessages = Drain();
+		if (numberOfWrittenMessages)
+			m_output.flush();
+		lock.lock();
+		if (!numberOfWrittenMessages)
+			m_condition.wait_for(lock, std::chrono::milliseconds(10), [] { return !m_running.load(); });
+	}
 }
@@ -1,25 +1,110 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
+// Debug messages are compiled only in debug builds, in release builds the message expression is not even evaluated
+#ifdef _DEBUG
+#define LOG_DEBUG(message) CoreLogger::Print(CoreLogger::LEVEL_DEBUG, message)
+#else
+#define LOG_DEBUG(message)
+#endif
+
+// Every call site has its own limit of messages per second, message expression is evaluated only if it is going to be logged
+#define LOG_RATE_LIMITED(level, message) \
+	do \
+	{ \
+		static CoreLogger::RateLimiter logRateLimiter; \
+		if (logRateLimiter.Allow()) \
+			CoreLogger::Print(level, message, logRateLimiter.TakeNumberOfSuppressedMessages()); \
+	} while (false)
+
+// Asynchronous logger, messages are put into lock-free ring buffer and written to file by background thread
+// Caller never waits for disk, if the ring buffer is full the message is dropped and counted
 class CoreLogger final
 {
 public:
 
+	// Log levels
+	enum
+	{
+		LEVEL_DEBUG,
+		LEVEL_MESSAGE,
+		LEVEL_SUCCESS,
+		LEVEL_WARNING,
+		LEVEL_ERROR,
+		LEVELS_COUNT
+	};
+
+	// Limits number of messages logged per second from one call site, suppressed messages are counted
+	class RateLimiter final
+	{
+		std::atomic<long long> m_windowStart;
+		std::atomic<size_t> m_numberOfMessages; // Number of messages in current window
+		std::atomic<size_t> m_numberOfSuppressedMessages;
+		const size_t m_limit;
+
+	public:
+
+		RateLimiter(size_t limit = 5) :
+			m_windowStart(0),
+			m_numberOfMessages(0),
+			m_numberOfSuppressedMessages(0),
+			m_limit(limit)
+		{
+		}
+
+		// Returns true if message can be logged in current one second window
+		inline bool Allow()
+		{
+			const long long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			long long windowStart = m_windowStart.load(std::memory_order_relaxed);
+			if (now - windowStart >= 1000 && m_windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+				m_numberOfMessages.store(0, std::memory_order_relaxed);
+
+			if (m_numberOfMessages.fetch_add(1, std::memory_order_relaxed) < m_limit)
+				return true;
+
+			m_numberOfSuppressedMessages.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// Returns number of messages suppressed since the last logged message and resets it
+		inline size_t TakeNumberOfSuppressedMessages()
+		{
+			return m_numberOfSuppressedMessages.exchange(0, std::memory_order_relaxed);
+		}
+	};
+
 	// Prints warning to the output file
-	static void PrintWarning(std::string message);
+	static void PrintWarning(const std::string& message);
 
 	// Prints error to the output file
-	static void PrintError(std::string message);
+	static void PrintError(const std::string& message);
 
 	// Prints success to the output file
-	static void PrintSuccess(std::string message);
+	static void PrintSuccess(const std::string& message);
 
 	// Prints simple message to the output file
-	static void PrintMessage(std::string message);
+	static void PrintMessage(const std::string& message);
+
+	// Queues message of given level, messages below minimum level are ignored, unknown levels are logged as errors
+	static void Print(size_t level, const std::string& message, size_t numberOfSuppressedMessages = 0);
+
+	// Sets minimum level of logged messages
+	static void SetMinimumLevel(size_t level);
 
-	// Opens output log file for message redirection 
+	// Opens output log file for message redirection and starts writer thread
 	static void Initialize();
 
+	// Writes queued messages, stops writer thread and closes output log file
+	static void Terminate();
+
 	CoreLogger() = delete;
 
 	CoreLogger(const CoreLogger&) = delete;
@@ -28,8 +113,35 @@ public:
 
 private:
 
-	// Internal print function implementation for all print function types
-	static void PrintInternal(const char* prefix, std::string& message);
+	// Ring buffer slot, sequence tells whether slot is free for producer or ready for writer
+	struct Slot
+	{
+		std::atomic<size_t> m_sequence;
+		size_t m_level;
+		size_t m_numberOfSuppressedMessages;
+		size_t m_length;
+		char m_text[240];
+	};
+
+	// Reserves slot and copies message into it, returns false if ring buffer is full
+	static bool Push(size_t level, const std::string& message, size_t numberOfSuppressedMessages);
+
+	// Writes all messages which are ready, called only by writer thread, returns number of written messages
+	static size_t Drain();
+
+	// Writes messages until logger is terminated, the last messages are written by terminate
+	static void Run();
 
-	static std::ofstream m_output;
-};
\ No newline at end of file
+	inline static const size_t m_capacity = 4096; // Has to be power of two
+	inline static std::unique_ptr<Slot[]> m_slots;
+	inline static std::atomic<size_t> m_enqueuePosition = 0;
+	inline static size_t m_dequeuePosition = 0; // Used only by writer thread
+	inline static std::atomic<size_t> m_numberOfDroppedMessages = 0;
+	inline static std::atomic<size_t> m_numberOfProducers = 0; // Producers which may still push, terminate waits for them
+	inline static std::atomic<size_t> m_minimumLevel = LEVEL_DEBUG;
+	inline static std::atomic<bool> m_running = false;
+	inline static std::thread m_thread;
+	inline static std::mutex m_mutex; // Guards only sleeping of writer thread
+	inline static std::condition_variable m_condition;
+	inline static std::ofstream m_output; // Used only by writer thread while it runs
+};
@@ -0,0 +1,190 @@
+#include "CoreProfiler.hpp"
+#include "CoreLogger.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+void CoreProfiler::ChangeState()
+{
+#ifdef PROFILER_ENABLED
+	// State is changed only if it was not changed by generation boundary in the meantime
+	size_t state = m_state.load();
+	switch (state)
+	{
+		case TRACE_OFF:
+			m_state.compare_exchange_strong(state, TRACE_WAITING);
+			break;
+		case TRACE_WAITING:
+			m_state.compare_exchange_strong(state, TRACE_OFF);
+			break;
+		case TRACE_RECORDING:
+			m_state.compare_exchange_strong(state, TRACE_STOPPING);
+			break;
+		default:
+			break;
+	}
+#endif
+}
+
+void CoreProfiler::BeginGeneration(size_t generation)
+{
+	// Transitions are made only from the state that was read, request changed in the meantime is handled with the next generation
+	size_t state = m_state.load();
+	switch (state)
+	{
+		case TRACE_WAITING:
+		{
+			if (!m_state.compare_exchange_strong(state, TRACE_RECORDING))
+				break;
+
+			// Events of previous trace are skipped, buffers are written only by their threads
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (auto& buffer : m_threadBuffers)
+					buffer->m_firstEvent = buffer->m_head.load(std::memory_order_acquire);
+			}
+
+			m_firstGeneration.store(generation);
+			m_recording.store(true);
+			break;
+		}
+		case TRACE_STOPPING:
+		{
+			m_recording.store(false);
+			const size_t firstGeneration = m_firstGeneration.load();
+			const size_t lastGeneration = generation > firstGeneration ? generation - 1 : firstGeneration;
+			std::ostringstream stream;
+			stream << "trace_generations_" << firstGeneration << "-" << lastGeneration << ".json";
+			if (Export(stream.str()))
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_lastTrace = stream.str();
+			}
+			m_state.compare_exchange_strong(state, TRACE_OFF);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void CoreProfiler::Reset()
+{
+	m_recording.store(false);
+	m_state.store(TRACE_OFF);
+}
+
+std::string CoreProfiler::ToString()
+{
+#ifdef PROFILER_ENABLED
+	switch (m_state.load())
+	{
+		case TRACE_WAITING:
+			return "Starts with next generation";
+		case TRACE_RECORDING:
+			return "Recording since generation " + std::to_string(m_firstGeneration.load());
+		case TRACE_STOPPING:
+			return "Stops with next generation";
+		default:
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_lastTrace.empty() ? "Off" : "Off (saved " + m_lastTrace + ")";
+		}
+	}
+#else
+	return "Disabled in this build";
+#endif
+}
+
+void CoreProfiler::SetThreadName(const char* name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	buffer.m_name = name;
+}
+
+void CoreProfiler::Record(const char* name, long long start, long long finish)
+{
+	// Only calling thread writes to its buffer, event is published by the release store of the head
+	ThreadBuffer& buffer = GetThreadBuffer();
+	if (!buffer.m_events)
+		buffer.m_events = std::make_unique<Event[]>(m_bufferCapacity);
+	const size_t head = buffer.m_head.load(std::memory_order_relaxed);
+	buffer.m_events[head % m_bufferCapacity] = { name, start, finish - start };
+	buffer.m_head.store(head + 1, std::memory_order_release);
+}
+
+CoreProfiler::ThreadBuffer& CoreProfiler::GetThreadBuffer()
+{
+	// Buffers are owned by profiler so that events of finished threads can still be exported
+	thread_local ThreadBuffer* threadBuffer = nullptr;
+	if (!threadBuffer)
+	{
+		auto buffer = std::make_unique<ThreadBuffer>();
+		threadBuffer = buffer.get();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		buffer->m_index = m_threadBuffers.size();
+		buffer->m_name = "Thread " + std::to_string(buffer->m_index);
+		m_threadBuffers.push_back(std::move(buffer));
+	}
+
+	return *threadBuffer;
+}
+
+bool CoreProfiler::Export(const std::string& filename)
+{
+	std::ofstream output(filename);
+	if (!output.is_open())
+	{
+		CoreLogger::PrintError("Cannot open trace file \"" + filename + "\"");
+		return false;
+	}
+
+	// Timestamps and durations are written in microseconds
+	output << std::fixed << std::setprecision(3);
+	output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	size_t numberOfOverwrittenEvents = 0;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& buffer : m_threadBuffers)
+	{
+		output << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->m_index;
+		output << ",\"args\":{\"name\":\"" << buffer->m_name << "\"}}";
+		first = false;
+
+		// Events are allocated before the first event is published, buffer without events is not read
+		const size_t head = buffer->m_head.load(std::memory_order_acquire);
+		if (head == buffer->m_firstEvent)
+			continue;
+
+		// The oldest events are overwritten if ring buffer is full
+		// Zones that were open when recording stopped can still be written, so the oldest events that they could overwrite are skipped
+		size_t firstEvent = buffer->m_firstEvent;
+		if (head - firstEvent > m_bufferCapacity - m_unsafeEvents)
+		{
+			numberOfOverwrittenEvents += head - firstEvent - (m_bufferCapacity - m_unsafeEvents);
+			firstEvent = head - (m_bufferCapacity - m_unsafeEvents);
+		}
+
+		for (size_t i = firstEvent; i < head; ++i)
+		{
+			const Event& event = buffer->m_events[i % m_bufferCapacity];
+			output << ",\n{\"name\":\"" << event.m_name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->m_index;
+			output << ",\"ts\":" << double(event.m_start) / 1000.0 << ",\"dur\":" << double(event.m_duration) / 1000.0 << "}";
+		}
+	}
+	output << "\n]}\n";
+
+	if (!output)
+	{
+		CoreLogger::PrintError("Cannot write trace file \"" + filename + "\"");
+		return false;
+	}
+
+	if (numberOfOverwrittenEvents)
+		CoreLogger::PrintWarning("Trace \"" + filename + "\" lost " + std::to_string(numberOfOverwrittenEvents) + " oldest events, ring buffers were full");
+	CoreLogger::PrintSuccess("Trace was saved to \"" + filename + "\"");
+	return true;
+}
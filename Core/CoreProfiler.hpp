@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Zones are compiled in debug builds, in release builds only if ENABLE_PROFILER is defined
+#if defined(_DEBUG) || defined(ENABLE_PROFILER)
+#define PROFILER_ENABLED
+#endif
+
+#ifdef PROFILER_ENABLED
+#define PROFILE_CONCATENATE_INTERNAL(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_INTERNAL(a, b)
+#define PROFILE_ZONE(name) CoreProfiler::Zone PROFILE_CONCATENATE(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_THREAD(name) CoreProfiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD(name)
+#endif
+
+// Records durations of scoped zones while a window of generations is traced and exports them as chrome://tracing JSON
+// Every thread writes to its own ring buffer without locking, if the buffer is full the oldest zones are overwritten
+class CoreProfiler final
+{
+public:
+
+	// Measures time between its construction and destruction, nothing is recorded if tracing is off
+	class Zone final
+	{
+		const char* m_name;
+		long long m_start;
+
+	public:
+
+		inline Zone(const char* name) :
+			m_name(name),
+			m_start(m_recording.load(std::memory_order_relaxed) ? GetTime() : -1)
+		{
+		}
+
+		inline ~Zone()
+		{
+			if (m_start >= 0)
+				Record(m_name, m_start, GetTime());
+		}
+
+		Zone(const Zone&) = delete;
+
+		const Zone& operator=(const Zone&) = delete;
+	};
+
+	// Tracing states
+	enum
+	{
+		TRACE_OFF,
+		TRACE_WAITING, // Recording starts with the next generation
+		TRACE_RECORDING,
+		TRACE_STOPPING // Recording stops and trace is exported with the next generation
+	};
+
+	// Requests next state of tracing, tracing starts and stops only on generation boundaries
+	static void ChangeState();
+
+	// Marks beginning of generation, starts or stops recording if it was requested
+	static void BeginGeneration(size_t generation);
+
+	// Stops recording without exporting the trace
+	static void Reset();
+
+	// Returns tracing state and the last exported trace as a string
+	static std::string ToString();
+
+	// Sets name of calling thread shown in the trace
+	static void SetThreadName(const char* name);
+
+	CoreProfiler() = delete;
+
+	CoreProfiler(const CoreProfiler&) = delete;
+
+	const CoreProfiler& operator=(const CoreProfiler&) = delete;
+
+private:
+
+	struct Event
+	{
+		const char* m_name;
+		long long m_start; // Nanoseconds since the start of the application
+		long long m_duration; // Nanoseconds
+	};
+
+	// Ring buffer of one thread, events are written only by its thread and read only while the trace is exported
+	// Events are allocated with the first recorded event so that threads which are never traced do not take memory
+	struct ThreadBuffer
+	{
+		std::unique_ptr<Event[]> m_events;
+		std::atomic<size_t> m_head = 0; // Number of recorded events, also the ones which were overwritten
+		size_t m_firstEvent = 0; // The first event of current trace, guarded by profiler mutex
+		std::string m_name; // Guarded by profiler mutex
+		size_t m_index = 0;
+	};
+
+	// Returns time since the start of the application in nanoseconds
+	inline static long long GetTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+	}
+
+	// Adds event to the ring buffer of calling thread
+	static void Record(const char* name, long long start, long long finish);
+
+	// Returns ring buffer of calling thread, buffer is created on first use
+	static ThreadBuffer& GetThreadBuffer();
+
+	// Writes events of all threads as chrome://tracing JSON, returns false if file cannot be written
+	static bool Export(const std::string& filename);
+
+	inline static const std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+	inline static const size_t m_bufferCapacity = 1 << 18;
+	inline static const size_t m_unsafeEvents = 64; // The oldest events of full buffer that zones still open during export can overwrite
+	inline static std::atomic<bool> m_recording = false;
+	inline static std::atomic<size_t> m_state = TRACE_OFF;
+	inline static std::atomic<size_t> m_firstGeneration = 0;
+	inline static std::mutex m_mutex; // Guards thread buffers list, thread names and the last exported trace
+	inline static std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+	inline static std::string m_lastTrace;
+};
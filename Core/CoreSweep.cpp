@@ -0,0 +1,659 @@
+#include "CoreSweep.hpp"
+#include "CoreEvaluator.hpp"
+#include "CoreLogger.hpp"
+#include "JobSystem.hpp"
+#include "ArtificialNeuralNetwork.hpp"
+#include "ArtificialNeuralNetworkBuilder.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "MapBuilder.hpp"
+#include "MapPrototype.hpp"
+#include "VehicleBuilder.hpp"
+#include "VehiclePrototype.hpp"
+#include "SimulatedWorld.hpp"
+#include "FitnessSystem.hpp"
+#include "RateScheduler.hpp"
+#include "ContinuousTimer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+
+CoreSweep::CoreSweep(const std::vector<std::string>& arguments) :
+	m_exitCode(1),
+	m_numberOfSamples(0),
+	m_seed((std::random_device())()),
+	m_maxNumberOfGenerations(60),
+	m_minNumberOfGenerations(5),
+	m_halvingRate(2.0),
+	m_repeatCrossoverPerIndividual(false),
+	m_decreaseMutationProbabilityOverGenerations(false),
+	m_dynamicsType(BOX2D_DYNAMICS),
+	m_deathOnEdgeContact(false),
+	m_physicsRate(600),
+	m_sensorRate(60),
+	m_controllerRate(60),
+	m_maxTime(600.0),
+	m_numberOfWorkers(JobSystem::GetDefaultNumberOfWorkers()),
+	m_mapPrototype(nullptr),
+	m_vehiclePrototype(nullptr),
+	m_artificialNeuralNetworkPrototype(nullptr)
+{
+	// Parameters which are not swept have the same default values as in simulation state
+	m_parameters[POPULATION_SIZE].m_values = { 30.0 };
+	m_parameters[CROSSOVER_TYPE].m_values = { double(UNIFORM_CROSSOVER) };
+	m_parameters[MUTATION_PROBABILITY].m_values = { 0.05 };
+	m_parameters[NUMBER_OF_PARENTS].m_values = { 2.0 };
+	m_parameters[REQUIRED_FITNESS_IMPROVEMENT].m_values = { 0.05 };
+	m_parameters[REQUIRED_FITNESS_IMPROVEMENT_RISE].m_values = { 3.0 };
+
+	if (!ParseArguments(arguments))
+	{
+		PrintUsage();
+		return;
+	}
+
+	if (!Load())
+		return;
+
+	CreateRuns();
+	Sweep();
+	if (WriteResults())
+		m_exitCode = 0;
+}
+
+CoreSweep::~CoreSweep()
+{
+	for (size_t i = 0; i < m_runs.size(); ++i)
+		ReleaseRun(i);
+	delete m_mapPrototype;
+	delete m_vehiclePrototype;
+	delete m_artificialNeuralNetworkPrototype;
+}
+
+bool CoreSweep::ParseArguments(const std::vector<std::string>& arguments)
+{
+	if (arguments.empty() || arguments[0] != "--sweep")
+		return false;
+
+	bool random = false;
+	for (size_t i = 1; i < arguments.size(); ++i)
+	{
+		const std::string& argument = arguments[i];
+		if (argument == "--death-on-edge-contact")
+		{
+			m_deathOnEdgeContact = true;
+			continue;
+		}
+		else if (argument == "--repeat-crossover-per-individual")
+		{
+			m_repeatCrossoverPerIndividual = true;
+			continue;
+		}
+		else if (argument == "--decrease-mutation-probability-over-generations")
+		{
+			m_decreaseMutationProbabilityOverGenerations = true;
+			continue;
+		}
+
+		// The rest of options have value
+		if (i + 1 >= arguments.size())
+		{
+			std::cerr << "Missing value of option " << argument << std::endl;
+			return false;
+		}
+
+		const std::string& value = arguments[++i];
+		bool success = true;
+		size_t parameterIndex = NUMBER_OF_PARAMETERS;
+		for (size_t j = 0; j < NUMBER_OF_PARAMETERS; ++j)
+		{
+			std::string option = std::string("--") + m_parameterStrings[j];
+			std::replace(option.begin(), option.end(), '_', '-');
+			if (argument == option)
+				parameterIndex = j;
+		}
+
+		if (parameterIndex != NUMBER_OF_PARAMETERS)
+		{
+			success = ParseParameter(parameterIndex, value);
+			random = random || m_parameters[parameterIndex].m_range;
+		}
+		else if (argument == "--map")
+			m_mapFilename = value;
+		else if (argument == "--vehicle")
+			m_vehicleFilename = value;
+		else if (argument == "--network")
+			m_networkFilename = value;
+		else if (argument == "--output")
+			m_outputFilename = value;
+		else if (argument == "--samples")
+			success = CoreEvaluator::ParseNumber(value, m_numberOfSamples) && m_numberOfSamples;
+		else if (argument == "--seed")
+		{
+			size_t seed = 0;
+			success = CoreEvaluator::ParseNumber(value, seed);
+			m_seed = unsigned(seed);
+		}
+		else if (argument == "--generations")
+			success = CoreEvaluator::ParseNumber(value, m_maxNumberOfGenerations) && m_maxNumberOfGenerations;
+		else if (argument == "--min-generations")
+			success = CoreEvaluator::ParseNumber(value, m_minNumberOfGenerations) && m_minNumberOfGenerations;
+		else if (argument == "--halving-rate")
+			success = CoreEvaluator::ParseNumber(value, m_halvingRate);
+		else if (argument == "--dynamics")
+		{
+			m_dynamicsType = NUMBER_OF_DYNAMICS_TYPES;
+			for (int dynamicsType = 0; dynamicsType < NUMBER_OF_DYNAMICS_TYPES; ++dynamicsType)
+			{
+				if (value == DynamicsTypeStrings[dynamicsType])
+					m_dynamicsType = dynamicsType;
+			}
+			success = m_dynamicsType != NUMBER_OF_DYNAMICS_TYPES;
+		}
+		else if (argument == "--physics-rate")
+			success = CoreEvaluator::ParseNumber(value, m_physicsRate) && m_physicsRate;
+		else if (argument == "--sensor-rate")
+			success = CoreEvaluator::ParseNumber(value, m_sensorRate);
+		else if (argument == "--controller-rate")
+			success = CoreEvaluator::ParseNumber(value, m_controllerRate);
+		else if (argument == "--max-time")
+			success = CoreEvaluator::ParseNumber(value, m_maxTime) && m_maxTime > 0.0;
+		else if (argument == "--workers")
+			success = CoreEvaluator::ParseNumber(value, m_numberOfWorkers);
+		else if (argument == "--window-size")
+			success = CoreEvaluator::ParseWindowSize(value, m_windowSize);
+		else
+		{
+			std::cerr << "Unknown option " << argument << std::endl;
+			return false;
+		}
+
+		if (!success)
+		{
+			std::cerr << "Incorrect value \"" << value << "\" of option " << argument << std::endl;
+			return false;
+		}
+	}
+
+	if (m_mapFilename.empty() || m_vehicleFilename.empty() || m_networkFilename.empty())
+	{
+		std::cerr << "Map, vehicle and network have to be specified" << std::endl;
+		return false;
+	}
+
+	if (random && !m_numberOfSamples)
+	{
+		std::cerr << "Number of samples has to be specified if any parameter is given as range" << std::endl;
+		return false;
+	}
+
+	if (!random)
+		m_numberOfSamples = 0;
+
+	return true;
+}
+
+bool CoreSweep::ParseParameter(size_t parameterIndex, const std::string& text)
+{
+	Parameter& parameter = m_parameters[parameterIndex];
+	parameter.m_values.clear();
+	parameter.m_range = text.find(':') != std::string::npos;
+	const char separator = parameter.m_range ? ':' : ',';
+	size_t begin = 0;
+	while (true)
+	{
+		const size_t end = text.find(separator, begin);
+		double value = 0.0;
+		if (!CoreEvaluator::ParseNumber(text.substr(begin, end - begin), value))
+			return false;
+
+		parameter.m_values.push_back(value);
+		if (end == std::string::npos)
+			break;
+		begin = end + 1;
+	}
+
+	if (parameter.m_range && (parameter.m_values.size() != 2 || parameter.m_values[0] > parameter.m_values[1]))
+		return false;
+
+	// Range is checked by its bounds, the same way as list of values
+	for (const auto& value : parameter.m_values)
+	{
+		switch (parameterIndex)
+		{
+			case POPULATION_SIZE:
+				if (value < 2.0 || value != std::floor(value))
+					return false;
+				break;
+			case CROSSOVER_TYPE:
+				if (value < 0.0 || value >= double(NUMBER_OF_CROSSOVER_TYPES) || value != std::floor(value))
+					return false;
+				break;
+			case MUTATION_PROBABILITY:
+				if (value < 0.0 || value > 1.0)
+					return false;
+				break;
+			case NUMBER_OF_PARENTS:
+				if (value < 1.0 || value > double(MaxNumberOfParents) || value != std::floor(value))
+					return false;
+				break;
+			case REQUIRED_FITNESS_IMPROVEMENT:
+				if (value < 0.0)
+					return false;
+				break;
+			case REQUIRED_FITNESS_IMPROVEMENT_RISE:
+				if (value <= 0.0)
+					return false;
+				break;
+		}
+	}
+
+	return true;
+}
+
+bool CoreSweep::Load()
+{
+	if (!CoreEvaluator::InitializeHeadless(m_windowSize, m_numberOfWorkers))
+		return false;
+
+	// Map properties and checkpoints are calculated once, every run adds the same map prototype to its worlds
+	MapBuilder mapBuilder;
+	if (!mapBuilder.Load(m_mapFilename))
+	{
+		std::cerr << "Cannot load map \"" << m_mapFilename << "\": " << mapBuilder.GetLastOperationStatus().second << std::endl;
+		return false;
+	}
+
+	m_mapPrototype = mapBuilder.Get();
+	m_mapPrototype->CalculateProperties();
+
+	VehicleBuilder vehicleBuilder;
+	if (!vehicleBuilder.Load(m_vehicleFilename))
+	{
+		std::cerr << "Cannot load vehicle \"" << m_vehicleFilename << "\": " << vehicleBuilder.GetLastOperationStatus().second << std::endl;
+		return false;
+	}
+
+	m_vehiclePrototype = vehicleBuilder.Get();
+	m_vehiclePrototype->SetCenter(mapBuilder.GetVehicleCenter());
+	m_vehiclePrototype->SetAngle(mapBuilder.GetVehicleAngle());
+	m_vehiclePrototype->Update();
+	if (m_mapPrototype->IsCollision(m_vehiclePrototype))
+	{
+		std::cerr << "Vehicle \"" << m_vehicleFilename << "\" is in a collision with edges of map \"" << m_mapFilename << "\"" << std::endl;
+		return false;
+	}
+
+	ArtificialNeuralNetworkBuilder artificialNeuralNetworkBuilder;
+	if (!artificialNeuralNetworkBuilder.Load(m_networkFilename))
+	{
+		std::cerr << "Cannot load network \"" << m_networkFilename << "\": " << artificialNeuralNetworkBuilder.GetLastOperationStatus().second << std::endl;
+		return false;
+	}
+
+	m_artificialNeuralNetworkPrototype = artificialNeuralNetworkBuilder.Get();
+	m_artificialNeuralNetworkPrototype->SetFromRawData(artificialNeuralNetworkBuilder.GetRawNeuronData());
+	if (m_artificialNeuralNetworkPrototype->GetNumberOfInputNeurons() != m_vehiclePrototype->GetNumberOfSensors())
+	{
+		std::cerr << "Number of network inputs does not match number of vehicle sensors" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void CoreSweep::CreateRuns()
+{
+	if (m_numberOfSamples)
+	{
+		// Random search, ranges of integer parameters are sampled as integers
+		std::mt19937 mersenneTwister(m_seed);
+		m_runs.resize(m_numberOfSamples);
+		for (auto& run : m_runs)
+		{
+			for (size_t i = 0; i < NUMBER_OF_PARAMETERS; ++i)
+			{
+				const auto& values = m_parameters[i].m_values;
+				if (!m_parameters[i].m_range)
+					run.m_parameters[i] = values[std::uniform_int_distribution<size_t>(0, values.size() - 1)(mersenneTwister)];
+				else if (i == POPULATION_SIZE || i == CROSSOVER_TYPE || i == NUMBER_OF_PARENTS)
+					run.m_parameters[i] = double(std::uniform_int_distribution<long long>(
+						(long long)values[0], (long long)values[1])(mersenneTwister));
+				else
+					run.m_parameters[i] = std::uniform_real_distribution<double>(values[0], values[1])(mersenneTwister);
+			}
+		}
+	}
+	else
+	{
+		// Grid search, every combination of values is a run
+		size_t numberOfRuns = 1;
+		for (const auto& parameter : m_parameters)
+			numberOfRuns *= parameter.m_values.size();
+
+		m_runs.resize(numberOfRuns);
+		for (size_t index = 0; index < numberOfRuns; ++index)
+		{
+			size_t remainder = index;
+			for (size_t i = NUMBER_OF_PARAMETERS; i-- > 0;)
+			{
+				const auto& values = m_parameters[i].m_values;
+				m_runs[index].m_parameters[i] = values[remainder % values.size()];
+				remainder /= values.size();
+			}
+		}
+	}
+
+	// Genetic algorithm requires more individuals than parents
+	for (auto& run : m_runs)
+	{
+		if (run.m_parameters[POPULATION_SIZE] <= run.m_parameters[NUMBER_OF_PARENTS])
+			run.m_status = STATUS_INVALID;
+	}
+
+	CoreLogger::PrintMessage("Sweep created " + std::to_string(m_runs.size()) + (m_numberOfSamples ? " random" : " grid") +
+		" configurations, seed " + std::to_string(m_seed));
+}
+
+void CoreSweep::Sweep()
+{
+	std::vector<size_t> activeRuns;
+	for (size_t i = 0; i < m_runs.size(); ++i)
+	{
+		if (m_runs[i].m_status != STATUS_INVALID)
+		{
+			InitializeRun(i);
+			activeRuns.push_back(i);
+		}
+	}
+
+	// Every rung trains surviving runs in parallel, then only the best fraction of them is kept
+	const bool halving = m_halvingRate > 1.0;
+	size_t numberOfGenerations = halving ? std::min(m_minNumberOfGenerations, m_maxNumberOfGenerations) : m_maxNumberOfGenerations;
+	while (!activeRuns.empty())
+	{
+		JobSystem::GetInstance().ParallelFor(0, activeRuns.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				TrainRun(activeRuns[i], numberOfGenerations);
+		});
+
+		std::sort(activeRuns.begin(), activeRuns.end(), [this](size_t first, size_t second) { return IsBetter(first, second); });
+		CoreLogger::PrintMessage("Sweep finished " + std::to_string(numberOfGenerations) + " generations of " + std::to_string(activeRuns.size()) +
+			" runs, highest fitness ratio " + std::to_string(m_runs[activeRuns.front()].m_highestFitnessOverallRatio));
+
+		if (numberOfGenerations >= m_maxNumberOfGenerations)
+		{
+			for (const auto& index : activeRuns)
+				ReleaseRun(index);
+			break;
+		}
+
+		const size_t numberOfKeptRuns = std::max<size_t>(1, size_t(std::ceil(double(activeRuns.size()) / m_halvingRate)));
+		for (size_t i = numberOfKeptRuns; i < activeRuns.size(); ++i)
+		{
+			m_runs[activeRuns[i]].m_status = STATUS_TERMINATED;
+			ReleaseRun(activeRuns[i]);
+		}
+		activeRuns.resize(numberOfKeptRuns);
+
+		const size_t nextNumberOfGenerations = size_t(std::ceil(double(numberOfGenerations) * m_halvingRate));
+		numberOfGenerations = std::min(std::max(nextNumberOfGenerations, numberOfGenerations + 1), m_maxNumberOfGenerations);
+	}
+
+	// Runs which were trained longer are ranked higher than runs terminated before them
+	std::vector<size_t> rankedRuns;
+	for (size_t i = 0; i < m_runs.size(); ++i)
+	{
+		if (m_runs[i].m_status != STATUS_INVALID)
+			rankedRuns.push_back(i);
+	}
+
+	std::stable_sort(rankedRuns.begin(), rankedRuns.end(), [this](size_t first, size_t second) {
+		if (m_runs[first].m_numberOfGenerations != m_runs[second].m_numberOfGenerations)
+			return m_runs[first].m_numberOfGenerations > m_runs[second].m_numberOfGenerations;
+		return IsBetter(first, second);
+	});
+
+	for (size_t i = 0; i < rankedRuns.size(); ++i)
+		m_runs[rankedRuns[i]].m_rank = i + 1;
+}
+
+void CoreSweep::InitializeRun(size_t index)
+{
+	Run& run = m_runs[index];
+	const size_t population = size_t(run.m_parameters[POPULATION_SIZE]);
+	run.m_fitnessSystem = new FitnessSystem(population, m_mapPrototype->GetNumberOfCheckpoints(), run.m_parameters[REQUIRED_FITNESS_IMPROVEMENT]);
+
+	// Every run gets its own seed derived from sweep seed so that the whole sweep can be reproduced
+	std::seed_seq seedSequence = { m_seed, unsigned(index) };
+	std::mt19937::result_type seed = 0;
+	seedSequence.generate(&seed, &seed + 1);
+	run.m_geneticAlgorithm = new GeneticAlgorithmNeuron(
+		m_maxNumberOfGenerations,
+		m_artificialNeuralNetworkPrototype->GetNumberOfWeights(),
+		population,
+		int(run.m_parameters[CROSSOVER_TYPE]),
+		m_repeatCrossoverPerIndividual,
+		run.m_parameters[MUTATION_PROBABILITY],
+		m_decreaseMutationProbabilityOverGenerations,
+		size_t(run.m_parameters[NUMBER_OF_PARENTS]),
+		1000,
+		std::pair(-ArtificialNeuralNetworkBuilder::GetMaxNeuronValue(), ArtificialNeuralNetworkBuilder::GetMaxNeuronValue()),
+		seed
+	);
+
+	// First individual is the loaded network, the same as in simulation state
+	run.m_artificialNeuralNetworks.resize(population, nullptr);
+	for (auto& artificialNeuralNetwork : run.m_artificialNeuralNetworks)
+		artificialNeuralNetwork = ArtificialNeuralNetworkBuilder::Copy(m_artificialNeuralNetworkPrototype);
+	run.m_artificialNeuralNetworks[0]->GetRawData(run.m_geneticAlgorithm->GetIndividualGenes(0));
+	for (size_t i = 1; i < population; ++i)
+		run.m_artificialNeuralNetworks[i]->SetFromRawData(run.m_geneticAlgorithm->GetIndividualGenes(i));
+}
+
+void CoreSweep::TrainRun(size_t index, size_t numberOfGenerations)
+{
+	Run& run = m_runs[index];
+	const size_t population = run.m_artificialNeuralNetworks.size();
+	RateScheduler rateScheduler(m_physicsRate, m_sensorRate, m_controllerRate);
+	ContinuousTimer requiredFitnessImprovementRiseTimer(0.0, run.m_parameters[REQUIRED_FITNESS_IMPROVEMENT_RISE]);
+	const float timeStep = float(rateScheduler.GetPhysicsTimeStep());
+	const size_t stepsPerChunk = std::max<size_t>(1, rateScheduler.GetPhysicsRate() / 60);
+	const size_t maxNumberOfSteps = size_t(m_maxTime / rateScheduler.GetPhysicsTimeStep());
+	while (run.m_numberOfGenerations < numberOfGenerations)
+	{
+		// Every generation has its own world which is set up the same way as in simulation state
+		SimulatedWorld simulatedWorld(m_dynamicsType);
+		simulatedWorld.AddMap(m_mapPrototype);
+		if (m_deathOnEdgeContact)
+			simulatedWorld.EnableDeathOnEdgeContact();
+		simulatedWorld.AddCheckpointFunction(run.m_fitnessSystem->GetCheckpointFunction());
+		SimulatedVehicles simulatedVehicles(population, nullptr);
+		for (auto& vehicle : simulatedVehicles)
+			vehicle = simulatedWorld.AddVehicle(m_vehiclePrototype);
+		rateScheduler.Reset();
+		requiredFitnessImprovementRiseTimer.Reset();
+
+		// Runs are trained in parallel, so controllers of one run are updated serially
+		bool activity = true;
+		while (activity)
+		{
+			for (size_t step = 0; step < stepsPerChunk; ++step)
+			{
+				if (rateScheduler.IsSensorTick())
+					simulatedWorld.UpdateSensors(rateScheduler.GetSensorTimeStep());
+
+				if (rateScheduler.IsControllerTick())
+				{
+					for (size_t i = 0; i < population; ++i)
+					{
+						if (simulatedVehicles[i]->IsActive())
+							simulatedVehicles[i]->ProcessInput(run.m_artificialNeuralNetworks[i]->Update(simulatedVehicles[i]->ProcessOutput()));
+					}
+				}
+
+				for (const auto& vehicle : simulatedVehicles)
+					vehicle->Update(timeStep);
+
+				simulatedWorld.Step(timeStep);
+				rateScheduler.Step();
+			}
+
+			// Generation which runs out of time is finished with vehicles that are still driving
+			if (rateScheduler.GetStep() >= maxNumberOfSteps)
+			{
+				for (const auto& vehicle : simulatedVehicles)
+					vehicle->SetInactive();
+			}
+
+			activity = false;
+			for (const auto& vehicle : simulatedVehicles)
+			{
+				if (vehicle->IsActive())
+				{
+					activity = true;
+					break;
+				}
+			}
+
+			if (activity)
+			{
+				const double simulatedTime = double(stepsPerChunk) * rateScheduler.GetPhysicsTimeStep();
+				run.m_fitnessSystem->MarkLeader(simulatedVehicles);
+				if (requiredFitnessImprovementRiseTimer.Update(simulatedTime))
+					run.m_fitnessSystem->Punish(simulatedVehicles);
+				run.m_fitnessSystem->UpdateTimers(simulatedVehicles, simulatedTime);
+			}
+		}
+
+		// Keep statistics of finished generation
+		run.m_fitnessSystem->Iterate(simulatedVehicles);
+		run.m_highestFitnessOverallRatio = run.m_fitnessSystem->GetHighestFitnessOverallRatio();
+		run.m_meanFitnessRatio = run.m_fitnessSystem->ToFitnessRatio(run.m_fitnessSystem->GetMeanFitnessVector().back());
+		run.m_bestTimeOverall = run.m_fitnessSystem->GetBestTimeOverall();
+		run.m_numberOfSucceededIndividuals = run.m_fitnessSystem->GetNumberOfSucceededIndividualsVector().back();
+		++run.m_numberOfGenerations;
+
+		// Generate new generation
+		if (!run.m_geneticAlgorithm->Iterate(run.m_fitnessSystem->GetFitnessVector()))
+			break;
+
+		for (size_t i = 0; i < population; ++i)
+			run.m_artificialNeuralNetworks[i]->SetFromRawData(run.m_geneticAlgorithm->GetIndividualGenes(i));
+		run.m_fitnessSystem->Reset();
+	}
+}
+
+void CoreSweep::ReleaseRun(size_t index)
+{
+	Run& run = m_runs[index];
+	delete run.m_geneticAlgorithm;
+	run.m_geneticAlgorithm = nullptr;
+	delete run.m_fitnessSystem;
+	run.m_fitnessSystem = nullptr;
+	for (const auto& artificialNeuralNetwork : run.m_artificialNeuralNetworks)
+		delete artificialNeuralNetwork;
+	run.m_artificialNeuralNetworks.clear();
+}
+
+bool CoreSweep::IsBetter(size_t first, size_t second) const
+{
+	// Higher fitness is better, then shorter time of the best vehicle, then higher mean fitness
+	const Run& firstRun = m_runs[first];
+	const Run& secondRun = m_runs[second];
+	if (firstRun.m_highestFitnessOverallRatio != secondRun.m_highestFitnessOverallRatio)
+		return firstRun.m_highestFitnessOverallRatio > secondRun.m_highestFitnessOverallRatio;
+	if (firstRun.m_bestTimeOverall != secondRun.m_bestTimeOverall)
+		return firstRun.m_bestTimeOverall < secondRun.m_bestTimeOverall;
+	return firstRun.m_meanFitnessRatio > secondRun.m_meanFitnessRatio;
+}
+
+bool CoreSweep::WriteResults() const
+{
+	if (m_outputFilename.empty())
+	{
+		WriteCsv(std::cout);
+		std::cout.flush();
+		return bool(std::cout);
+	}
+
+	std::ofstream output(m_outputFilename);
+	if (!output.is_open())
+	{
+		std::cerr << "Cannot open output file \"" << m_outputFilename << "\"" << std::endl;
+		return false;
+	}
+
+	WriteCsv(output);
+	output.close();
+	if (output.fail())
+	{
+		std::cerr << "Cannot write output file \"" << m_outputFilename << "\"" << std::endl;
+		return false;
+	}
+
+	CoreLogger::PrintSuccess("Results of " + std::to_string(m_runs.size()) + " runs written to " + m_outputFilename);
+	return true;
+}
+
+void CoreSweep::WriteCsv(std::ostream& output) const
+{
+	output.precision(std::numeric_limits<double>::max_digits10);
+	output << "run,";
+	for (const auto& parameterString : m_parameterStrings)
+		output << parameterString << ',';
+	output << "generations,status,highest_fitness_ratio,mean_fitness_ratio,best_time,succeeded_individuals,rank\n";
+	for (size_t i = 0; i < m_runs.size(); ++i)
+	{
+		const Run& run = m_runs[i];
+		output << i << ',';
+		for (const auto& parameter : run.m_parameters)
+			output << parameter << ',';
+		output << run.m_numberOfGenerations << ','
+			<< m_statusStrings[run.m_status] << ',';
+		if (run.m_status == STATUS_INVALID)
+		{
+			output << ",,,,\n";
+			continue;
+		}
+
+		output << run.m_highestFitnessOverallRatio << ','
+			<< run.m_meanFitnessRatio << ','
+			<< run.m_bestTimeOverall << ','
+			<< run.m_numberOfSucceededIndividuals << ','
+			<< run.m_rank << '\n';
+	}
+}
+
+void CoreSweep::PrintUsage()
+{
+	std::cerr <<
+		"Usage: --sweep --map <file> --vehicle <file> --network <file> [options]\n"
+		"Genetic algorithm is trained with every configuration, values are given as list \"a,b,c\" or as range \"min:max\"\n"
+		"Lists form a grid, if any parameter is given as range then configurations are sampled randomly\n"
+		"Options:\n"
+		"  --population <values>                              Population size, 30 by default\n"
+		"  --crossover-type <values>                          0 uniform, 1 mean, 2 one point, 3 two point, 0 by default\n"
+		"  --mutation-probability <values>                    Mutation probability, 0.05 by default\n"
+		"  --number-of-parents <values>                       Number of parents, at most 256, 2 by default\n"
+		"  --required-fitness-improvement <values>            Required fitness improvement, 0.05 by default\n"
+		"  --required-fitness-improvement-rise <values>       Time between fitness improvement checks, 3 seconds by default\n"
+		"  --repeat-crossover-per-individual                  Crossover is repeated for every individual\n"
+		"  --decrease-mutation-probability-over-generations   Mutation probability decreases over generations\n"
+		"  --samples <number>                                 Number of random configurations, required if any range is given\n"
+		"  --seed <number>                                    Seed of configurations and of every run, random by default\n"
+		"  --generations <number>                             Max number of generations of one run, 60 by default\n"
+		"  --min-generations <number>                         Number of generations of the first halving rung, 5 by default\n"
+		"  --halving-rate <rate>                              Fraction 1/rate of runs survives every rung, 2 by default, 1 disables halving\n"
+		"  --output <file>                                    Results CSV file, results are written to the standard output if not specified\n"
+		"  --dynamics Box2D|Kinematic                         Vehicle dynamics, Box2D by default\n"
+		"  --death-on-edge-contact                            Vehicle crashes when it touches an edge\n"
+		"  --physics-rate <hertz>                             Physics rate, 600 by default\n"
+		"  --sensor-rate <hertz>                              Sensor rate, 60 by default\n"
+		"  --controller-rate <hertz>                          Controller rate, 60 by default\n"
+		"  --max-time <s>                                     Max simulated time of one generation, 600 seconds by default\n"
+		"  --window-size <width>x<height>                     Window size which map and vehicle were created with, desktop based by default\n"
+		"  --workers <number>                                 Number of worker threads, number of hardware threads minus one by default\n";
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "Neural.hpp"
+#include "Genetic.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class MapPrototype;
+class VehiclePrototype;
+class FitnessSystem;
+class GeneticAlgorithmNeuron;
+
+// Headless hyperparameter sweep of genetic algorithm on single map, vehicle and artificial neural network
+// Configurations are taken from grid of values or sampled randomly from ranges and trained concurrently
+// Map and vehicle are loaded once and shared by every run, poor runs are terminated early by successive halving
+class CoreSweep final
+{
+public:
+
+	explicit CoreSweep(const std::vector<std::string>& arguments);
+
+	~CoreSweep();
+
+	// Returns process exit code, zero if sweep was finished and results were written
+	inline int GetExitCode() const
+	{
+		return m_exitCode;
+	}
+
+private:
+
+	// Parses command line arguments, returns false if they are incorrect
+	bool ParseArguments(const std::vector<std::string>& arguments);
+
+	// Parses values of swept parameter given as list "a,b,c" or as range "min:max"
+	bool ParseParameter(size_t parameterIndex, const std::string& text);
+
+	// Initializes builders and loads map, vehicle and artificial neural network
+	bool Load();
+
+	// Creates runs from grid of values or from random samples if any parameter is given as range
+	void CreateRuns();
+
+	// Trains runs and terminates the worst of them after every rung of successive halving
+	void Sweep();
+
+	// Creates genetic algorithm, fitness system and artificial neural networks of run
+	void InitializeRun(size_t index);
+
+	// Trains run until it finishes given number of generations
+	void TrainRun(size_t index, size_t numberOfGenerations);
+
+	// Releases genetic algorithm, fitness system and artificial neural networks of run
+	void ReleaseRun(size_t index);
+
+	// Returns true if the first run is better than the second one
+	bool IsBetter(size_t first, size_t second) const;
+
+	// Writes results to the output file or to the standard output
+	bool WriteResults() const;
+
+	// Writes results as CSV
+	void WriteCsv(std::ostream& output) const;
+
+	// Prints command line usage to the standard error
+	static void PrintUsage();
+
+	// Swept parameters
+	enum
+	{
+		POPULATION_SIZE,
+		CROSSOVER_TYPE,
+		MUTATION_PROBABILITY,
+		NUMBER_OF_PARENTS,
+		REQUIRED_FITNESS_IMPROVEMENT,
+		REQUIRED_FITNESS_IMPROVEMENT_RISE,
+		NUMBER_OF_PARAMETERS
+	};
+
+	// Run statuses
+	enum
+	{
+		STATUS_FINISHED,
+		STATUS_TERMINATED,
+		STATUS_INVALID,
+		STATUSES_COUNT
+	};
+
+	// Values of swept parameter, range contains minimum and maximum
+	struct Parameter
+	{
+		std::vector<double> m_values;
+		bool m_range = false;
+	};
+
+	// Single configuration of genetic algorithm with its training state and statistics
+	struct Run
+	{
+		double m_parameters[NUMBER_OF_PARAMETERS] = {};
+		size_t m_status = STATUS_FINISHED;
+		size_t m_numberOfGenerations = 0; // Number of finished generations
+		GeneticAlgorithmNeuron* m_geneticAlgorithm = nullptr;
+		FitnessSystem* m_fitnessSystem = nullptr;
+		std::vector<ArtificialNeuralNetwork*> m_artificialNeuralNetworks;
+		Fitness m_highestFitnessOverallRatio = 0.0;
+		Fitness m_meanFitnessRatio = 0.0; // Mean fitness ratio of the last generation
+		double m_bestTimeOverall = 0.0;
+		size_t m_numberOfSucceededIndividuals = 0; // Number of succeeded individuals of the last generation
+		size_t m_rank = 0; // Zero if run is invalid
+	};
+
+	int m_exitCode;
+
+	// Input files
+	std::string m_mapFilename;
+	std::string m_vehicleFilename;
+	std::string m_networkFilename;
+	std::string m_outputFilename; // Results are written to the standard output if empty
+
+	// Sweep parameters
+	Parameter m_parameters[NUMBER_OF_PARAMETERS];
+	size_t m_numberOfSamples; // Number of random samples, used only if any parameter is given as range
+	unsigned m_seed;
+	size_t m_maxNumberOfGenerations;
+	size_t m_minNumberOfGenerations; // Budget of the first rung of successive halving
+	double m_halvingRate; // Successive halving is disabled if rate is not greater than one
+	bool m_repeatCrossoverPerIndividual;
+	bool m_decreaseMutationProbabilityOverGenerations;
+
+	// Simulation parameters
+	int m_dynamicsType;
+	bool m_deathOnEdgeContact;
+	size_t m_physicsRate;
+	size_t m_sensorRate;
+	size_t m_controllerRate;
+	double m_maxTime; // Max simulated time of one generation
+	sf::Vector2f m_windowSize; // Calculated from desktop resolution if not specified
+	size_t m_numberOfWorkers;
+
+	// Objects shared read-only by all runs
+	MapPrototype* m_mapPrototype;
+	VehiclePrototype* m_vehiclePrototype;
+	ArtificialNeuralNetwork* m_artificialNeuralNetworkPrototype;
+	std::vector<Run> m_runs;
+
+	inline static const char* const m_parameterStrings[NUMBER_OF_PARAMETERS] = {
+		"population",
+		"crossover_type",
+		"mutation_probability",
+		"number_of_parents",
+		"required_fitness_improvement",
+		"required_fitness_improvement_rise"
+	};
+
+	inline static const char* const m_statusStrings[STATUSES_COUNT] = {
+		"finished",
+		"terminated",
+		"invalid"
+	};
+};
@@ -2,28 +2,20 @@
 #include "ColorContext.hpp"
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
-#include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Window/Event.hpp>
-#include <SFML/Graphics/Shader.hpp>
 #include <array>
 #include <random>
 
 class CoreWindow final
 {
 	inline static sf::RenderWindow m_renderWindow;
-	inline static sf::RenderTexture m_renderTextureBackground;
-	inline static sf::RenderTexture m_renderTextureForeground;
-	inline static sf::Sprite m_backgroundSprite;
-	inline static sf::Sprite m_foregroundSprite;
-	inline static sf::View m_view, m_defaultView;
+	inline static sf::RenderTarget* m_renderTarget = &m_renderWindow; // Target of background drawing
+	inline static sf::View m_view, m_defaultView, m_windowView;
 	inline static sf::Clock m_clock;
 	inline static sf::Event m_event;
 	inline static bool m_open = false;
 	inline static double m_elapsedTime = 0.0;
 	inline static sf::Vector2f m_windowSize;
-	inline static sf::Shader m_invertColorShader;
-	inline static size_t m_currentRenderColor;
-	inline static std::array<sf::Color, 2> m_renderWindowColors;
 
 	CoreWindow();
 
@@ -46,6 +38,25 @@ public:
 		GetInstance();
 	}
 
+	// Sets window size and view without creating window, used by headless evaluation
+	// Builders validate prototypes against window size so it should be the same as the size of window that created them
+	inline static void InitializeHeadless(sf::Vector2f windowSize)
+	{
+		m_windowSize = windowSize;
+		m_view.setSize(windowSize);
+		m_view.setCenter(windowSize / 2.f);
+		m_defaultView = m_view;
+	}
+
+	// Returns window size calculated from desktop resolution
+	inline static sf::Vector2f CalculateWindowSize()
+	{
+		const float widthRatio = 0.8333f;
+		const float screenRatio = 0.5625f;
+		const float screenWidth = sf::VideoMode::getDesktopMode().width * widthRatio;
+		return sf::Vector2f(screenWidth, screenWidth * screenRatio);
+	}
+
 	// Returns true if window is open, false otherwise
 	inline static bool IsOpen()
 	{
@@ -66,26 +77,15 @@ public:
 		m_open = false;
 	}
 
-	// Clears window drawing area with background color
+	// Clears window drawing area with background color of current palette
 	inline static void Clear()
 	{
-		m_renderTextureBackground.clear(ColorContext::ClearBackground);
-		m_renderTextureForeground.clear(ColorContext::ClearBackground);
+		m_renderWindow.clear(ColorContext::Background);
 	}
 
 	// Displays on window what has been rendered so far
 	inline static void Display()
 	{
-		m_renderTextureBackground.display();
-		m_renderTextureForeground.display();
-
-		m_renderWindow.clear(m_renderWindowColors[m_currentRenderColor]);
-
-		m_backgroundSprite.setTexture(m_renderTextureBackground.getTexture());
-		m_foregroundSprite.setTexture(m_renderTextureForeground.getTexture());
-		m_renderWindow.draw(m_backgroundSprite, &m_invertColorShader);
-		m_renderWindow.draw(m_foregroundSprite, &m_invertColorShader);
-
 		m_renderWindow.display();
 	}
 
@@ -101,29 +101,54 @@ public:
 		return m_event;
 	}
 
-	// Sets background render texture view
+	// Sets background view
 	inline static void SetView(sf::View view)
 	{
 		m_view = view;
-		m_renderTextureBackground.setView(view);
+		m_renderWindow.setView(view);
 	}
 
-	// Draw drawable on the background texture
+	// Draw drawable on the background
 	inline static void Draw(const sf::Drawable& drawable)
 	{
-		m_renderTextureBackground.draw(drawable);
+		m_renderTarget->draw(drawable);
 	}
 
-	// Draw vertices on the background texture
+	// Draw vertices on the background
 	inline static void Draw(const sf::Vertex* vertices, size_t vertexCount, sf::PrimitiveType type)
 	{
-		m_renderTextureBackground.draw(vertices, vertexCount, type);
+		m_renderTarget->draw(vertices, vertexCount, type);
 	}
 
-	// Draw drawable on the foreground texture
+	// Redirects background drawing to off-screen texture, given view is used as current view until EndOffscreen is called
+	inline static void BeginOffscreen(sf::RenderTexture& renderTexture, const sf::View& view)
+	{
+		m_windowView = m_view;
+		m_view = view;
+		renderTexture.setView(view);
+		m_renderTarget = &renderTexture;
+	}
+
+	// Redirects background drawing back to the window
+	inline static void EndOffscreen()
+	{
+		m_view = m_windowView;
+		m_renderTarget = &m_renderWindow;
+	}
+
+	// Draw drawable on the foreground, foreground uses default view
 	inline static void DrawForeground(const sf::Drawable& drawable)
 	{
-		m_renderTextureForeground.draw(drawable);
+		DrawForeground(drawable, sf::RenderStates::Default);
+	}
+
+	// Draw drawable with render states on the foreground, foreground uses default view
+	inline static void DrawForeground(const sf::Drawable& drawable, const sf::RenderStates& states)
+	{
+		const sf::View view = m_renderWindow.getView();
+		m_renderWindow.setView(m_defaultView);
+		m_renderWindow.draw(drawable, states);
+		m_renderWindow.setView(view);
 	}
 
 	// Returns window size
@@ -154,7 +179,7 @@ public:
 	inline static void SetViewCenter(sf::Vector2f center)
 	{
 		m_view.setCenter(center);
-		m_renderTextureBackground.setView(m_view);
+		m_renderWindow.setView(m_view);
 	}
 
 	// Returns current window view
@@ -173,12 +198,11 @@ public:
 	// Sets view zoom
 	inline static void SetViewZoom(float zoom)
 	{
-		m_renderTextureBackground.setView(m_defaultView);
 		auto center = m_view.getCenter();
 		m_view = m_defaultView;
 		m_view.setCenter(center);
 		m_view.zoom(zoom);
-		m_renderTextureBackground.setView(m_view);
+		m_renderWindow.setView(m_view);
 	}
 
 	// Returns elapsed time since last clock reset
@@ -198,7 +222,7 @@ public:
 	inline static void Reset()
 	{
 		m_view = m_defaultView;
-		m_renderTextureBackground.setView(m_defaultView);
+		m_renderWindow.setView(m_defaultView);
 	}
 
 	// Returns mersenne twister
@@ -209,16 +233,16 @@ public:
 	}
 
 	// Switches display color from dark mode to light mode depending on current mode
+	// Palette is switched once, frames are drawn with colors of current palette
 	inline static void SwitchDisplayColorMode()
 	{
-		m_currentRenderColor = !m_currentRenderColor;
-		m_invertColorShader.setUniform("invert", static_cast<bool>(m_currentRenderColor));
+		ColorContext::SetPalette((ColorContext::CurrentPalette + 1) % ColorContext::NUMBER_OF_PALETTES);
 	}
 
-	// Returns number of display color modes
+	// Returns string representation of current display color mode
 	inline static std::string GetDisplayColorModeString()
 	{
-		static std::array<std::string, m_renderWindowColors.size()> strings = { "Dark mode", "Light mode" };
-		return strings[m_currentRenderColor];
+		static std::array<std::string, ColorContext::NUMBER_OF_PALETTES> strings = { "Dark mode", "Light mode" };
+		return strings[ColorContext::CurrentPalette];
 	}
 };
@@ -1,29 +1,58 @@
 import matplotlib.pyplot as plt
 import matplotlib.ticker as mtick
 import numpy as np
-import glob, os
-import csv
+import glob, os, sys, time
 
 columnColors = ['cornflowerblue', 'lightsteelblue', 'lightcoral', 'darkolivegreen', 'yellowgreen']
+numberOfColumns = 5
+streamedColumns = ['highest_fitness_ratio', 'mean_fitness_ratio', 'succeeded_individuals_ratio', 'best_time', 'mean_time']
 
-os.chdir(".")
-for file in glob.glob("*.csv"):
-	columns = [[], [], [], [], []]
-	with open(file,'r') as csvfile:
-		plots = csv.reader(csvfile, delimiter = ';')
-
-		for row in plots:
-			if not row:
+# Reads complete rows appended since offset, row which is still being written is left for the next read
+def readRows(file, offset):
+	rows = []
+	with open(file, 'r') as csvfile:
+		csvfile.seek(offset)
+		for line in iter(csvfile.readline, ''):
+			if not line.endswith('\n'):
 				break
-			numberOfColumns = 5
+			offset = csvfile.tell()
+			rows.append(line.rstrip('\n').split(';'))
+	return rows, offset
+
+# Appends new rows to columns, saved statistics end with empty row, streamed statistics start with header row
+def readFile(file, state):
+	rows, state['offset'] = readRows(file, state['offset'])
+	for row in rows:
+		if state['finished']:
+			break
+		if row == ['']:
+			state['finished'] = True
+			break
+		if state['header'] is None and row[0] == 'generation':
+			state['header'] = row
+			continue
+		if state['header'] is None:
+			for i in range(numberOfColumns):
+				state['columns'][i].append(float(row[i]))
+		else:
+			values = dict(zip(state['header'], row))
 			for i in range(numberOfColumns):
-				columns[i].append(float(row[i]))
+				state['columns'][i].append(float(values[streamedColumns[i]]))
+
+# Saves chart of file, streamed statistics hold times in seconds so they are converted to ratios of the worst time
+def plot(file, state):
+	columns = [list(column) for column in state['columns']]
+	if state['header'] is not None:
+		for i in (3, 4):
+			worstTime = max(columns[i], default = 0.0)
+			if worstTime > 0.0:
+				columns[i] = [value / worstTime * 100.0 for value in columns[i]]
 
 	figure = plt.figure()
 	ax = figure.add_subplot(1, 1, 1)
 	ax.yaxis.set_major_formatter(mtick.PercentFormatter())
 	ax.xaxis.set_major_formatter(mtick.ScalarFormatter())
-	numberOfGenerations = len(columns[i])
+	numberOfGenerations = len(columns[0])
 	generations = np.arange(numberOfGenerations)
 	ax.plot(generations, columns[0], color = columnColors[0], label='Highest fitness')
 	ax.plot(generations, columns[1], color = columnColors[1], label='Mean fitness')
@@ -33,4 +62,20 @@ for file in glob.glob("*.csv"):
 	plt.legend(loc="best")
 	plt.xlabel('Generation')
 	plt.savefig(file[:-4] + '.png')
-	#plt.show()
\ No newline at end of file
+	plt.close(figure)
+	#plt.show()
+
+# With --follow files are read incrementally and charts are updated while the simulation is running
+os.chdir(".")
+follow = '--follow' in sys.argv
+states = {}
+while True:
+	for file in glob.glob("*.csv"):
+		state = states.setdefault(file, { 'offset': 0, 'header': None, 'finished': False, 'columns': [[] for i in range(numberOfColumns)] })
+		offset = state['offset']
+		readFile(file, state)
+		if state['offset'] != offset and state['columns'][0]:
+			plot(file, state)
+	if not follow:
+		break
+	time.sleep(5)
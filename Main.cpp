@@ -1,18 +1,39 @@
 #include "CoreEngine.hpp"
+#include "CoreEvaluator.hpp"
+#include "CoreSweep.hpp"
 #include "TestEngine.hpp"
 #include "CoreLogger.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+    int exitCode = 0;
     try
     {
-        TestEngine testEngine;
-        CoreEngine coreEngine;
+        if (argc > 1 && std::string(argv[1]) == "--sweep")
+        {
+            // Hyperparameter sweep is headless too
+            CoreSweep coreSweep(std::vector<std::string>(argv + 1, argv + argc));
+            exitCode = coreSweep.GetExitCode();
+        }
+        else if (argc > 1 && std::string(argv[1]) == "--evaluate")
+        {
+            // Headless evaluation is started only explicitly, other arguments start window
+            CoreEvaluator coreEvaluator(std::vector<std::string>(argv + 1, argv + argc));
+            exitCode = coreEvaluator.GetExitCode();
+        }
+        else
+        {
+            TestEngine testEngine;
+            CoreEngine coreEngine;
+        }
     }
     catch (...)
     {
         CoreLogger::PrintError("Caught exception!");
+        exitCode = 1;
     }
 
-    return 0;
+    CoreLogger::Terminate();
+
+    return exitCode;
 }
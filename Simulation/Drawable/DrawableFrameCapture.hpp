@@ -0,0 +1,191 @@
+#pragma once
+#include "DrawableSnapshot.hpp"
+#include "MapPrototype.hpp"
+#include "FrameWriter.hpp"
+#include "CoreWindow.hpp"
+#include <SFML/OpenGL.hpp>
+#include <array>
+#include <iomanip>
+#include <sstream>
+
+// Renders snapshots of selected generations off-screen at fixed resolution for reviewing runs after the fact
+// View follows the leader, frames are handed over to frame writer so that neither render nor simulation thread waits for disk
+// View keeps aspect ratio of the window and is letterboxed, so frames are not stretched
+// Pixels are read straight into reused buffers of frame writer, capturing does not allocate and frames are not copied
+class DrawableFrameCapture final
+{
+public:
+
+	// Capture modes
+	enum
+	{
+		CAPTURE_OFF,
+		PNG_EVERY_GENERATION,
+		PNG_EVERY_10TH_GENERATION,
+		RAW_EVERY_GENERATION,
+		RAW_EVERY_10TH_GENERATION,
+		CAPTURE_MODES_COUNT
+	};
+
+	DrawableFrameCapture() :
+		m_mode(CAPTURE_OFF),
+		m_created(false),
+		m_generation(0),
+		m_frameIndex(0)
+	{
+	}
+
+	~DrawableFrameCapture()
+	{
+		m_frameWriter.Stop();
+	}
+
+	// Sets next capture mode, writer thread runs only when capture is on
+	// Turning capture off does not wait for frames left in the queue, they are written in the background
+	inline void ChangeMode()
+	{
+		++m_mode;
+		if (m_mode >= CAPTURE_MODES_COUNT)
+			m_mode = CAPTURE_OFF;
+
+		if (m_mode == CAPTURE_OFF)
+			m_frameWriter.Stop();
+		else
+			m_frameWriter.Start();
+		m_frameIndex = 0;
+	}
+
+	// Turns capture off, frames left in the queue are written in the background
+	inline void Reset()
+	{
+		m_mode = CAPTURE_OFF;
+		m_frameWriter.Stop();
+		m_frameIndex = 0;
+	}
+
+	// Returns capture mode and number of written and dropped frames as a string
+	inline std::string ToString()
+	{
+		static const std::array<std::string, CAPTURE_MODES_COUNT> strings = {
+			"Off",
+			"PNG, every generation",
+			"PNG, every 10th generation",
+			"Raw, every generation",
+			"Raw, every 10th generation"
+		};
+
+		if (m_mode == CAPTURE_OFF)
+			return strings[m_mode];
+		return strings[m_mode] + " (" + std::to_string(m_frameWriter.GetNumberOfWrittenFrames()) + " written, " + std::to_string(m_frameWriter.GetNumberOfDroppedFrames()) + " dropped)";
+	}
+
+	// Returns true if frames of given generation are captured
+	inline bool IsGenerationSelected(size_t generation) const
+	{
+		switch (m_mode)
+		{
+			case PNG_EVERY_GENERATION:
+			case RAW_EVERY_GENERATION:
+				return true;
+			case PNG_EVERY_10TH_GENERATION:
+			case RAW_EVERY_10TH_GENERATION:
+				return generation % 10 == 0;
+			default:
+				return false;
+		}
+	}
+
+	// Renders map and vehicles of snapshot around the leader and queues the frame if generation is selected
+	void Capture(MapPrototype* mapPrototype, DrawableSnapshot& drawableSnapshot, const SimulatedSnapshot& snapshot, size_t generation)
+	{
+		if (!IsGenerationSelected(generation))
+			return;
+
+		if (!m_created)
+		{
+			if (!m_renderTexture.create(m_width, m_height))
+			{
+				CoreLogger::PrintError("Cannot create render texture for the frame capture!");
+				Reset();
+				return;
+			}
+			m_created = true;
+		}
+
+		if (generation != m_generation)
+		{
+			m_generation = generation;
+			m_frameIndex = 0;
+		}
+
+		// Capture view has the same zoom as the window view so that level of detail stays the same
+		sf::View view = CoreWindow::GetView();
+		const size_t leaderIndex = snapshot.GetLeaderIndex();
+		if (leaderIndex < snapshot.GetNumberOfVehicles())
+			view.setCenter(snapshot.GetCenter(leaderIndex));
+		view.setViewport(CalculateViewport(view.getSize()));
+
+		m_renderTexture.clear(ColorContext::Background);
+		CoreWindow::BeginOffscreen(m_renderTexture, view);
+		mapPrototype->DrawEdges();
+		drawableSnapshot.SetSnapshot(&snapshot);
+		drawableSnapshot.Draw();
+		CoreWindow::EndOffscreen();
+		m_renderTexture.display();
+
+		// Framebuffer of render texture is read here from bottom to top, rows flipping, PNG encoding and writing is done by writer thread
+		const bool png = m_mode == PNG_EVERY_GENERATION || m_mode == PNG_EVERY_10TH_GENERATION;
+		if (m_renderTexture.setActive(true))
+		{
+			m_frameWriter.Push(sf::Vector2u(m_width, m_height), true, png ? GetFrameFilename() : GetStreamFilename(), png ? FrameWriter::PNG_FORMAT : FrameWriter::RAW_FORMAT,
+				[](sf::Uint8* pixels) { glReadPixels(0, 0, GLsizei(m_width), GLsizei(m_height), GL_RGBA, GL_UNSIGNED_BYTE, pixels); });
+			m_renderTexture.setActive(false);
+		}
+		++m_frameIndex;
+	}
+
+private:
+
+	// Returns viewport that keeps aspect ratio of the view, the rest of the frame is left as background bars
+	inline static sf::FloatRect CalculateViewport(const sf::Vector2f& viewSize)
+	{
+		const float viewRatio = viewSize.x / viewSize.y;
+		const float frameRatio = float(m_width) / float(m_height);
+		if (viewRatio > frameRatio)
+		{
+			const float height = frameRatio / viewRatio;
+			return sf::FloatRect(0.f, (1.f - height) / 2.f, 1.f, height);
+		}
+
+		const float width = viewRatio / frameRatio;
+		return sf::FloatRect((1.f - width) / 2.f, 0.f, width, 1.f);
+	}
+
+	// Returns filename of numbered PNG frame of current generation
+	inline std::string GetFrameFilename() const
+	{
+		std::ostringstream stream;
+		stream << m_directory << "/generation_" << std::setw(4) << std::setfill('0') << m_generation;
+		stream << "/frame_" << std::setw(6) << std::setfill('0') << m_frameIndex << ".png";
+		return stream.str();
+	}
+
+	// Returns filename of raw RGBA stream of current generation, resolution is a part of the filename
+	inline std::string GetStreamFilename() const
+	{
+		std::ostringstream stream;
+		stream << m_directory << "/generation_" << std::setw(4) << std::setfill('0') << m_generation;
+		stream << "_" << m_width << "x" << m_height << ".rgba";
+		return stream.str();
+	}
+
+	inline static const unsigned int m_width = 1280;
+	inline static const unsigned int m_height = 720;
+	inline static const std::string m_directory = "capture";
+	size_t m_mode;
+	sf::RenderTexture m_renderTexture;
+	bool m_created;
+	FrameWriter m_frameWriter;
+	size_t m_generation;
+	size_t m_frameIndex;
+};
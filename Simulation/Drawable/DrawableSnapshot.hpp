@@ -0,0 +1,92 @@
+#pragma once
+#include "DrawableInterface.hpp"
+#include "DrawableVehicleBatch.hpp"
+#include "SimulatedSnapshot.hpp"
+#include "CoreWindow.hpp"
+
+// Draws vehicles from snapshot published by simulation thread
+// Vehicles inside the view are gathered in one batch and drawn at once
+class DrawableSnapshot final :
+	public DrawableInterface
+{
+	const SimulatedSnapshot* m_snapshot;
+	DrawableVehicleBatch m_vehicleBatch;
+	std::vector<size_t> m_drawnVehicles; // Indexes of vehicles inside the view
+
+public:
+
+	DrawableSnapshot() :
+		m_snapshot(nullptr)
+	{
+	}
+
+	~DrawableSnapshot()
+	{
+	}
+
+	// Removes snapshot, should be called when vehicles of simulation are replaced
+	inline void Clear()
+	{
+		m_vehicleBatch.Clear();
+		m_snapshot = nullptr;
+	}
+
+	// Sets snapshot that will be drawn
+	inline void SetSnapshot(const SimulatedSnapshot* snapshot)
+	{
+		m_snapshot = snapshot;
+	}
+
+	// Draws vehicles that are inside the view
+	void Draw()
+	{
+		if (!m_snapshot)
+			return;
+
+		// Vehicle is drawn together with its beams so the view is extended by the body bound and beam length
+		const float beamLength = float(VehicleBuilder::GetDefaultBeamLength());
+		const sf::Vector2f margin = VehicleBuilder::GetMaxBodyBound() + sf::Vector2f(beamLength, beamLength);
+		const sf::Vector2f viewOffset = CoreWindow::GetViewOffset() - margin;
+		const sf::Vector2f viewSize = CoreWindow::GetViewSize() + margin * 2.f;
+
+		// Vehicles near the leader are drawn in full detail
+		const size_t numberOfVehicles = m_snapshot->GetNumberOfVehicles();
+		const size_t leaderIndex = m_snapshot->GetLeaderIndex();
+		m_vehicleBatch.Begin(leaderIndex < numberOfVehicles ? m_snapshot->GetCenter(leaderIndex) : CoreWindow::GetViewCenter());
+		m_drawnVehicles.clear();
+		for (size_t i = 0; i < numberOfVehicles; ++i)
+		{
+			const sf::Vector2f& center = m_snapshot->GetCenter(i);
+			if (MathContext::IsPointInsideRectangle(viewSize, viewOffset, center))
+			{
+				m_drawnVehicles.push_back(i);
+				m_vehicleBatch.AddCandidate(center, m_snapshot->IsActive(i), m_snapshot->IsLeader(i));
+			}
+		}
+
+		m_vehicleBatch.SelectDetails();
+		for (size_t candidate = 0; candidate < m_drawnVehicles.size(); ++candidate)
+		{
+			const size_t i = m_drawnVehicles[candidate];
+			const sf::Vector2f& center = m_snapshot->GetCenter(i);
+			const size_t detail = m_vehicleBatch.GetDetail(candidate);
+			if (detail == DrawableVehicleBatch::POINT_DETAIL)
+			{
+				m_vehicleBatch.AddPoint(center, m_snapshot->GetMass(i), m_snapshot->IsLeader(i));
+				continue;
+			}
+
+			m_vehicleBatch.AddBody(m_snapshot->GetBodyPoints(i), m_snapshot->GetNumberOfBodyPoints(i), m_snapshot->GetMass(i), m_snapshot->IsLeader(i));
+			if (detail == DrawableVehicleBatch::BODY_DETAIL)
+				continue;
+
+			const sf::Vector2f* beamOrigins = m_snapshot->GetBeamOrigins(i);
+			const sf::Vector2f* beamEnds = m_snapshot->GetBeamEnds(i);
+			const bool active = m_snapshot->IsActive(i);
+			for (size_t j = 0; j < m_snapshot->GetNumberOfBeams(i); ++j)
+				m_vehicleBatch.AddBeam(beamOrigins[j], beamEnds[j], active);
+		}
+
+		m_vehicleBatch.Draw();
+	}
+};
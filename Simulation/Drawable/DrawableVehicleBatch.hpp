@@ -0,0 +1,187 @@
+#pragma once
+#include "DrawableInterface.hpp"
+#include "MathContext.hpp"
+#include "VehicleBuilder.hpp"
+#include "CoreWindow.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+// Gathers geometry of all drawn vehicles in persistent vertex streams
+// Bodies, beams and sensors of any number of vehicles are submitted in three draw calls
+// Level of detail of every vehicle is selected so that frame time does not grow with population size
+class DrawableVehicleBatch final :
+	public DrawableInterface
+{
+	sf::VertexArray m_bodies; // Convex bodies triangulated as fans and point sprites
+	sf::VertexArray m_beams;
+	sf::VertexArray m_sensors; // Sensor circles triangulated as fans
+
+	// Level of detail data of current frame
+	sf::Vector2f m_focus;
+	float m_zoom;
+	std::vector<size_t> m_details; // Level of detail of every candidate
+	std::vector<std::pair<float, size_t>> m_fullDetailCandidates; // Distance from the focus and candidate index
+
+	// Level of detail policy
+	inline static const float m_bodyDetailZoom = 2.0f; // Beams are not drawn from this zoom
+	inline static const float m_pointDetailZoom = 3.0f; // Only points are drawn from this zoom
+	inline static const float m_fullDetailDistance = 800.0f; // Max distance from the focus of full detail vehicle
+	inline static const size_t m_maxNumberOfFullDetails = 16;
+	inline static const float m_pointSize = 2.0f; // Half of point sprite size in pixels
+	inline static const size_t m_numberOfSensorSegments = 12;
+
+	// Returns points of unit circle used for sensors, the first point is repeated at the end
+	inline static const std::array<sf::Vector2f, m_numberOfSensorSegments + 1>& GetSensorCircle()
+	{
+		static const auto sensorCircle = [] {
+			std::array<sf::Vector2f, m_numberOfSensorSegments + 1> points;
+			for (size_t i = 0; i < m_numberOfSensorSegments; ++i)
+			{
+				const double angle = 2.0 * M_PI * double(i) / double(m_numberOfSensorSegments);
+				points[i] = sf::Vector2f(float(std::cos(angle)), float(std::sin(angle)));
+			}
+			points[m_numberOfSensorSegments] = points[0];
+			return points;
+		}();
+		return sensorCircle;
+	}
+
+public:
+
+	// Levels of detail
+	enum
+	{
+		FULL_DETAIL, // Body, beams and sensors
+		BODY_DETAIL, // Body only
+		POINT_DETAIL // Point sprite
+	};
+
+	DrawableVehicleBatch() :
+		m_bodies(sf::Triangles),
+		m_beams(sf::Lines),
+		m_sensors(sf::Triangles),
+		m_zoom(1.0f)
+	{
+	}
+
+	~DrawableVehicleBatch()
+	{
+	}
+
+	// Removes geometry of previous frame, allocated memory is kept
+	inline void Clear()
+	{
+		m_bodies.clear();
+		m_beams.clear();
+		m_sensors.clear();
+	}
+
+	// Removes geometry and candidates of previous frame and prepares level of detail selection
+	// Vehicles nearest to the focus are drawn in full detail, focus is usually the leader
+	inline void Begin(const sf::Vector2f& focus)
+	{
+		Clear();
+		m_focus = focus;
+		m_zoom = CoreWindow::GetViewSize().x / CoreWindow::GetWindowSize().x;
+		m_details.clear();
+		m_fullDetailCandidates.clear();
+	}
+
+	// Adds vehicle that will be drawn in this frame, candidate index is the order of calls
+	inline void AddCandidate(const sf::Vector2f& center, bool active, bool leader)
+	{
+		const size_t index = m_details.size();
+		if (m_zoom >= m_pointDetailZoom)
+			m_details.push_back(leader ? BODY_DETAIL : POINT_DETAIL);
+		else if (!active)
+			m_details.push_back(POINT_DETAIL);
+		else if (leader)
+			m_details.push_back(m_zoom >= m_bodyDetailZoom ? BODY_DETAIL : FULL_DETAIL);
+		else
+		{
+			m_details.push_back(BODY_DETAIL);
+			const float distance = MathContext::Distance(center, m_focus);
+			if (m_zoom < m_bodyDetailZoom && distance <= m_fullDetailDistance)
+				m_fullDetailCandidates.emplace_back(distance, index);
+		}
+	}
+
+	// Selects levels of detail of all candidates, leader is not limited by number of full detail vehicles
+	// Order in which candidates were added does not matter, only the nearest vehicles get full detail
+	inline void SelectDetails()
+	{
+		if (m_fullDetailCandidates.size() > m_maxNumberOfFullDetails)
+		{
+			std::nth_element(m_fullDetailCandidates.begin(), m_fullDetailCandidates.begin() + m_maxNumberOfFullDetails, m_fullDetailCandidates.end());
+			m_fullDetailCandidates.resize(m_maxNumberOfFullDetails);
+		}
+
+		for (const auto& candidate : m_fullDetailCandidates)
+			m_details[candidate.second] = FULL_DETAIL;
+	}
+
+	// Returns level of detail of candidate selected by the last selection
+	inline size_t GetDetail(size_t index) const
+	{
+		return m_details[index];
+	}
+
+	// Adds point sprite, its size on the screen does not depend on zoom
+	inline void AddPoint(const sf::Vector2f& center, float mass, bool leader)
+	{
+		const sf::Color color = leader ? ColorContext::LeaderVehicle : VehicleBuilder::CalculateDefaultColor(mass);
+		const float size = m_pointSize * m_zoom;
+		const sf::Vertex topLeft(sf::Vector2f(center.x - size, center.y - size), color);
+		const sf::Vertex topRight(sf::Vector2f(center.x + size, center.y - size), color);
+		const sf::Vertex bottomRight(sf::Vector2f(center.x + size, center.y + size), color);
+		const sf::Vertex bottomLeft(sf::Vector2f(center.x - size, center.y + size), color);
+		m_bodies.append(topLeft);
+		m_bodies.append(topRight);
+		m_bodies.append(bottomRight);
+		m_bodies.append(topLeft);
+		m_bodies.append(bottomRight);
+		m_bodies.append(bottomLeft);
+	}
+
+	// Adds convex vehicle body, leader is drawn with leader color and other vehicles with color representing mass
+	inline void AddBody(const sf::Vector2f* points, size_t numberOfPoints, float mass, bool leader)
+	{
+		const sf::Color color = leader ? ColorContext::LeaderVehicle : VehicleBuilder::CalculateDefaultColor(mass);
+		for (size_t i = 1; i + 1 < numberOfPoints; ++i)
+		{
+			m_bodies.append(sf::Vertex(points[0], color));
+			m_bodies.append(sf::Vertex(points[i], color));
+			m_bodies.append(sf::Vertex(points[i + 1], color));
+		}
+	}
+
+	// Adds beam and sensor placed at the beam origin, disabled beams are not visible
+	inline void AddBeam(const sf::Vector2f& origin, const sf::Vector2f& end, bool enabled)
+	{
+		m_beams.append(sf::Vertex(origin, enabled ? ColorContext::BeamBeggining : ColorContext::BeamDisabled));
+		m_beams.append(sf::Vertex(end, enabled ? ColorContext::BeamEnd : ColorContext::BeamDisabled));
+
+		// Sensor is a circle centered at the beam origin
+		const float radius = VehicleBuilder::GetDefaultSensorSize().x;
+		const auto& sensorCircle = GetSensorCircle();
+		for (size_t i = 0; i < m_numberOfSensorSegments; ++i)
+		{
+			m_sensors.append(sf::Vertex(origin, ColorContext::VehicleSensorDefault));
+			m_sensors.append(sf::Vertex(origin + sensorCircle[i] * radius, ColorContext::VehicleSensorDefault));
+			m_sensors.append(sf::Vertex(origin + sensorCircle[i + 1] * radius, ColorContext::VehicleSensorDefault));
+		}
+	}
+
+	// Draws all added vehicles
+	void Draw()
+	{
+		if (m_bodies.getVertexCount())
+			CoreWindow::Draw(m_bodies);
+		if (m_beams.getVertexCount())
+			CoreWindow::Draw(m_beams);
+		if (m_sensors.getVertexCount())
+			CoreWindow::Draw(m_sensors);
+	}
+};
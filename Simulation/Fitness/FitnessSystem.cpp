@@ -2,7 +2,7 @@
 #include "FitnessSystem.hpp"
 #include "SimulatedVehicle.hpp"
 #include "SimulatedCheckpoint.hpp"
-#include <Box2D/b2_world_callbacks.h>
+#include "CoreProfiler.hpp"
 
 FitnessSystem::FitnessSystem(const size_t populationSize,
 							 const size_t checkpointCount,
@@ -12,20 +12,14 @@ FitnessSystem::FitnessSystem(const size_t populationSize,
 	m_maxFitness(Fitness(checkpointCount)),
 	m_minFitnessImprovement(minFitnessImprovement)
 {
-	m_beginContactFunction = [&] (b2Contact* contact) {
-		if (contact->GetFixtureA()->GetFilterData().categoryBits == SimulatedAbstract::CategoryCheckpoint &&
-			contact->GetFixtureB()->GetFilterData().categoryBits == SimulatedAbstract::CategoryVehicle)
+	m_checkpointFunction = [&] (SimulatedCheckpoint* simulatedCheckpoint, SimulatedVehicle* simulatedVehicle) {
+		if (simulatedVehicle->IsActive())
 		{
-			const auto fitness = ((SimulatedCheckpoint*)contact->GetFixtureA()->GetUserData().pointer)->GetFitness();
-			auto simulatedVehicle = ((SimulatedVehicle*)contact->GetFixtureB()->GetUserData().pointer);
-
-			if (simulatedVehicle->IsActive())
-			{
-				const auto currentFitness = simulatedVehicle->GetFitness();
-				const int difference = int(currentFitness) - int(fitness);
-				if (difference == 1 || difference == -1)
-					simulatedVehicle->SetFitness(fitness);
-			}
+			const auto fitness = simulatedCheckpoint->GetFitness();
+			const auto currentFitness = simulatedVehicle->GetFitness();
+			const int difference = int(currentFitness) - int(fitness);
+			if (difference == 1 || difference == -1)
+				simulatedVehicle->SetFitness(fitness);
 		}
 	};
 
@@ -62,6 +56,7 @@ void FitnessSystem::Reset()
 
 void FitnessSystem::Iterate(const SimulatedVehicles& simulatedVehicles)
 {
+	PROFILE_ZONE("FitnessSystem::Iterate");
 	Fitness totalFitness = 0.0;
 	const auto numberOfSimulatedVehicles = simulatedVehicles.size();
 	for (size_t i = 0; i < numberOfSimulatedVehicles; ++i)
@@ -102,6 +97,7 @@ void FitnessSystem::Iterate(const SimulatedVehicles& simulatedVehicles)
 
 size_t FitnessSystem::MarkLeader(const SimulatedVehicles& simulatedVehicles)
 {
+	PROFILE_ZONE("FitnessSystem::MarkLeader");
 	size_t leaderIndex = 0;
 	
 	for (size_t i = 0; i < simulatedVehicles.size(); ++i)
@@ -156,6 +152,7 @@ size_t FitnessSystem::MarkLeader(const SimulatedVehicles& simulatedVehicles)
 
 void FitnessSystem::Punish(SimulatedVehicles& simulatedVehicles)
 {
+	PROFILE_ZONE("FitnessSystem::Punish");
 	m_meanRequiredFitnessImprovement = 0.0;
 	m_numberOfPunishedVehicles = 0;
 	for (size_t i = 0; i < simulatedVehicles.size(); ++i)
@@ -184,14 +181,69 @@ void FitnessSystem::Punish(SimulatedVehicles& simulatedVehicles)
 	m_meanRequiredFitnessImprovement = m_meanRequiredFitnessImprovement / numberOfNotPunishedVehicles;
 }
 
-void FitnessSystem::UpdateTimers(SimulatedVehicles& simulatedVehicles)
+void FitnessSystem::UpdateTimers(SimulatedVehicles& simulatedVehicles, double elapsedTime)
 {
+	PROFILE_ZONE("FitnessSystem::UpdateTimers");
 	for (size_t i = 0; i < simulatedVehicles.size(); ++i)
 	{
 		if (size_t(simulatedVehicles[i]->GetFitness()) == m_maxFitness)
 			continue;
 
 		if (simulatedVehicles[i]->IsActive())
-			m_timers[i].Update();
+			m_timers[i].Update(elapsedTime);
+	}
+}
+
+void FitnessSystem::SaveState(SimulatedState& state) const
+{
+	state.Write(m_meanRequiredFitnessImprovement);
+	state.Write(m_highestFitness);
+	state.Write(m_highestFitnessOverall);
+	state.Write(m_bestTime);
+	state.Write(m_bestTimeOverall);
+	state.Write(m_numberOfPunishedVehicles);
+	state.Write(m_timers.size());
+	for (size_t i = 0; i < m_timers.size(); ++i)
+		SaveVehicleState(i, state);
+}
+
+bool FitnessSystem::RestoreState(SimulatedState& state)
+{
+	size_t populationSize = 0;
+	if (!state.Read(m_meanRequiredFitnessImprovement) ||
+		!state.Read(m_highestFitness) ||
+		!state.Read(m_highestFitnessOverall) ||
+		!state.Read(m_bestTime) ||
+		!state.Read(m_bestTimeOverall) ||
+		!state.Read(m_numberOfPunishedVehicles) ||
+		!state.Read(populationSize) ||
+		populationSize != m_timers.size())
+		return false;
+
+	for (size_t i = 0; i < m_timers.size(); ++i)
+	{
+		if (!RestoreVehicleState(i, state))
+			return false;
 	}
+
+	return true;
+}
+
+void FitnessSystem::SaveVehicleState(size_t index, SimulatedState& state) const
+{
+	state.Write(m_fitnessVector[index]);
+	state.Write(m_previousFitnessVector[index]);
+	state.Write(m_timers[index].GetValue());
+}
+
+bool FitnessSystem::RestoreVehicleState(size_t index, SimulatedState& state)
+{
+	double timerValue = 0.0;
+	if (!state.Read(m_fitnessVector[index]) ||
+		!state.Read(m_previousFitnessVector[index]) ||
+		!state.Read(timerValue))
+		return false;
+
+	m_timers[index].SetValue(timerValue);
+	return true;
 }
@@ -1,8 +1,9 @@
 #pragma once
 #include "SimulatedVehicle.hpp"
 #include "StoppableTimer.hpp"
+#include "SimulatedState.hpp"
 
-class b2Contact;
+class SimulatedCheckpoint;
 
 class FitnessSystem final
 {
@@ -29,8 +30,20 @@ public:
 	// Checks if vehicle has made improvement, if not then vehicle is set as inactive
 	void Punish(SimulatedVehicles& vehicles);
 
-	// Updates active vehicles timers
-	void UpdateTimers(SimulatedVehicles& simulatedVehicles);
+	// Updates active vehicles timers by specified elapsed time
+	void UpdateTimers(SimulatedVehicles& simulatedVehicles, double elapsedTime);
+
+	// Appends fitness and timers of current iteration to the state, statistics of finished iterations are not stored
+	void SaveState(SimulatedState& state) const;
+
+	// Restores fitness and timers of current iteration, returns false if state is incomplete or population size is different
+	bool RestoreState(SimulatedState& state);
+
+	// Appends fitness and timer of single vehicle to the state
+	void SaveVehicleState(size_t index, SimulatedState& state) const;
+
+	// Restores fitness and timer of single vehicle, state may come from other vehicle, returns false if state is incomplete
+	bool RestoreVehicleState(size_t index, SimulatedState& state);
 
 	// Converts fitness to fitness ratio
 	inline Fitness ToFitnessRatio(const Fitness fitness) const
@@ -62,10 +75,10 @@ public:
 		return m_maxFitness;
 	}
 
-	// Returns contact listener
-	inline std::function<void(b2Contact*)> GetBeginContactFunction()
+	// Returns function called when vehicle enters checkpoint
+	inline std::function<void(SimulatedCheckpoint*, SimulatedVehicle*)> GetCheckpointFunction()
 	{
-		return m_beginContactFunction;
+		return m_checkpointFunction;
 	}
 
 	// Returns mean required fitness improvement
@@ -215,7 +228,7 @@ private:
 	const Fitness m_maxFitness;
 	const double m_minFitnessImprovement;
 
-	std::function<void(b2Contact*)> m_beginContactFunction; // Begin contact (overlap detection) function
+	std::function<void(SimulatedCheckpoint*, SimulatedVehicle*)> m_checkpointFunction; // Checkpoint reached function
 
 	Fitness m_meanRequiredFitnessImprovement;
 	Fitness m_highestFitness; // Highest fitness in current iteration
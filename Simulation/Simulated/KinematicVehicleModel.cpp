@@ -0,0 +1,164 @@
+#include "KinematicVehicleModel.hpp"
+#include "SimulatedVehicle.hpp"
+#include <Box2D\box2d.h>
+#include <algorithm>
+
+KinematicVehicleModel::KinematicVehicleModel()
+{
+}
+
+KinematicVehicleModel::~KinematicVehicleModel()
+{
+}
+
+size_t KinematicVehicleModel::AddVehicle(const b2Vec2* bodyPoints,
+										 size_t numberOfBodyPoints,
+										 b2Vec2 position,
+										 float angle,
+										 float mass,
+										 float inertia)
+{
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_angle.push_back(angle);
+	m_velocityX.push_back(0.f);
+	m_velocityY.push_back(0.f);
+	m_angularVelocity.push_back(0.f);
+	m_mass.push_back(mass);
+	m_inertia.push_back(inertia);
+	m_previousPositionX.push_back(position.x);
+	m_previousPositionY.push_back(position.y);
+	m_previousAngle.push_back(angle);
+	m_driveForward.push_back(0.f);
+	m_driveBackward.push_back(0.f);
+	m_turn.push_back(float(VehicleBuilder::GetDefaultTorque()));
+	m_bodyPointsOffsets.push_back(m_bodyPoints.size());
+	m_bodyPointsCounts.push_back(numberOfBodyPoints);
+	m_bodyPoints.insert(m_bodyPoints.end(), bodyPoints, bodyPoints + numberOfBodyPoints);
+	m_collisions.push_back(0);
+	return m_positionX.size() - 1;
+}
+
+void KinematicVehicleModel::Step(float timeStep, b2World* edgesWorld)
+{
+	m_previousPositionX = m_positionX;
+	m_previousPositionY = m_positionY;
+	m_previousAngle = m_angle;
+
+	// Features shared with simulated vehicle
+	const float forceTimeStep = float(SimulatedVehicle::m_forceTimeStep);
+	const float maxForwardSpeed = float(SimulatedVehicle::m_maxForwardSpeed);
+	const float maxBackwardSpeed = float(SimulatedVehicle::m_maxBackwardSpeed);
+	const float maxDriveForce = float(SimulatedVehicle::m_maxDriveForce) * forceTimeStep;
+	const float maxTorqueForce = float(SimulatedVehicle::m_maxTorqueForce) * forceTimeStep;
+	const float maxLateralImpulse = SimulatedVehicle::m_maxLateralImpulse;
+	const float lateralFactor = 35.f * timeStep;
+	const float angularFactor = 1.f - 10.f * timeStep;
+	const float dragFactor = -2000.f * forceTimeStep;
+
+	float* positionX = m_positionX.data();
+	float* positionY = m_positionY.data();
+	float* angle = m_angle.data();
+	float* velocityX = m_velocityX.data();
+	float* velocityY = m_velocityY.data();
+	float* angularVelocity = m_angularVelocity.data();
+	const float* mass = m_mass.data();
+	const float* inertia = m_inertia.data();
+	const float* driveForward = m_driveForward.data();
+	const float* driveBackward = m_driveBackward.data();
+	const float* turn = m_turn.data();
+
+	// Loop has no dependencies between iterations so that it can be vectorized by the compiler
+	const size_t numberOfVehicles = m_positionX.size();
+	for (size_t i = 0; i < numberOfVehicles; ++i)
+	{
+		const float cosinus = std::cos(angle[i]);
+		const float sinus = std::sin(angle[i]);
+		const float inverseMass = 1.f / mass[i];
+		float forwardSpeed = velocityX[i] * cosinus + velocityY[i] * sinus;
+		float lateralSpeed = velocityY[i] * cosinus - velocityX[i] * sinus;
+
+		// Lateral linear velocity
+		const float lateralImpulse = std::min(std::max(-mass[i] * lateralSpeed, -maxLateralImpulse), maxLateralImpulse);
+		lateralSpeed += lateralImpulse * lateralFactor * inverseMass;
+
+		// Forward linear velocity, drag and drive forces
+		float force = dragFactor * forwardSpeed;
+		force += forwardSpeed < maxForwardSpeed ? driveForward[i] * maxDriveForce : 0.f;
+		force -= forwardSpeed > maxBackwardSpeed ? driveBackward[i] * maxDriveForce : 0.f;
+		forwardSpeed += timeStep * force * inverseMass;
+
+		// Angular velocity and turn torque
+		const float torque = (turn[i] * 2.f - 1.f) * maxTorqueForce;
+		angularVelocity[i] = angularVelocity[i] * angularFactor + timeStep * torque / inertia[i];
+
+		// Integrate
+		velocityX[i] = forwardSpeed * cosinus - lateralSpeed * sinus;
+		velocityY[i] = forwardSpeed * sinus + lateralSpeed * cosinus;
+		positionX[i] += timeStep * velocityX[i];
+		positionY[i] += timeStep * velocityY[i];
+		angle[i] += timeStep * angularVelocity[i];
+	}
+
+	DetectCollisions(edgesWorld);
+}
+
+void KinematicVehicleModel::DetectCollisions(b2World* edgesWorld)
+{
+	const size_t numberOfVehicles = m_positionX.size();
+	for (size_t i = 0; i < numberOfVehicles; ++i)
+	{
+		m_collisions[i] = 0;
+		const b2Transform previousTransform(b2Vec2(m_previousPositionX[i], m_previousPositionY[i]), b2Rot(m_previousAngle[i]));
+		const b2Transform currentTransform(b2Vec2(m_positionX[i], m_positionY[i]), b2Rot(m_angle[i]));
+		const b2Vec2* bodyPoints = GetBodyPoints(i);
+		const size_t numberOfBodyPoints = m_bodyPointsCounts[i];
+		bool moved = false;
+		for (size_t j = 0; j < numberOfBodyPoints; ++j)
+		{
+			// Segment between previous and current position of body point
+			const b2Vec2 startPoint = b2Mul(previousTransform, bodyPoints[j]);
+			const b2Vec2 endPoint = b2Mul(currentTransform, bodyPoints[j]);
+			if (b2DistanceSquared(startPoint, endPoint) <= b2_epsilon)
+				continue;
+
+			moved = true;
+			m_segmentRaycastCallback.Reset();
+			edgesWorld->RayCast(&m_segmentRaycastCallback, startPoint, endPoint);
+			if (m_segmentRaycastCallback.IsHit())
+			{
+				m_collisions[i] = 1;
+				break;
+			}
+		}
+
+		// Edge vertex that passed through a side of the body leaves the edge crossing that side
+		for (size_t j = 0; moved && !m_collisions[i] && j < numberOfBodyPoints; ++j)
+		{
+			const b2Vec2 startPoint = b2Mul(currentTransform, bodyPoints[j]);
+			const b2Vec2 endPoint = b2Mul(currentTransform, bodyPoints[(j + 1) % numberOfBodyPoints]);
+			if (IsSegmentCrossingEdges(edgesWorld, startPoint, endPoint))
+				m_collisions[i] = 1;
+		}
+
+		if (m_collisions[i])
+		{
+			// Move vehicle back and stop it
+			m_positionX[i] = m_previousPositionX[i];
+			m_positionY[i] = m_previousPositionY[i];
+			m_angle[i] = m_previousAngle[i];
+			m_velocityX[i] = 0.f;
+			m_velocityY[i] = 0.f;
+			m_angularVelocity[i] = 0.f;
+		}
+	}
+}
+
+bool KinematicVehicleModel::IsSegmentCrossingEdges(b2World* edgesWorld, const b2Vec2& startPoint, const b2Vec2& endPoint)
+{
+	m_segmentRaycastCallback.Reset();
+	edgesWorld->RayCast(&m_segmentRaycastCallback, startPoint, endPoint);
+	if (!m_segmentRaycastCallback.IsHit())
+		edgesWorld->RayCast(&m_segmentRaycastCallback, endPoint, startPoint);
+	return m_segmentRaycastCallback.IsHit();
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <vector>
+#include <Box2D\b2_math.h>
+#include <Box2D\b2_world_callbacks.h>
+
+class b2World;
+
+// Lightweight top-down car model used as an alternative to Box2D dynamic bodies
+// Vehicle state is kept in struct of arrays layout and all vehicles are stepped in one loop
+// Vehicles do not interact with each other, edges crossings are detected with segment tests
+// Trajectories of body points and sides of moved body are tested, so that edge vertex cannot pass through a side
+class KinematicVehicleModel final
+{
+public:
+
+	KinematicVehicleModel();
+
+	~KinematicVehicleModel();
+
+	// Adds vehicle described by body points relative to the center, returns vehicle index
+	size_t AddVehicle(const b2Vec2* bodyPoints,
+					  size_t numberOfBodyPoints,
+					  b2Vec2 position,
+					  float angle,
+					  float mass,
+					  float inertia);
+
+	// Performs single step of all vehicles, vehicles that crossed edge are moved back to the previous position
+	void Step(float timeStep, b2World* edgesWorld);
+
+	// Sets actuators values that will be used in next steps
+	inline void SetActuators(size_t index, double driveForward, double driveBackward, double turn)
+	{
+		m_driveForward[index] = float(driveForward);
+		m_driveBackward[index] = float(driveBackward);
+		m_turn[index] = float(turn);
+	}
+
+	// Returns number of vehicles
+	inline size_t GetNumberOfVehicles() const
+	{
+		return m_positionX.size();
+	}
+
+	// Returns vehicle position
+	inline b2Vec2 GetPosition(size_t index) const
+	{
+		return b2Vec2(m_positionX[index], m_positionY[index]);
+	}
+
+	// Returns vehicle angle
+	inline float GetAngle(size_t index) const
+	{
+		return m_angle[index];
+	}
+
+	// Returns vehicle linear velocity
+	inline b2Vec2 GetVelocity(size_t index) const
+	{
+		return b2Vec2(m_velocityX[index], m_velocityY[index]);
+	}
+
+	// Returns vehicle angular velocity
+	inline float GetAngularVelocity(size_t index) const
+	{
+		return m_angularVelocity[index];
+	}
+
+	// Sets vehicle position, angle and velocities, previous state is set too so that no edge crossing is detected
+	inline void SetState(size_t index, b2Vec2 position, float angle, b2Vec2 velocity, float angularVelocity)
+	{
+		m_positionX[index] = m_previousPositionX[index] = position.x;
+		m_positionY[index] = m_previousPositionY[index] = position.y;
+		m_angle[index] = m_previousAngle[index] = angle;
+		m_velocityX[index] = velocity.x;
+		m_velocityY[index] = velocity.y;
+		m_angularVelocity[index] = angularVelocity;
+	}
+
+	// Returns vehicle mass
+	inline float GetMass(size_t index) const
+	{
+		return m_mass[index];
+	}
+
+	// Returns world point of body point relative to the center
+	inline b2Vec2 GetWorldPoint(size_t index, const b2Vec2& localPoint) const
+	{
+		return b2Mul(b2Transform(GetPosition(index), b2Rot(m_angle[index])), localPoint);
+	}
+
+	// Returns vehicle body points relative to the center
+	inline const b2Vec2* GetBodyPoints(size_t index) const
+	{
+		return &m_bodyPoints[m_bodyPointsOffsets[index]];
+	}
+
+	// Returns number of vehicle body points
+	inline size_t GetNumberOfBodyPoints(size_t index) const
+	{
+		return m_bodyPointsCounts[index];
+	}
+
+	// Returns true if vehicle crossed an edge during last step
+	inline bool IsCollision(size_t index) const
+	{
+		return m_collisions[index] != 0;
+	}
+
+private:
+
+	// Detects edges crossings made by body points and edges vertices, reverts vehicles that crossed an edge
+	void DetectCollisions(b2World* edgesWorld);
+
+	// Returns true if segment crosses any edge, chain edges are one-sided so segment is tested in both directions
+	bool IsSegmentCrossingEdges(b2World* edgesWorld, const b2Vec2& startPoint, const b2Vec2& endPoint);
+
+	// Vehicle state
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_angle;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_angularVelocity;
+	std::vector<float> m_mass;
+	std::vector<float> m_inertia;
+
+	// Vehicle state from the previous step
+	std::vector<float> m_previousPositionX;
+	std::vector<float> m_previousPositionY;
+	std::vector<float> m_previousAngle;
+
+	// Actuators
+	std::vector<float> m_driveForward;
+	std::vector<float> m_driveBackward;
+	std::vector<float> m_turn;
+
+	// Body points of all vehicles stored one after another
+	std::vector<b2Vec2> m_bodyPoints;
+	std::vector<size_t> m_bodyPointsOffsets;
+	std::vector<size_t> m_bodyPointsCounts;
+	std::vector<unsigned char> m_collisions;
+
+	// Segment test callback, stops on first reported fixture
+	class SegmentRaycastCallback :
+		public b2RayCastCallback
+	{
+		bool m_hit;
+
+	public:
+
+		SegmentRaycastCallback() :
+			m_hit(false)
+		{
+		}
+
+		// Resets hit flag
+		inline void Reset()
+		{
+			m_hit = false;
+		}
+
+		// Returns true if segment crossed any fixture
+		inline bool IsHit() const
+		{
+			return m_hit;
+		}
+
+		float ReportFixture(b2Fixture*, const b2Vec2&, const b2Vec2&, float)
+		{
+			m_hit = true;
+			return 0.f; // Terminate the ray cast
+		}
+	};
+	SegmentRaycastCallback m_segmentRaycastCallback;
+};
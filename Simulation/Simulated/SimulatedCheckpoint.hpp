@@ -1,22 +1,17 @@
 #pragma once
 #include "SimulatedAbstract.hpp"
 #include "FitnessInterface.hpp"
-#include "DrawableCheckpoint.hpp"
 
+// Checkpoint is drawn by map prototype, here only its fitness is kept
 class SimulatedCheckpoint final :
 	public SimulatedAbstract,
-	public FitnessInterface,
-	public DrawableCheckpoint
+	public FitnessInterface
 {
 public:
 
-	SimulatedCheckpoint(const size_t identity, const Rectangle position) :
+	explicit SimulatedCheckpoint(const size_t identity) :
 		SimulatedAbstract(SimulatedAbstract::CategoryCheckpoint),
-		FitnessInterface(Fitness(identity + 1)),
-		DrawableCheckpoint(ColorContext::Create(ColorContext::MaxChannelValue * (identity % 3),
-												ColorContext::MaxChannelValue * ((identity + 1) % 3),
-												ColorContext::MaxChannelValue * ((identity + 2) % 3),
-												96), position)
+		FitnessInterface(Fitness(identity + 1))
 	{
 	}
 };
\ No newline at end of file
@@ -1,16 +1,14 @@
 #pragma once
 #include "SimulatedAbstract.hpp"
-#include "DrawableEdge.hpp"
 
+// Edge is drawn by map prototype, here only its category is kept
 class SimulatedEdge final :
-	public SimulatedAbstract,
-	public DrawableEdge
+	public SimulatedAbstract
 {
 public:
 
 	SimulatedEdge() :
-		SimulatedAbstract(SimulatedAbstract::CategoryEdge),
-		DrawableEdge()
+		SimulatedAbstract(SimulatedAbstract::CategoryEdge)
 	{
 	}
 };
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include "SimulatedReplay.hpp"
+#include "SimulatedWorld.hpp"
+#include "MapPrototype.hpp"
+#include "VehiclePrototype.hpp"
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	// Appends zigzag varint of signed value, small values of both signs take one byte
+	void AppendVarint(std::vector<uint8_t>& data, int64_t value)
+	{
+		uint64_t zigzag = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+		while (zigzag >= 0x80)
+		{
+			data.push_back(uint8_t(zigzag | 0x80));
+			zigzag >>= 7;
+		}
+		data.push_back(uint8_t(zigzag));
+	}
+
+	// Reads zigzag varint at offset and moves offset behind it, returns false if data is incomplete
+	bool ReadVarint(const std::vector<uint8_t>& data, size_t& offset, int64_t& value)
+	{
+		uint64_t zigzag = 0;
+		for (size_t shift = 0; shift < 64; shift += 7)
+		{
+			if (offset >= data.size())
+				return false;
+
+			const uint8_t byte = data[offset++];
+			zigzag |= uint64_t(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+			{
+				value = int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Returns CRC32 of floats in little-endian byte order
+	uint32_t CalculateHash(std::vector<float> values)
+	{
+		BinaryContainer::ToLittleEndian(reinterpret_cast<char*>(values.data()), values.size(), sizeof(float));
+		return BinaryContainer::CalculateChecksum(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+	}
+}
+
+void SimulatedReplay::Clear()
+{
+	m_numberOfTicks = 0;
+	m_previousActuators = {};
+	m_data.clear();
+	m_keyframes.clear();
+}
+
+void SimulatedReplay::Append(const Actuators& actuators, const SimulatedVehiclePose& pose)
+{
+	if (m_numberOfTicks % m_keyframeInterval == 0)
+		m_keyframes.push_back({ m_data.size(), m_previousActuators, pose });
+
+	for (size_t i = 0; i < NUMBER_OF_ACTUATORS; ++i)
+		AppendVarint(m_data, int64_t(actuators[i]) - int64_t(m_previousActuators[i]));
+	m_previousActuators = actuators;
+	++m_numberOfTicks;
+}
+
+bool SimulatedReplay::Decode(size_t& offset, Actuators& actuators) const
+{
+	for (size_t i = 0; i < NUMBER_OF_ACTUATORS; ++i)
+	{
+		int64_t difference = 0;
+		if (!ReadVarint(m_data, offset, difference))
+			return false;
+		actuators[i] = int32_t(int64_t(actuators[i]) + difference);
+	}
+
+	return true;
+}
+
+void SimulatedReplayRecorder::Start(const Settings& settings)
+{
+	Clear();
+	m_settings = settings;
+}
+
+void SimulatedReplayRecorder::BeginGeneration(size_t numberOfVehicles)
+{
+	m_vehicleReplays.resize(numberOfVehicles, SimulatedReplay(m_keyframeInterval));
+	for (auto& replay : m_vehicleReplays)
+		replay.Clear();
+}
+
+void SimulatedReplayRecorder::EndGeneration(size_t generation, const FitnessVector& fitnessVector)
+{
+	const size_t numberOfVehicles = std::min(fitnessVector.size(), m_vehicleReplays.size());
+	if (!numberOfVehicles)
+		return;
+
+	const size_t bestIndex = size_t(std::max_element(fitnessVector.begin(), fitnessVector.begin() + numberOfVehicles) - fitnessVector.begin());
+	m_replays.push_back(std::move(m_vehicleReplays[bestIndex]));
+	m_replays.back().SetGeneration(generation);
+	m_replays.back().m_data.shrink_to_fit();
+	m_replays.back().m_keyframes.shrink_to_fit();
+	m_vehicleReplays[bestIndex] = SimulatedReplay(m_keyframeInterval);
+}
+
+void SimulatedReplayRecorder::Clear()
+{
+	m_settings = Settings();
+	m_vehicleReplays.clear();
+	m_replays.clear();
+}
+
+bool SimulatedReplayRecorder::Save(const std::string& filename) const
+{
+	std::ofstream output(filename, std::ios::out | std::ios::binary);
+	if (!output.is_open())
+		return false;
+
+	BinaryContainer container(m_containerType);
+	const std::array<uint64_t, 9> settings = {
+		m_settings.m_mapHash,
+		m_settings.m_vehicleHash,
+		uint64_t(m_settings.m_dynamicsType),
+		m_settings.m_deathOnEdgeContact ? 1u : 0u,
+		m_settings.m_physicsRate,
+		m_settings.m_sensorInterval,
+		m_settings.m_controllerInterval,
+		m_keyframeInterval,
+		m_settings.m_seed
+	};
+	container.AddSection(m_settingsSection, settings.data(), settings.size());
+
+	// Replays are stored one after another, keyframe counts are given by number of ticks
+	std::vector<uint64_t> generations;
+	std::vector<uint64_t> ticks;
+	std::vector<uint64_t> lengths;
+	std::vector<uint8_t> data;
+	std::vector<uint64_t> keyframeOffsets;
+	std::vector<int32_t> keyframeActuators;
+	std::vector<float> keyframePoses;
+	for (const auto& replay : m_replays)
+	{
+		generations.push_back(replay.GetGeneration());
+		ticks.push_back(replay.GetNumberOfTicks());
+		lengths.push_back(replay.GetData().size());
+		data.insert(data.end(), replay.GetData().begin(), replay.GetData().end());
+		for (const auto& keyframe : replay.GetKeyframes())
+		{
+			keyframeOffsets.push_back(keyframe.m_offset);
+			keyframeActuators.insert(keyframeActuators.end(), keyframe.m_actuators.begin(), keyframe.m_actuators.end());
+			const auto& pose = keyframe.m_pose;
+			keyframePoses.insert(keyframePoses.end(), { pose.m_positionX, pose.m_positionY, pose.m_angle, pose.m_velocityX, pose.m_velocityY, pose.m_angularVelocity });
+		}
+	}
+
+	container.AddSection(m_generationsSection, generations);
+	container.AddSection(m_ticksSection, ticks);
+	container.AddSection(m_lengthsSection, lengths);
+	container.AddSection(m_dataSection, data);
+	container.AddSection(m_keyframeOffsetsSection, keyframeOffsets);
+	container.AddSection(m_keyframeActuatorsSection, keyframeActuators);
+	container.AddSection(m_keyframePosesSection, keyframePoses);
+	return container.Write(output);
+}
+
+bool SimulatedReplayRecorder::Load(const std::string& filename)
+{
+	Clear();
+	std::ifstream input(filename, std::ios::in | std::ios::binary);
+	if (!input.is_open())
+		return false;
+
+	BinaryContainer container;
+	if (container.Read(input) != BinaryContainer::READ_SUCCESS || container.GetType() != m_containerType)
+		return false;
+
+	std::array<uint64_t, 9> settings = {};
+	std::vector<uint64_t> generations;
+	std::vector<uint64_t> ticks;
+	std::vector<uint64_t> lengths;
+	std::vector<uint8_t> data;
+	std::vector<uint64_t> keyframeOffsets;
+	std::vector<int32_t> keyframeActuators;
+	std::vector<float> keyframePoses;
+	if (!container.GetSection(m_settingsSection, settings.data(), settings.size()) ||
+		!container.GetSection(m_generationsSection, generations) ||
+		!container.GetSection(m_ticksSection, ticks) ||
+		!container.GetSection(m_lengthsSection, lengths) ||
+		!container.GetSection(m_dataSection, data) ||
+		!container.GetSection(m_keyframeOffsetsSection, keyframeOffsets) ||
+		!container.GetSection(m_keyframeActuatorsSection, keyframeActuators) ||
+		!container.GetSection(m_keyframePosesSection, keyframePoses))
+		return false;
+
+	const size_t keyframeInterval = size_t(settings[7]);
+	if (settings[2] >= NUMBER_OF_DYNAMICS_TYPES || !settings[4] || !settings[5] || !settings[6] || !keyframeInterval ||
+		generations.size() != ticks.size() ||
+		generations.size() != lengths.size() ||
+		keyframeActuators.size() != keyframeOffsets.size() * SimulatedReplay::NUMBER_OF_ACTUATORS ||
+		keyframePoses.size() != keyframeOffsets.size() * SimulatedReplay::NUMBER_OF_POSE_VALUES)
+		return false;
+
+	// Split data and keyframes into replays, every keyframe has to point inside data of its replay
+	size_t dataOffset = 0;
+	size_t keyframeIndex = 0;
+	m_replays.resize(generations.size(), SimulatedReplay(keyframeInterval));
+	for (size_t i = 0; i < m_replays.size(); ++i)
+	{
+		auto& replay = m_replays[i];
+		const size_t numberOfKeyframes = ticks[i] / keyframeInterval + (ticks[i] % keyframeInterval ? 1 : 0);
+		if (lengths[i] > data.size() - dataOffset || ticks[i] > lengths[i] || numberOfKeyframes > keyframeOffsets.size() - keyframeIndex)
+		{
+			m_replays.clear();
+			return false;
+		}
+
+		replay.m_generation = size_t(generations[i]);
+		replay.m_numberOfTicks = size_t(ticks[i]);
+		replay.m_data.assign(data.begin() + dataOffset, data.begin() + dataOffset + size_t(lengths[i]));
+		replay.m_keyframes.resize(numberOfKeyframes);
+		for (auto& keyframe : replay.m_keyframes)
+		{
+			if (keyframeOffsets[keyframeIndex] > lengths[i])
+			{
+				m_replays.clear();
+				return false;
+			}
+
+			keyframe.m_offset = size_t(keyframeOffsets[keyframeIndex]);
+			std::copy_n(&keyframeActuators[keyframeIndex * SimulatedReplay::NUMBER_OF_ACTUATORS], SimulatedReplay::NUMBER_OF_ACTUATORS, keyframe.m_actuators.begin());
+			const float* pose = &keyframePoses[keyframeIndex * SimulatedReplay::NUMBER_OF_POSE_VALUES];
+			keyframe.m_pose = { pose[0], pose[1], pose[2], pose[3], pose[4], pose[5] };
+			++keyframeIndex;
+		}
+
+		dataOffset += size_t(lengths[i]);
+	}
+
+	m_keyframeInterval = keyframeInterval;
+	m_settings.m_mapHash = uint32_t(settings[0]);
+	m_settings.m_vehicleHash = uint32_t(settings[1]);
+	m_settings.m_dynamicsType = int(settings[2]);
+	m_settings.m_deathOnEdgeContact = settings[3] != 0;
+	m_settings.m_physicsRate = size_t(settings[4]);
+	m_settings.m_sensorInterval = size_t(settings[5]);
+	m_settings.m_controllerInterval = size_t(settings[6]);
+	m_settings.m_seed = settings[8];
+	return true;
+}
+
+uint32_t SimulatedReplayRecorder::CalculateMapHash(const MapPrototype* mapPrototype)
+{
+	std::vector<float> values;
+	for (const auto* edgesChain : { &mapPrototype->GetInnerEdgesChain(), &mapPrototype->GetOuterEdgesChain() })
+	{
+		for (const auto& edge : *edgesChain)
+			values.insert(values.end(), { edge[0].x, edge[0].y, edge[1].x, edge[1].y });
+	}
+
+	return CalculateHash(std::move(values));
+}
+
+uint32_t SimulatedReplayRecorder::CalculateVehicleHash(const VehiclePrototype* vehiclePrototype)
+{
+	std::vector<float> values = { vehiclePrototype->GetCenter().x, vehiclePrototype->GetCenter().y, float(vehiclePrototype->GetAngle()) };
+	for (const auto& point : vehiclePrototype->GetBodyPoints())
+		values.insert(values.end(), { point.x, point.y });
+
+	return CalculateHash(std::move(values));
+}
+
+void SimulatedReplayPlayer::Start(const SimulatedReplay* replay, const SimulatedReplayRecorder::Settings& settings, SimulatedWorld* world, SimulatedVehicle* vehicle)
+{
+	m_replay = replay;
+	m_settings = settings;
+	m_world = world;
+	m_vehicle = vehicle;
+	m_step = 0;
+	m_tick = 0;
+	m_offset = 0;
+	m_actuators = {};
+}
+
+void SimulatedReplayPlayer::Stop()
+{
+	m_replay = nullptr;
+	m_world = nullptr;
+	m_vehicle = nullptr;
+}
+
+bool SimulatedReplayPlayer::Step(size_t numberOfSteps)
+{
+	if (!m_replay)
+		return false;
+
+	const float timeStep = float(1.0 / double(m_settings.m_physicsRate));
+	const double sensorTimeStep = double(m_settings.m_sensorInterval) / double(m_settings.m_physicsRate);
+	for (size_t step = 0; step < numberOfSteps; ++step)
+	{
+		if (m_step % m_settings.m_sensorInterval == 0)
+			m_world->UpdateSensors(sensorTimeStep);
+
+		// Recorded actuators are applied on controller ticks
+		if (m_step % m_settings.m_controllerInterval == 0)
+		{
+			if (m_tick >= m_replay->GetNumberOfTicks() || !m_vehicle->IsActive())
+				return false;
+
+			if (!m_replay->Decode(m_offset, m_actuators))
+				return false;
+			m_vehicle->SetQuantizedActuators(m_actuators);
+			++m_tick;
+		}
+
+		m_vehicle->Update(timeStep);
+		m_world->Step(timeStep);
+		++m_step;
+	}
+
+	return true;
+}
+
+void SimulatedReplayPlayer::Seek(size_t keyframeIndex)
+{
+	if (!m_replay || keyframeIndex >= m_replay->GetKeyframes().size())
+		return;
+
+	const auto& keyframe = m_replay->GetKeyframes()[keyframeIndex];
+	m_tick = keyframeIndex * m_replay->GetKeyframeInterval();
+	m_step = m_tick * m_settings.m_controllerInterval;
+	m_offset = keyframe.m_offset;
+	m_actuators = keyframe.m_actuators;
+	m_vehicle->SetActive();
+	m_vehicle->SetPose(keyframe.m_pose);
+}
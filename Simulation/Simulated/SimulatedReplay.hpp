@@ -0,0 +1,272 @@
+#pragma once
+#include "SimulatedVehicle.hpp"
+#include "Genetic.hpp"
+#include "BinaryContainer.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MapPrototype;
+class VehiclePrototype;
+class SimulatedWorld;
+
+// Actuators of one vehicle recorded on every controller tick
+// Every actuator is stored as zigzag varint of the difference from its value in the previous tick,
+// so that steady control takes one byte per actuator
+// Live vehicles apply quantized actuators, so recorded actuators are exactly the applied ones
+// Keyframes with vehicle pose are stored every few ticks, they are used only to seek replay
+class SimulatedReplay final
+{
+public:
+
+	enum
+	{
+		NUMBER_OF_ACTUATORS = 3,
+		NUMBER_OF_POSE_VALUES = sizeof(SimulatedVehiclePose) / sizeof(float)
+	};
+
+	using Actuators = std::array<int32_t, NUMBER_OF_ACTUATORS>;
+
+	// State needed to start decoding from the tick of keyframe
+	struct Keyframe
+	{
+		size_t m_offset; // Offset of the first byte of keyframe tick
+		Actuators m_actuators; // Actuators of the previous tick, differences are relative to them
+		SimulatedVehiclePose m_pose; // Pose before actuators of keyframe tick are applied
+	};
+
+	SimulatedReplay(size_t keyframeInterval = 64) :
+		m_keyframeInterval(keyframeInterval ? keyframeInterval : 1),
+		m_generation(0),
+		m_numberOfTicks(0),
+		m_previousActuators({})
+	{
+	}
+
+	~SimulatedReplay()
+	{
+	}
+
+	// Removes recorded ticks
+	void Clear();
+
+	// Appends actuators of the next tick, keyframe is added every keyframe interval ticks
+	void Append(const Actuators& actuators, const SimulatedVehiclePose& pose);
+
+	// Decodes actuators of tick which starts at offset and moves offset to the next tick
+	// Actuators hold values of the previous tick, returns false if data is incomplete
+	bool Decode(size_t& offset, Actuators& actuators) const;
+
+	// Returns keyframe interval in ticks
+	inline size_t GetKeyframeInterval() const
+	{
+		return m_keyframeInterval;
+	}
+
+	// Returns generation of recorded vehicle
+	inline size_t GetGeneration() const
+	{
+		return m_generation;
+	}
+
+	// Sets generation of recorded vehicle
+	inline void SetGeneration(size_t generation)
+	{
+		m_generation = generation;
+	}
+
+	// Returns number of recorded ticks
+	inline size_t GetNumberOfTicks() const
+	{
+		return m_numberOfTicks;
+	}
+
+	// Returns keyframes
+	inline const std::vector<Keyframe>& GetKeyframes() const
+	{
+		return m_keyframes;
+	}
+
+	// Returns encoded actuators
+	inline const std::vector<uint8_t>& GetData() const
+	{
+		return m_data;
+	}
+
+private:
+
+	friend class SimulatedReplayRecorder; // Recorder restores replays from file
+
+	size_t m_keyframeInterval;
+	size_t m_generation;
+	size_t m_numberOfTicks;
+	Actuators m_previousActuators; // Used only while recording
+	std::vector<uint8_t> m_data;
+	std::vector<Keyframe> m_keyframes;
+};
+
+// Records all vehicles of current generation and keeps replay of the best vehicle of every generation
+// Replays are saved together with settings needed to reproduce them and hashes of map and vehicle they were recorded on
+class SimulatedReplayRecorder final
+{
+public:
+
+	// Settings of recorded run
+	struct Settings
+	{
+		uint32_t m_mapHash = 0;
+		uint32_t m_vehicleHash = 0;
+		uint64_t m_seed = 0; // Seed of genetic algorithm, identifies recorded run but is not needed to play replay
+		int m_dynamicsType = 0;
+		bool m_deathOnEdgeContact = false;
+		size_t m_physicsRate = 1;
+		size_t m_sensorInterval = 1;
+		size_t m_controllerInterval = 1;
+	};
+
+	SimulatedReplayRecorder(size_t keyframeInterval = 64) :
+		m_keyframeInterval(keyframeInterval)
+	{
+	}
+
+	~SimulatedReplayRecorder()
+	{
+	}
+
+	// Removes all replays and sets settings of new run
+	void Start(const Settings& settings);
+
+	// Prepares empty replays for every vehicle of the next generation
+	void BeginGeneration(size_t numberOfVehicles);
+
+	// Records actuators and pose of vehicle in current controller tick, inactive vehicles are not recorded
+	// Every vehicle has its own replay so that vehicles can be recorded in parallel
+	inline void Record(size_t index, const SimulatedVehicle* vehicle)
+	{
+		if (vehicle->IsActive())
+			m_vehicleReplays[index].Append(vehicle->GetQuantizedActuators(), vehicle->GetPose());
+	}
+
+	// Keeps replay of the vehicle with the highest fitness, replays of other vehicles are dropped
+	void EndGeneration(size_t generation, const FitnessVector& fitnessVector);
+
+	// Removes all replays
+	void Clear();
+
+	// Returns settings of recorded run
+	inline const Settings& GetSettings() const
+	{
+		return m_settings;
+	}
+
+	// Returns replays of the best vehicles
+	inline const std::vector<SimulatedReplay>& GetReplays() const
+	{
+		return m_replays;
+	}
+
+	// Saves settings and replays to file
+	bool Save(const std::string& filename) const;
+
+	// Loads settings and replays from file, returns false if file cannot be read or is incorrect
+	bool Load(const std::string& filename);
+
+	// Returns hash of map edges
+	static uint32_t CalculateMapHash(const MapPrototype* mapPrototype);
+
+	// Returns hash of vehicle body and its starting position
+	static uint32_t CalculateVehicleHash(const VehiclePrototype* vehiclePrototype);
+
+private:
+
+	size_t m_keyframeInterval;
+	Settings m_settings;
+	std::vector<SimulatedReplay> m_vehicleReplays; // Replays of current generation
+	std::vector<SimulatedReplay> m_replays; // Replays of the best vehicles of finished generations
+	inline static const uint32_t m_containerType = BinaryContainer::MakeIdentifier("RPLY");
+	inline static const uint32_t m_settingsSection = BinaryContainer::MakeIdentifier("INFO"); // Hashes, dynamics, rates, keyframe interval and seed
+	inline static const uint32_t m_generationsSection = BinaryContainer::MakeIdentifier("GENS"); // Generation of every replay
+	inline static const uint32_t m_ticksSection = BinaryContainer::MakeIdentifier("TICK"); // Number of ticks of every replay
+	inline static const uint32_t m_lengthsSection = BinaryContainer::MakeIdentifier("DLEN"); // Length of encoded actuators of every replay
+	inline static const uint32_t m_dataSection = BinaryContainer::MakeIdentifier("DATA"); // Encoded actuators of all replays
+	inline static const uint32_t m_keyframeOffsetsSection = BinaryContainer::MakeIdentifier("KOFF"); // Offsets of all keyframes
+	inline static const uint32_t m_keyframeActuatorsSection = BinaryContainer::MakeIdentifier("KACT"); // Actuators of all keyframes
+	inline static const uint32_t m_keyframePosesSection = BinaryContainer::MakeIdentifier("KPOS"); // Poses of all keyframes
+};
+
+// Plays replay by applying recorded actuators to simulated vehicle, artificial neural networks are not evaluated
+// Physics, sensor and controller steps are performed in the same order as in the recorded run
+// Vehicle is simulated from recorded actuators only, its pose is restored from keyframe only when replay is seeked
+class SimulatedReplayPlayer final
+{
+public:
+
+	SimulatedReplayPlayer() :
+		m_replay(nullptr),
+		m_world(nullptr),
+		m_vehicle(nullptr),
+		m_step(0),
+		m_tick(0),
+		m_offset(0),
+		m_actuators({})
+	{
+	}
+
+	~SimulatedReplayPlayer()
+	{
+	}
+
+	// Starts replay from the beginning, world has to contain map and vehicle created from prototypes of recorded run
+	void Start(const SimulatedReplay* replay, const SimulatedReplayRecorder::Settings& settings, SimulatedWorld* world, SimulatedVehicle* vehicle);
+
+	// Stops replay, world and vehicle are not used anymore
+	void Stop();
+
+	// Returns true if replay is started
+	inline bool IsStarted() const
+	{
+		return m_replay != nullptr;
+	}
+
+	// Performs specified number of physics steps, returns false when replay has ended
+	bool Step(size_t numberOfSteps);
+
+	// Moves replay to the keyframe and restores vehicle pose from it
+	void Seek(size_t keyframeIndex);
+
+	// Returns index of the last keyframe that is not after current tick
+	inline size_t GetKeyframeIndex() const
+	{
+		return m_replay ? m_tick / m_replay->GetKeyframeInterval() : 0;
+	}
+
+	// Returns number of keyframes
+	inline size_t GetNumberOfKeyframes() const
+	{
+		return m_replay ? m_replay->GetKeyframes().size() : 0;
+	}
+
+	// Returns number of played ticks
+	inline size_t GetTick() const
+	{
+		return m_tick;
+	}
+
+	// Returns number of recorded ticks
+	inline size_t GetNumberOfTicks() const
+	{
+		return m_replay ? m_replay->GetNumberOfTicks() : 0;
+	}
+
+private:
+
+	const SimulatedReplay* m_replay;
+	SimulatedReplayRecorder::Settings m_settings;
+	SimulatedWorld* m_world;
+	SimulatedVehicle* m_vehicle;
+	size_t m_step; // Physics steps since the beginning of replay
+	size_t m_tick; // Controller ticks since the beginning of replay
+	size_t m_offset; // Offset of the next tick in encoded actuators
+	SimulatedReplay::Actuators m_actuators;
+};
@@ -0,0 +1,178 @@
+#include "SimulatedSensors.hpp"
+#include "VehicleBuilder.hpp"
+#include "JobSystem.hpp"
+#include "CoreProfiler.hpp"
+#include <Box2D\box2d.h>
+
+SimulatedSensors::SimulatedSensors()
+{
+}
+
+SimulatedSensors::~SimulatedSensors()
+{
+}
+
+size_t SimulatedSensors::AddVehicle(const std::vector<sf::Vector2f>& sensorPoints,
+									const std::vector<double>& beamAngles,
+									const std::vector<PeriodicTimer>& motionRanges,
+									b2Vec2 position,
+									float angle)
+{
+	const size_t index = m_positionX.size();
+	m_positionX.push_back(position.x);
+	m_positionY.push_back(position.y);
+	m_angle.push_back(angle);
+	m_cosinus.push_back(std::cos(angle));
+	m_sinus.push_back(std::sin(angle));
+	m_firstSensors.push_back(m_offsetX.size());
+	m_numberOfSensors.push_back(sensorPoints.size());
+
+	for (size_t i = 0; i < sensorPoints.size(); ++i)
+	{
+		// Converts positions to Box2D units and deegres values to radians values
+		const b2Vec2 offset = MathContext::ToBox2DPosition(sensorPoints[i]);
+		m_vehicleIndexes.push_back(index);
+		m_offsetX.push_back(offset.x);
+		m_offsetY.push_back(offset.y);
+		m_beamAngle.push_back(float(MathContext::ToRadians(beamAngles[i])));
+		m_motionValue.push_back(float(MathContext::ToRadians(motionRanges[i].GetValue())));
+		m_motionDirection.push_back(1.f);
+		m_motionTimeout.push_back(float(MathContext::ToRadians(motionRanges[i].GetTimeout())));
+		m_motionMultiplier.push_back(float(MathContext::ToRadians(motionRanges[i].GetMultiplier())));
+		m_directionX.push_back(std::cos(m_beamAngle.back() + m_motionValue.back()));
+		m_directionY.push_back(std::sin(m_beamAngle.back() + m_motionValue.back()));
+		m_originX.push_back(0.f);
+		m_originY.push_back(0.f);
+		m_endX.push_back(0.f);
+		m_endY.push_back(0.f);
+		m_fractions.push_back(1.f);
+	}
+
+	// Calculate initial beams poses so that vehicle can be drawn before the first update
+	CalculatePoses(0.f);
+	return index;
+}
+
+void SimulatedSensors::Update(b2World* edgesWorld, double timeStep)
+{
+	CalculatePoses(float(timeStep));
+	CastBeams(edgesWorld);
+}
+
+void SimulatedSensors::SaveState(size_t index, SimulatedState& state) const
+{
+	state.Write(m_positionX[index]);
+	state.Write(m_positionY[index]);
+	state.Write(m_angle[index]);
+	state.Write(m_cosinus[index]);
+	state.Write(m_sinus[index]);
+
+	const size_t firstSensor = m_firstSensors[index];
+	const size_t numberOfSensors = m_numberOfSensors[index];
+	state.Write(&m_motionValue[firstSensor], numberOfSensors);
+	state.Write(&m_motionDirection[firstSensor], numberOfSensors);
+	state.Write(&m_directionX[firstSensor], numberOfSensors);
+	state.Write(&m_directionY[firstSensor], numberOfSensors);
+	state.Write(&m_originX[firstSensor], numberOfSensors);
+	state.Write(&m_originY[firstSensor], numberOfSensors);
+	state.Write(&m_endX[firstSensor], numberOfSensors);
+	state.Write(&m_endY[firstSensor], numberOfSensors);
+	state.Write(&m_fractions[firstSensor], numberOfSensors);
+}
+
+bool SimulatedSensors::RestoreState(size_t index, SimulatedState& state)
+{
+	const size_t firstSensor = m_firstSensors[index];
+	const size_t numberOfSensors = m_numberOfSensors[index];
+	return state.Read(m_positionX[index]) &&
+		state.Read(m_positionY[index]) &&
+		state.Read(m_angle[index]) &&
+		state.Read(m_cosinus[index]) &&
+		state.Read(m_sinus[index]) &&
+		state.Read(&m_motionValue[firstSensor], numberOfSensors) &&
+		state.Read(&m_motionDirection[firstSensor], numberOfSensors) &&
+		state.Read(&m_directionX[firstSensor], numberOfSensors) &&
+		state.Read(&m_directionY[firstSensor], numberOfSensors) &&
+		state.Read(&m_originX[firstSensor], numberOfSensors) &&
+		state.Read(&m_originY[firstSensor], numberOfSensors) &&
+		state.Read(&m_endX[firstSensor], numberOfSensors) &&
+		state.Read(&m_endY[firstSensor], numberOfSensors) &&
+		state.Read(&m_fractions[firstSensor], numberOfSensors);
+}
+
+void SimulatedSensors::CalculatePoses(float timeStep)
+{
+	const float beamLength = MathContext::ToBox2DPosition(sf::Vector2f(float(VehicleBuilder::GetDefaultBeamLength()), 0.f)).x;
+
+	// Vehicles rotations
+	const size_t numberOfVehicles = m_angle.size();
+	const float* angle = m_angle.data();
+	float* cosinus = m_cosinus.data();
+	float* sinus = m_sinus.data();
+	for (size_t i = 0; i < numberOfVehicles; ++i)
+	{
+		cosinus[i] = std::cos(angle[i]);
+		sinus[i] = std::sin(angle[i]);
+	}
+
+	// Beams directions in vehicle space, only beams with motion range change their direction
+	const size_t numberOfSensors = m_offsetX.size();
+	const float* beamAngle = m_beamAngle.data();
+	const float* motionTimeout = m_motionTimeout.data();
+	const float* motionMultiplier = m_motionMultiplier.data();
+	float* motionValue = m_motionValue.data();
+	float* motionDirection = m_motionDirection.data();
+	float* directionX = m_directionX.data();
+	float* directionY = m_directionY.data();
+	for (size_t i = 0; i < numberOfSensors; ++i)
+	{
+		if (motionMultiplier[i] == 0.f)
+			continue;
+
+		// Update motion range, works the same way as periodic timer
+		const float value = motionValue[i] + timeStep * motionMultiplier[i] * motionDirection[i];
+		const bool timeout = value * motionDirection[i] > motionTimeout[i];
+		motionValue[i] = timeout ? motionTimeout[i] * motionDirection[i] : value;
+		motionDirection[i] = timeout ? -motionDirection[i] : motionDirection[i];
+		directionX[i] = std::cos(beamAngle[i] + motionValue[i]);
+		directionY[i] = std::sin(beamAngle[i] + motionValue[i]);
+	}
+
+	// Sensors poses, vehicle rotation is applied to offsets and directions without trigonometric functions
+	// so that the loop has only arithmetic and no dependencies between iterations
+	const size_t* vehicleIndexes = m_vehicleIndexes.data();
+	const float* positionX = m_positionX.data();
+	const float* positionY = m_positionY.data();
+	const float* offsetX = m_offsetX.data();
+	const float* offsetY = m_offsetY.data();
+	float* originX = m_originX.data();
+	float* originY = m_originY.data();
+	float* endX = m_endX.data();
+	float* endY = m_endY.data();
+	for (size_t i = 0; i < numberOfSensors; ++i)
+	{
+		const size_t vehicle = vehicleIndexes[i];
+		const float vehicleCosinus = cosinus[vehicle];
+		const float vehicleSinus = sinus[vehicle];
+		originX[i] = positionX[vehicle] + offsetX[i] * vehicleCosinus - offsetY[i] * vehicleSinus;
+		originY[i] = positionY[vehicle] + offsetX[i] * vehicleSinus + offsetY[i] * vehicleCosinus;
+		endX[i] = originX[i] + beamLength * (directionX[i] * vehicleCosinus - directionY[i] * vehicleSinus);
+		endY[i] = originY[i] + beamLength * (directionX[i] * vehicleSinus + directionY[i] * vehicleCosinus);
+	}
+}
+
+void SimulatedSensors::CastBeams(b2World* edgesWorld)
+{
+	// Edges world is only read here so that shards can cast beams at the same time, every shard has its own callback
+	const size_t numberOfSensors = m_offsetX.size();
+	JobSystem::GetInstance().ParallelFor(0, numberOfSensors, m_sensorsPerShard, [&](size_t begin, size_t end) {
+		PROFILE_ZONE("SimulatedSensors::CastBeams");
+		BeamRaycastCallback beamRaycastCallback;
+		for (size_t i = begin; i < end; ++i)
+		{
+			beamRaycastCallback.Reset();
+			edgesWorld->RayCast(&beamRaycastCallback, b2Vec2(m_originX[i], m_originY[i]), b2Vec2(m_endX[i], m_endY[i]));
+			m_fractions[i] = beamRaycastCallback.GetFraction();
+		}
+	});
+}
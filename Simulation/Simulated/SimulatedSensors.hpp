@@ -0,0 +1,155 @@
+#pragma once
+#include "MathContext.hpp"
+#include "PeriodicTimer.hpp"
+#include "Neural.hpp"
+#include "SimulatedState.hpp"
+#include <Box2D\b2_world_callbacks.h>
+
+class b2World;
+
+// Sensors of all vehicles kept in struct of arrays layout
+// Beams poses of all sensors are calculated in one batched loop, drawable data is not touched here
+class SimulatedSensors final
+{
+public:
+
+	SimulatedSensors();
+
+	~SimulatedSensors();
+
+	// Adds sensors of one vehicle, sensor points are relative to the center and angles are in degrees
+	// Returns vehicle index
+	size_t AddVehicle(const std::vector<sf::Vector2f>& sensorPoints,
+					  const std::vector<double>& beamAngles,
+					  const std::vector<PeriodicTimer>& motionRanges,
+					  b2Vec2 position,
+					  float angle);
+
+	// Sets vehicle position and angle that will be used in the next update
+	inline void SetPose(size_t index, b2Vec2 position, float angle)
+	{
+		m_positionX[index] = position.x;
+		m_positionY[index] = position.y;
+		m_angle[index] = angle;
+	}
+
+	// Moves motion ranges by time step, calculates beams poses and casts beams against edges
+	void Update(b2World* edgesWorld, double timeStep);
+
+	// Returns number of vehicles
+	inline size_t GetNumberOfVehicles() const
+	{
+		return m_positionX.size();
+	}
+
+	// Returns index of the first sensor of vehicle
+	inline size_t GetFirstSensor(size_t index) const
+	{
+		return m_firstSensors[index];
+	}
+
+	// Returns number of sensors of vehicle
+	inline size_t GetNumberOfSensors(size_t index) const
+	{
+		return m_numberOfSensors[index];
+	}
+
+	// Returns beam origin of specified sensor
+	inline b2Vec2 GetBeamOrigin(size_t sensor) const
+	{
+		return b2Vec2(m_originX[sensor], m_originY[sensor]);
+	}
+
+	// Returns beam end of specified sensor, if beam hit an edge then hit point is returned
+	inline b2Vec2 GetBeamEnd(size_t sensor) const
+	{
+		const float fraction = m_fractions[sensor];
+		return b2Vec2(m_originX[sensor] + (m_endX[sensor] - m_originX[sensor]) * fraction,
+					  m_originY[sensor] + (m_endY[sensor] - m_originY[sensor]) * fraction);
+	}
+
+	// Appends pose, motion ranges phases and beams of vehicle sensors to the state
+	void SaveState(size_t index, SimulatedState& state) const;
+
+	// Restores pose, motion ranges phases and beams of vehicle sensors, returns false if state is incomplete
+	bool RestoreState(size_t index, SimulatedState& state);
+
+	// Copies vehicle sensors values into layer
+	inline void GetValues(size_t index, NeuronLayer& layer) const
+	{
+		const size_t firstSensor = m_firstSensors[index];
+		for (size_t i = 0; i < m_numberOfSensors[index]; ++i)
+			layer[i] = Neuron(m_fractions[firstSensor + i]);
+	}
+
+private:
+
+	// Moves motion ranges and calculates beams origins and ends of all sensors
+	void CalculatePoses(float timeStep);
+
+	// Casts beams of all sensors against edges, shards of sensors are cast in parallel
+	void CastBeams(b2World* edgesWorld);
+
+	// Vehicles poses
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_angle;
+	std::vector<float> m_cosinus;
+	std::vector<float> m_sinus;
+	std::vector<size_t> m_firstSensors;
+	std::vector<size_t> m_numberOfSensors;
+
+	// Sensors data, sensors of one vehicle are stored one after another
+	std::vector<size_t> m_vehicleIndexes;
+	std::vector<float> m_offsetX;
+	std::vector<float> m_offsetY;
+	std::vector<float> m_beamAngle;
+	std::vector<float> m_motionValue;
+	std::vector<float> m_motionDirection;
+	std::vector<float> m_motionTimeout;
+	std::vector<float> m_motionMultiplier;
+	std::vector<float> m_directionX; // Beam direction in vehicle space
+	std::vector<float> m_directionY;
+
+	// Sensors output
+	std::vector<float> m_originX;
+	std::vector<float> m_originY;
+	std::vector<float> m_endX;
+	std::vector<float> m_endY;
+	std::vector<float> m_fractions; // Beam fraction at which the closest edge was hit, sensor value
+
+	// Number of sensors cast by one job
+	inline static const size_t m_sensorsPerShard = 64;
+
+	// Raycast callback, keeps the closest hit fraction
+	class BeamRaycastCallback :
+		public b2RayCastCallback
+	{
+		float m_fraction;
+
+	public:
+
+		BeamRaycastCallback() :
+			m_fraction(1.f)
+		{
+		}
+
+		// Resets fraction to the max value, beam that hit nothing has the max sensor value
+		inline void Reset()
+		{
+			m_fraction = 1.f;
+		}
+
+		// Returns the closest hit fraction
+		inline float GetFraction() const
+		{
+			return m_fraction;
+		}
+
+		float ReportFixture(b2Fixture*, const b2Vec2&, const b2Vec2&, float fraction)
+		{
+			m_fraction = fraction;
+			return fraction;
+		}
+	};
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include "MathContext.hpp"
+#include <vector>
+
+// Immutable picture of simulation published by simulation thread and drawn by render thread
+// Vectors are cleared but not shrunk so that filling snapshot does not allocate after first frames
+class SimulatedSnapshot final
+{
+public:
+
+	SimulatedSnapshot() :
+		m_leaderIndex(0),
+		m_finished(false)
+	{
+	}
+
+	~SimulatedSnapshot()
+	{
+	}
+
+	// Removes vehicles, values are kept
+	inline void Clear()
+	{
+		m_vehicles.clear();
+		m_bodyPoints.clear();
+		m_beamOrigins.clear();
+		m_beamEnds.clear();
+		m_leaderIndex = 0;
+		m_finished = false;
+	}
+
+	// Adds vehicle, body points and beams added afterwards belong to this vehicle
+	inline void AddVehicle(const sf::Vector2f& center, float mass, bool active, bool leader)
+	{
+		m_vehicles.push_back({ center, mass, active, leader, m_bodyPoints.size(), 0, m_beamOrigins.size(), 0 });
+	}
+
+	// Adds body point to the last vehicle
+	inline void AddBodyPoint(const sf::Vector2f& point)
+	{
+		m_bodyPoints.push_back(point);
+		++m_vehicles.back().m_numberOfBodyPoints;
+	}
+
+	// Adds beam to the last vehicle
+	inline void AddBeam(const sf::Vector2f& origin, const sf::Vector2f& end)
+	{
+		m_beamOrigins.push_back(origin);
+		m_beamEnds.push_back(end);
+		++m_vehicles.back().m_numberOfBeams;
+	}
+
+	// Returns number of vehicles
+	inline size_t GetNumberOfVehicles() const
+	{
+		return m_vehicles.size();
+	}
+
+	// Returns vehicle center
+	inline const sf::Vector2f& GetCenter(size_t index) const
+	{
+		return m_vehicles[index].m_center;
+	}
+
+	// Returns vehicle mass
+	inline float GetMass(size_t index) const
+	{
+		return m_vehicles[index].m_mass;
+	}
+
+	// Returns true if vehicle is active
+	inline bool IsActive(size_t index) const
+	{
+		return m_vehicles[index].m_active;
+	}
+
+	// Returns true if vehicle is leader
+	inline bool IsLeader(size_t index) const
+	{
+		return m_vehicles[index].m_leader;
+	}
+
+	// Returns vehicle body points
+	inline const sf::Vector2f* GetBodyPoints(size_t index) const
+	{
+		return m_bodyPoints.data() + m_vehicles[index].m_firstBodyPoint;
+	}
+
+	// Returns number of vehicle body points
+	inline size_t GetNumberOfBodyPoints(size_t index) const
+	{
+		return m_vehicles[index].m_numberOfBodyPoints;
+	}
+
+	// Returns vehicle beams origins
+	inline const sf::Vector2f* GetBeamOrigins(size_t index) const
+	{
+		return m_beamOrigins.data() + m_vehicles[index].m_firstBeam;
+	}
+
+	// Returns vehicle beams ends
+	inline const sf::Vector2f* GetBeamEnds(size_t index) const
+	{
+		return m_beamEnds.data() + m_vehicles[index].m_firstBeam;
+	}
+
+	// Returns number of vehicle beams
+	inline size_t GetNumberOfBeams(size_t index) const
+	{
+		return m_vehicles[index].m_numberOfBeams;
+	}
+
+	// Sets leader index
+	inline void SetLeaderIndex(size_t leaderIndex)
+	{
+		m_leaderIndex = leaderIndex;
+	}
+
+	// Returns leader index
+	inline size_t GetLeaderIndex() const
+	{
+		return m_leaderIndex;
+	}
+
+	// Sets value shown in the interface, meaning of the index is defined by the state
+	inline void SetValue(size_t index, double value)
+	{
+		if (index >= m_values.size())
+			m_values.resize(index + 1, 0.0);
+		m_values[index] = value;
+	}
+
+	// Returns value shown in the interface, zero is returned if value was not set
+	inline double GetValue(size_t index) const
+	{
+		return index < m_values.size() ? m_values[index] : 0.0;
+	}
+
+	// Returns number of values
+	inline size_t GetNumberOfValues() const
+	{
+		return m_values.size();
+	}
+
+	// Marks snapshot as the last one of simulation
+	inline void SetFinished(bool finished)
+	{
+		m_finished = finished;
+	}
+
+	// Returns true if this is the last snapshot of simulation
+	inline bool IsFinished() const
+	{
+		return m_finished;
+	}
+
+private:
+
+	struct VehicleSnapshot
+	{
+		sf::Vector2f m_center;
+		float m_mass;
+		bool m_active;
+		bool m_leader;
+		size_t m_firstBodyPoint;
+		size_t m_numberOfBodyPoints;
+		size_t m_firstBeam;
+		size_t m_numberOfBeams;
+	};
+
+	std::vector<VehicleSnapshot> m_vehicles;
+	std::vector<sf::Vector2f> m_bodyPoints;
+	std::vector<sf::Vector2f> m_beamOrigins;
+	std::vector<sf::Vector2f> m_beamEnds;
+	std::vector<double> m_values;
+	size_t m_leaderIndex;
+	bool m_finished;
+};
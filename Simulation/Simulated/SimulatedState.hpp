@@ -0,0 +1,98 @@
+#pragma once
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// In-memory blob with simulation state captured in the middle of a run
+// Values are stored in native byte order without any padding, blob is meant to be restored by the same process
+// Many worlds can be restored from one blob, so that candidates can be forked from a shared state
+class SimulatedState final
+{
+public:
+
+	SimulatedState() :
+		m_readOffset(0)
+	{
+	}
+
+	~SimulatedState()
+	{
+	}
+
+	// Removes all values, capacity is kept so that capturing again does not allocate
+	inline void Clear()
+	{
+		m_data.clear();
+		m_readOffset = 0;
+	}
+
+	// Moves read offset to the beginning so that blob can be restored again
+	inline void Rewind()
+	{
+		m_readOffset = 0;
+	}
+
+	// Appends single value
+	template<class Type>
+	inline void Write(const Type& value)
+	{
+		Write(&value, 1);
+	}
+
+	// Appends array of values
+	template<class Type>
+	inline void Write(const Type* data, size_t count)
+	{
+		static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable types can be stored in simulated state");
+		const size_t size = sizeof(Type) * count;
+		const size_t offset = m_data.size();
+		m_data.resize(offset + size);
+		if (size)
+			std::memcpy(m_data.data() + offset, data, size);
+	}
+
+	// Reads single value, returns false if there is not enough data
+	template<class Type>
+	inline bool Read(Type& value)
+	{
+		return Read(&value, 1);
+	}
+
+	// Reads array of values, returns false if there is not enough data
+	template<class Type>
+	inline bool Read(Type* data, size_t count)
+	{
+		static_assert(std::is_trivially_copyable<Type>::value, "Only trivially copyable types can be stored in simulated state");
+		const size_t size = sizeof(Type) * count;
+		if (size > m_data.size() - m_readOffset)
+			return false;
+
+		if (size)
+			std::memcpy(data, m_data.data() + m_readOffset, size);
+		m_readOffset += size;
+		return true;
+	}
+
+	// Returns true if all values were read
+	inline bool IsAtEnd() const
+	{
+		return m_readOffset == m_data.size();
+	}
+
+	// Returns size of blob in bytes
+	inline size_t GetSize() const
+	{
+		return m_data.size();
+	}
+
+	// Returns blob data
+	inline const std::vector<char>& GetData() const
+	{
+		return m_data;
+	}
+
+private:
+
+	std::vector<char> m_data;
+	size_t m_readOffset;
+};
@@ -1,93 +1,82 @@
 #pragma once
 #include "SimulatedAbstract.hpp"
 #include "FitnessInterface.hpp"
-#include "DrawableVehicle.hpp"
+#include "DrawableVehicleBatch.hpp"
 #include "PeriodicTimer.hpp"
 #include "ArtificialNeuralNetworkBuilder.hpp"
+#include "KinematicVehicleModel.hpp"
+#include "SimulatedSensors.hpp"
+#include "SimulatedSnapshot.hpp"
+#include "CoreProfiler.hpp"
 #include <Box2D\Box2D.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Position, angle and velocities of vehicle body
+struct SimulatedVehiclePose
+{
+	float m_positionX;
+	float m_positionY;
+	float m_angle;
+	float m_velocityX;
+	float m_velocityY;
+	float m_angularVelocity;
+};
 
 class SimulatedVehicle final :
 	public SimulatedAbstract,
-	public FitnessInterface,
-	public DrawableVehicle
+	public FitnessInterface
 {
 public:
 
-	SimulatedVehicle(const size_t numberOfBodyPoints,
-					 const std::vector<sf::Vector2f>& sensorPoints,
-					 const std::vector<double>& beamAngles,
-					 const std::vector<PeriodicTimer>& motionRanges) :
+	SimulatedVehicle(const size_t numberOfBodyPoints, const size_t numberOfSensors) :
 		SimulatedAbstract(SimulatedAbstract::CategoryVehicle),
 		FitnessInterface(),
-		DrawableVehicle(numberOfBodyPoints, sensorPoints.size()),
 		m_body(nullptr),
+		m_kinematicModel(nullptr),
+		m_kinematicIndex(0),
 		m_numberOfBodyPoints(numberOfBodyPoints),
 		m_bodyPoints(nullptr),
-		m_sensorPoints(sensorPoints),
-		m_beamAngles(beamAngles),
-		m_sensors(sensorPoints.size(), ArtificialNeuralNetworkBuilder::GetMaxNeuronValue()),
-		m_active(true)
+		m_simulatedSensors(nullptr),
+		m_sensorsIndex(0),
+		m_sensors(numberOfSensors, ArtificialNeuralNetworkBuilder::GetMaxNeuronValue()),
+		m_mass(0.f),
+		m_active(true),
+		m_leader(false)
 	{
-		// Converts beam deegres angle to radians angles
-		for (auto& beamAngle : m_beamAngles)
-			beamAngle = MathContext::ToRadians(beamAngle);
-
-		// Converts motion ranges deegres values to radians values
-		for (auto& motionRange : motionRanges)
-		{
-			m_motionRanges.push_back(PeriodicTimer(MathContext::ToRadians(motionRange.GetValue()),
-												   MathContext::ToRadians(motionRange.GetTimeout()),
-												   MathContext::ToRadians(motionRange.GetMultiplier())));
-		}
-		m_motionRanges.shrink_to_fit();
+		ResetActuators();
 	}
 
 	~SimulatedVehicle()
 	{
 	}
 
-	// Updates friction
-	inline void Update(b2World* world)
+	// Passes current pose to the sensors, beams are calculated later for all vehicles at once
+	inline void UpdateSensorsPose()
 	{
-		// Update body data
-		for (size_t i = 0; i < m_numberOfBodyPoints; ++i)
-		{
-			const auto bodyPoint = m_body->GetWorldPoint(m_bodyPoints[i]);
-			m_bodyShape.setPoint(i, MathContext::ToSFMLPosition(bodyPoint));
-		}
+		m_simulatedSensors->SetPose(m_sensorsIndex, GetWorldCenter(), GetAngle());
+	}
+
+	// Reads sensors values calculated in the last sensors update
+	inline void UpdateSensors()
+	{
+		m_simulatedSensors->GetValues(m_sensorsIndex, m_sensors);
+	}
 
-		// Update sensor data
-		const float radians = m_body->GetAngle();
-		const sf::Vector2f center = MathContext::ToSFMLPosition(m_body->GetWorldCenter());
-		const float cosinus = float(cos(radians));
-		const float sinus = float(sin(radians));
-		for (size_t i = 0; i < m_sensorPoints.size(); ++i)
+	// Applies friction and held actuator values for the duration of specified time step
+	inline void Update(float timeStep)
+	{
+		PROFILE_ZONE("SimulatedVehicle::Update");
+		if (m_kinematicModel)
 		{
-			// Set sensor max value
-			m_sensors[i] = ArtificialNeuralNetworkBuilder::GetMaxNeuronValue();
-
-			// Update motion range
-			m_motionRanges[i].Update();
-
-			// Calculate sensor position
-			m_beams[i][0].position = sf::Vector2f((m_sensorPoints[i].x * cosinus - m_sensorPoints[i].y * sinus),
-												  (m_sensorPoints[i].x * sinus + m_sensorPoints[i].y * cosinus));
-			m_beams[i][0].position += center;
-
-			// Calculate beam end position
-			const auto cosBeam = cos(radians + m_beamAngles[i] + m_motionRanges[i].GetValue());
-			const auto sinBeam = sin(radians + m_beamAngles[i] + m_motionRanges[i].GetValue());
-			m_beams[i][1].position.x = static_cast<float>(m_beams[i][0].position.x + VehicleBuilder::GetDefaultBeamLength() * cosBeam);
-			m_beams[i][1].position.y = static_cast<float>(m_beams[i][0].position.y + VehicleBuilder::GetDefaultBeamLength() * sinBeam);
-
-			// Raycast
-			const b2Vec2 startPoint = MathContext::ToBox2DPosition(m_beams[i][0].position);
-			const b2Vec2 endPoint = MathContext::ToBox2DPosition(m_beams[i][1].position);
-			world->RayCast(&m_beamRaycastCallbacks[i], startPoint, endPoint);
+			// Kinematic model steps all vehicles at once, here only actuators are passed
+			m_kinematicModel->SetActuators(m_kinematicIndex, m_driveForward, m_driveBackward, m_turn);
+			return;
 		}
 
 		// Lateral linear velocity
-		const float elapsedTime = float(CoreWindow::GetElapsedTime());
 		b2Vec2 impulse = m_body->GetMass() * -GetLateralVelocity();
 		const auto impulseLength = impulse.Length();
 		if (impulseLength > m_maxLateralImpulse)
@@ -95,54 +84,212 @@ public:
 			auto factor = m_maxLateralImpulse / impulseLength;
 			impulse *= factor;
 		}
-		impulse *= 35 * elapsedTime;
+		impulse *= 35 * timeStep;
 		m_body->ApplyLinearImpulse(impulse, m_body->GetWorldCenter(), true);
 
 		// Angular velocity
-		m_body->ApplyAngularImpulse(10.f * m_body->GetInertia() * elapsedTime * -m_body->GetAngularVelocity(), true);
+		m_body->ApplyAngularImpulse(10.f * m_body->GetInertia() * timeStep * -m_body->GetAngularVelocity(), true);
 
 		// Forward linear velocity
 		b2Vec2 currentForwardNormal = GetForwardVelocity();
 		const float currentForwardSpeed = currentForwardNormal.Normalize();
-		const float dragForceMagnitude = -2000 * currentForwardSpeed * elapsedTime;
+		const float dragForceMagnitude = float(-2000 * currentForwardSpeed * m_forceTimeStep);
 		m_body->ApplyForce(dragForceMagnitude * currentForwardNormal, m_body->GetWorldCenter(), true);
-	}
 
-	// Applies forward drive force by specified value (0; 1)
-	inline void DriveForward(Neuron value)
-	{
 		// Find current speed in forward direction
-		const b2Vec2 currentForwardNormal = m_body->GetWorldVector(b2Vec2(1, 0));
-		const float currentSpeed = b2Dot(GetForwardVelocity(), currentForwardNormal);
+		const b2Vec2 forwardNormal = m_body->GetWorldVector(b2Vec2(1, 0));
+		const float currentSpeed = b2Dot(GetForwardVelocity(), forwardNormal);
+
+		// Apply forward drive force
 		if (currentSpeed < m_maxForwardSpeed)
 		{
-			// Apply necessary force
-			value *= m_maxDriveForce * CoreWindow::GetElapsedTime();
-			m_body->ApplyForce(float(value) * currentForwardNormal, m_body->GetWorldCenter(), true);
+			const double force = m_driveForward * m_maxDriveForce * m_forceTimeStep;
+			m_body->ApplyForce(float(force) * forwardNormal, m_body->GetWorldCenter(), true);
+		}
+
+		// Apply backward drive force
+		if (currentSpeed > m_maxBackwardSpeed)
+		{
+			const double force = m_driveBackward * -m_maxDriveForce * m_forceTimeStep;
+			m_body->ApplyForce(float(force) * forwardNormal, m_body->GetWorldCenter(), true);
 		}
+
+		// Apply turn torque
+		const double torque = (m_turn * 2.0 - 1.0) * m_maxTorqueForce * m_forceTimeStep;
+		m_body->ApplyTorque(float(torque), true);
 	}
 
-	// Applies backward drive force by specified value (0; 1)
+	// Sets forward drive actuator value (0; 1), value is held until it is changed
+	inline void DriveForward(Neuron value)
+	{
+		m_driveForward = value;
+	}
+
+	// Sets backward drive actuator value (0; 1), value is held until it is changed
 	inline void DriveBackward(Neuron value)
 	{
-		// Find current speed in forward direction
-		const b2Vec2 currentForwardNormal = m_body->GetWorldVector(b2Vec2(1, 0));
-		const float currentSpeed = b2Dot(GetForwardVelocity(), currentForwardNormal);
-		if (currentSpeed > m_maxBackwardSpeed)
+		m_driveBackward = value;
+	}
+
+	// Sets turn actuator value (0; 1), value is held until it is changed
+	inline void Turn(Neuron value)
+	{
+		m_turn = value;
+	}
+
+	// Resets actuators so that no drive force nor torque is applied
+	inline void ResetActuators()
+	{
+		m_driveForward = 0.0;
+		m_driveBackward = 0.0;
+		m_turn = VehicleBuilder::GetDefaultTorque();
+	}
+
+	// Returns actuators values in fixed point representation
+	inline std::array<int32_t, 3> GetQuantizedActuators() const
+	{
+		return { QuantizeActuator(m_driveForward), QuantizeActuator(m_driveBackward), QuantizeActuator(m_turn) };
+	}
+
+	// Sets actuators values from fixed point representation
+	inline void SetQuantizedActuators(const std::array<int32_t, 3>& actuators)
+	{
+		DriveForward(DequantizeActuator(actuators[0]));
+		DriveBackward(DequantizeActuator(actuators[1]));
+		Turn(DequantizeActuator(actuators[2]));
+	}
+
+	// Returns actuator value in fixed point representation
+	inline static int32_t QuantizeActuator(Neuron value)
+	{
+		if (std::isnan(value))
+			return 0;
+		const double limit = double(INT32_MAX);
+		return int32_t(std::clamp(std::round(double(value) * m_actuatorPrecision), -limit, limit));
+	}
+
+	// Returns actuator value from fixed point representation
+	inline static Neuron DequantizeActuator(int32_t value)
+	{
+		return Neuron(double(value) / m_actuatorPrecision);
+	}
+
+	// Returns position, angle and velocities of vehicle body
+	inline SimulatedVehiclePose GetPose() const
+	{
+		if (m_kinematicModel)
 		{
-			// Apply necessary force
-			value *= -m_maxDriveForce * CoreWindow::GetElapsedTime();
-			m_body->ApplyForce(float(value) * currentForwardNormal, m_body->GetWorldCenter(), true);
+			const b2Vec2 position = m_kinematicModel->GetPosition(m_kinematicIndex);
+			const b2Vec2 velocity = m_kinematicModel->GetVelocity(m_kinematicIndex);
+			return { position.x, position.y, m_kinematicModel->GetAngle(m_kinematicIndex), velocity.x, velocity.y, m_kinematicModel->GetAngularVelocity(m_kinematicIndex) };
 		}
+
+		const b2Vec2& position = m_body->GetPosition();
+		const b2Vec2& velocity = m_body->GetLinearVelocity();
+		return { position.x, position.y, m_body->GetAngle(), velocity.x, velocity.y, m_body->GetAngularVelocity() };
 	}
 
-	// Applies turn force by specified value (0; 1)
-	inline void Turn(Neuron value)
+	// Sets position, angle and velocities of vehicle body
+	inline void SetPose(const SimulatedVehiclePose& pose)
+	{
+		const b2Vec2 position(pose.m_positionX, pose.m_positionY);
+		const b2Vec2 velocity(pose.m_velocityX, pose.m_velocityY);
+		if (m_kinematicModel)
+		{
+			m_kinematicModel->SetState(m_kinematicIndex, position, pose.m_angle, velocity, pose.m_angularVelocity);
+			return;
+		}
+
+		m_body->SetTransform(position, pose.m_angle);
+		m_body->SetLinearVelocity(velocity);
+		m_body->SetAngularVelocity(pose.m_angularVelocity);
+	}
+
+	// Appends pose, actuators, fitness, active flag and sensors to the state
+	inline void SaveState(SimulatedState& state) const
+	{
+		state.Write(GetPose());
+		state.Write(m_driveForward);
+		state.Write(m_driveBackward);
+		state.Write(m_turn);
+		state.Write(GetFitness());
+		state.Write(m_active);
+		state.Write(m_sensors.data(), m_sensors.size());
+		m_simulatedSensors->SaveState(m_sensorsIndex, state);
+	}
+
+	// Restores state saved by this or other vehicle created from the same prototype, returns false if state is incomplete
+	inline bool RestoreState(SimulatedState& state)
 	{
-		value *= 2.0;
-		value -= 1.0;
-		value *= m_maxTorqueForce * CoreWindow::GetElapsedTime();
-		m_body->ApplyTorque(float(value), true);
+		SimulatedVehiclePose pose;
+		Fitness fitness = 0.0;
+		if (!state.Read(pose) ||
+			!state.Read(m_driveForward) ||
+			!state.Read(m_driveBackward) ||
+			!state.Read(m_turn) ||
+			!state.Read(fitness) ||
+			!state.Read(m_active) ||
+			!state.Read(m_sensors.data(), m_sensors.size()))
+			return false;
+
+		SetPose(pose);
+		SetFitness(fitness);
+		return m_simulatedSensors->RestoreState(m_sensorsIndex, state);
+	}
+
+	// Adds vehicle to the batch with level of detail selected by the batch
+	inline void Draw(DrawableVehicleBatch& batch, size_t detail) const
+	{
+		if (detail == DrawableVehicleBatch::POINT_DETAIL)
+		{
+			batch.AddPoint(GetCenter(), m_mass, m_leader);
+			return;
+		}
+
+		const b2Vec2* bodyPoints = m_kinematicModel ? m_kinematicModel->GetBodyPoints(m_kinematicIndex) : m_bodyPoints;
+		sf::Vector2f points[b2_maxPolygonVertices];
+		for (size_t i = 0; i < m_numberOfBodyPoints; ++i)
+			points[i] = MathContext::ToSFMLPosition(GetWorldPoint(bodyPoints[i]));
+		batch.AddBody(points, m_numberOfBodyPoints, m_mass, m_leader);
+		if (detail == DrawableVehicleBatch::BODY_DETAIL)
+			return;
+
+		const size_t firstSensor = m_simulatedSensors->GetFirstSensor(m_sensorsIndex);
+		for (size_t i = 0; i < m_sensors.size(); ++i)
+		{
+			batch.AddBeam(MathContext::ToSFMLPosition(m_simulatedSensors->GetBeamOrigin(firstSensor + i)),
+						  MathContext::ToSFMLPosition(m_simulatedSensors->GetBeamEnd(firstSensor + i)),
+						  m_active);
+		}
+	}
+
+	// Adds vehicle body points, beams and flags to the snapshot
+	inline void Capture(SimulatedSnapshot& snapshot) const
+	{
+		snapshot.AddVehicle(GetCenter(), m_mass, m_active, m_leader);
+
+		const b2Vec2* bodyPoints = m_kinematicModel ? m_kinematicModel->GetBodyPoints(m_kinematicIndex) : m_bodyPoints;
+		for (size_t i = 0; i < m_numberOfBodyPoints; ++i)
+			snapshot.AddBodyPoint(MathContext::ToSFMLPosition(GetWorldPoint(bodyPoints[i])));
+
+		const size_t firstSensor = m_simulatedSensors->GetFirstSensor(m_sensorsIndex);
+		for (size_t i = 0; i < m_sensors.size(); ++i)
+		{
+			snapshot.AddBeam(MathContext::ToSFMLPosition(m_simulatedSensors->GetBeamOrigin(firstSensor + i)),
+							 MathContext::ToSFMLPosition(m_simulatedSensors->GetBeamEnd(firstSensor + i)));
+		}
+	}
+
+	// Marks this vehicle as follower
+	inline void SetAsFollower()
+	{
+		m_leader = false;
+	}
+
+	// Marks this vehicle as leader
+	inline void SetAsLeader()
+	{
+		m_leader = true;
 	}
 
 	// Sets body pointer and associated fields
@@ -154,28 +301,37 @@ public:
 		m_numberOfBodyPoints = shape->m_count;
 		m_bodyPoints = shape->m_vertices;
 
-		SetDefaultColor(m_body->GetMass());
+		m_mass = m_body->GetMass();
+	}
 
-		// Calculate beam positions
-		const float radians = m_body->GetAngle();
-		const sf::Vector2f center = MathContext::ToSFMLPosition(m_body->GetWorldCenter());
-		const float cosinus = float(cos(radians));
-		const float sinus = float(sin(radians));
-		for (size_t i = 0; i < m_sensorPoints.size(); ++i)
-		{
-			m_beams[i][0].position = sf::Vector2f((m_sensorPoints[i].x * cosinus - m_sensorPoints[i].y * sinus),
-												  (m_sensorPoints[i].x * sinus + m_sensorPoints[i].y * cosinus));
-			m_beams[i][0].position += center;
-
-			// Calculate beam end position
-			const auto cosBeam = cos(radians + m_beamAngles[i] + m_motionRanges[i].GetValue());
-			const auto sinBeam = sin(radians + m_beamAngles[i] + m_motionRanges[i].GetValue());
-			m_beams[i][1].position.x = static_cast<float>(m_beams[i][0].position.x + VehicleBuilder::GetDefaultBeamLength() * cosBeam);
-			m_beams[i][1].position.y = static_cast<float>(m_beams[i][0].position.y + VehicleBuilder::GetDefaultBeamLength() * sinBeam);
-			m_beamRaycastCallbacks.emplace_back(m_beams[i], m_sensors[i]);
-		}
-			
-		m_beamRaycastCallbacks.shrink_to_fit();
+	// Sets kinematic model which is used instead of body
+	inline void SetKinematicModel(KinematicVehicleModel* kinematicModel, size_t index)
+	{
+		m_kinematicModel = kinematicModel;
+		m_kinematicIndex = index;
+		m_numberOfBodyPoints = kinematicModel->GetNumberOfBodyPoints(index);
+		m_bodyPoints = nullptr; // Kinematic model storage may be reallocated, points are read from the model
+
+		m_mass = kinematicModel->GetMass(index);
+	}
+
+	// Sets sensors which calculate beams of this vehicle
+	inline void SetSensors(SimulatedSensors* simulatedSensors, size_t index)
+	{
+		m_simulatedSensors = simulatedSensors;
+		m_sensorsIndex = index;
+	}
+
+	// Returns true if vehicle crossed an edge during last kinematic model step
+	inline bool IsKinematicCollision() const
+	{
+		return m_kinematicModel && m_kinematicModel->IsCollision(m_kinematicIndex);
+	}
+
+	// Returns true if vehicle is marked as leader
+	inline bool IsLeader() const
+	{
+		return m_leader;
 	}
 
 	// Returns true if vehicle is active
@@ -188,14 +344,19 @@ public:
 	inline void SetInactive()
 	{
 		m_active = false;
-		for (auto& beam : m_beams)
-			beam[0].color = beam[1].color = ColorContext::BeamDisabled;
+		ResetActuators();
+	}
+
+	// Makes vehicle active again
+	inline void SetActive()
+	{
+		m_active = true;
 	}
 
 	// Returns vehicle center
 	inline sf::Vector2f GetCenter() const
 	{
-		return MathContext::ToSFMLPosition(m_body->GetWorldCenter());
+		return MathContext::ToSFMLPosition(GetWorldCenter());
 	}
 
 	// Output data
@@ -204,16 +365,34 @@ public:
 		return m_sensors;
 	}
 
-	// Input data
+	// Input data, values are quantized so that recorded actuators are the same as applied actuators
 	inline void ProcessInput(const NeuronLayer& layer)
 	{
-		DriveForward(layer[0]);
-		DriveBackward(layer[1]);
-		Turn(layer[2]);
+		SetQuantizedActuators({ QuantizeActuator(layer[0]), QuantizeActuator(layer[1]), QuantizeActuator(layer[2]) });
 	}
 
 private:
 
+	friend class KinematicVehicleModel; // Kinematic model shares vehicle features
+
+	// Returns body angle
+	inline float GetAngle() const
+	{
+		return m_kinematicModel ? m_kinematicModel->GetAngle(m_kinematicIndex) : m_body->GetAngle();
+	}
+
+	// Returns body center
+	inline b2Vec2 GetWorldCenter() const
+	{
+		return m_kinematicModel ? m_kinematicModel->GetPosition(m_kinematicIndex) : m_body->GetWorldCenter();
+	}
+
+	// Returns world position of body point
+	inline b2Vec2 GetWorldPoint(const b2Vec2& localPoint) const
+	{
+		return m_kinematicModel ? m_kinematicModel->GetWorldPoint(m_kinematicIndex, localPoint) : m_body->GetWorldPoint(localPoint);
+	}
+
 	// Calculates lateral velocity
 	b2Vec2 GetLateralVelocity() const
 	{
@@ -230,58 +409,32 @@ private:
 
 	// Body data
 	b2Body* m_body;
+	KinematicVehicleModel* m_kinematicModel; // Used instead of body if set
+	size_t m_kinematicIndex;
 	size_t m_numberOfBodyPoints;
-	b2Vec2* m_bodyPoints;
+	const b2Vec2* m_bodyPoints;
 
 	// Sensors data
-	std::vector<sf::Vector2f> m_sensorPoints;
-	std::vector<double> m_beamAngles;
-	std::vector<PeriodicTimer> m_motionRanges;
+	SimulatedSensors* m_simulatedSensors; // Beams of all vehicles are calculated there
+	size_t m_sensorsIndex;
 	NeuronLayer m_sensors;
 
+	// Actuators data, values are held between controller updates
+	Neuron m_driveForward;
+	Neuron m_driveBackward;
+	Neuron m_turn;
+
 	// Features
 	inline static const double m_maxForwardSpeed = 20.0;
 	inline static const double m_maxBackwardSpeed = -12.0;
 	inline static const double m_maxDriveForce = 50000.0;
 	inline static const double m_maxTorqueForce = 600000.0;
 	inline static const float m_maxLateralImpulse = 2.5f;
+	inline static const double m_forceTimeStep = 1.0 / 600.0; // Forces were tuned for this physics step
+	inline static const double m_actuatorPrecision = 4096.0; // Number of fixed point steps per unit of actuator value
+	float m_mass;
 	bool m_active;
-
-	// Raycast callback
-	class BeamRaycastCallback :
-		public b2RayCastCallback
-	{
-		EdgeShape& m_beam;
-		Neuron& m_sensor;
-
-	public:
-
-		BeamRaycastCallback(EdgeShape& beam, Neuron& sensor) :
-			m_beam(beam),
-			m_sensor(sensor)
-		{
-		}
-		
-		float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction)
-		{
-			//switch (fixture->GetFilterData().categoryBits)
-			//{
-			//	case SimulatedAbstract::CategoryEdge:
-					m_beam[1].position = MathContext::ToSFMLPosition(point);
-					m_sensor = Neuron(fraction);
-					return fraction;
-			//	case SimulatedAbstract::CategoryCheckpoint:
-			//	case SimulatedAbstract::CategoryVehicle:
-			//	default:
-			//		break;
-			//}
-
-			// Don't clip the ray and continue
-			//return 1;
-		}
-	};
-
-	std::vector<BeamRaycastCallback> m_beamRaycastCallbacks;
+	bool m_leader;
 };
 
 using SimulatedVehicles = std::vector<SimulatedVehicle*>;
\ No newline at end of file
@@ -1,24 +1,38 @@
 #include "SimulatedWorld.hpp"
 #include "CoreWindow.hpp"
-#include "DrawableVehicle.hpp"
 #include "MapPrototype.hpp"
 #include "VehicleBuilder.hpp"
 #include "SimulatedEdge.hpp"
 #include "SimulatedCheckpoint.hpp"
 #include "SimulatedVehicle.hpp"
+#include "KinematicVehicleModel.hpp"
+#include "CoreProfiler.hpp"
 #include <Box2D\box2d.h>
 
-SimulatedWorld::SimulatedWorld()
+SimulatedWorld::SimulatedWorld(int dynamicsType) :
+	m_drawQueryCallback(&m_drawnVehicles)
 {
 	m_world = new b2World(b2Vec2(0.0f, 0.0f));
 	m_world->SetContactListener(&m_contactListener);
 	m_edgesWorld = new b2World(b2Vec2(0.0f, 0.0f));
+	m_kinematicModel = dynamicsType == KINEMATIC_DYNAMICS ? new KinematicVehicleModel() : nullptr;
+	m_deathOnEdgeContact = false;
+
+	// Contacts between static objects and between vehicles are filtered out by Box2D
+	for (auto& contactHandlers : m_contactHandlers)
+		for (auto& contactHandler : contactHandlers)
+			contactHandler = nullptr;
+	m_contactHandlers[EDGE_CONTACT_CATEGORY][VEHICLE_CONTACT_CATEGORY] =
+		&SimulatedWorld::DispatchContact<SimulatedEdge, SimulatedVehicle, &SimulatedWorld::OnEdgeContact>;
+	m_contactHandlers[CHECKPOINT_CONTACT_CATEGORY][VEHICLE_CONTACT_CATEGORY] =
+		&SimulatedWorld::DispatchContact<SimulatedCheckpoint, SimulatedVehicle, &SimulatedWorld::OnCheckpointContact>;
 }
 
 SimulatedWorld::~SimulatedWorld()
 {
 	delete m_world;
 	delete m_edgesWorld;
+	delete m_kinematicModel;
 
 	for (const auto & item : m_simulatedObjects)
 	{
@@ -41,13 +55,7 @@ SimulatedWorld::~SimulatedWorld()
 
 void SimulatedWorld::EnableDeathOnEdgeContact()
 {
-	auto function = [&](b2Contact* contact)
-	{
-		if (contact->GetFixtureA()->GetFilterData().categoryBits == SimulatedAbstract::CategoryEdge &&
-			contact->GetFixtureB()->GetFilterData().categoryBits == SimulatedAbstract::CategoryVehicle)
-			((SimulatedVehicle*)contact->GetFixtureB()->GetUserData().pointer)->SetInactive();
-	};
-	m_contactListener.AddBeginContactFunction(function);
+	m_deathOnEdgeContact = true;
 }
 
 void SimulatedWorld::AddMap(MapPrototype* prototype)
@@ -60,11 +68,17 @@ void SimulatedWorld::AddMap(MapPrototype* prototype)
 SimulatedVehicle* SimulatedWorld::AddVehicle(VehiclePrototype* prototype)
 {
 	// Create simulated vehicle
-	auto simulatedVehicle = new SimulatedVehicle(prototype->GetNumberOfBodyPoints(),
-												 prototype->GetSensorPoints(),
-												 prototype->GetSensorBeamAngles(),
-												 prototype->GetSensorMotionRanges());
+	auto simulatedVehicle = new SimulatedVehicle(prototype->GetNumberOfBodyPoints(), prototype->GetSensorPoints().size());
 	m_simulatedObjects.push_back(simulatedVehicle);
+	m_vehicles.push_back(simulatedVehicle);
+
+	// Add vehicle sensors
+	const size_t sensorsIndex = m_simulatedSensors.AddVehicle(prototype->GetSensorPoints(),
+															  prototype->GetSensorBeamAngles(),
+															  prototype->GetSensorMotionRanges(),
+															  MathContext::ToBox2DPosition(prototype->GetCenter()),
+															  (float)MathContext::ToRadians(prototype->GetAngle()));
+	simulatedVehicle->SetSensors(&m_simulatedSensors, sensorsIndex);
 
 	// Create polygon shape
 	const auto& description = prototype->GetBodyPoints();
@@ -78,6 +92,23 @@ SimulatedVehicle* SimulatedWorld::AddVehicle(VehiclePrototype* prototype)
 	polygonShape.Set(vertices, int32(numberOfPoints));
 	delete[] vertices;
 
+	if (m_kinematicModel)
+	{
+		// Mass data is calculated the same way as for body with mass center moved to the origin
+		b2MassData massData;
+		polygonShape.ComputeMass(&massData, 1.0f);
+		const size_t index = m_kinematicModel->AddVehicle(polygonShape.m_vertices,
+														  size_t(polygonShape.m_count),
+														  MathContext::ToBox2DPosition(prototype->GetCenter()),
+														  (float)MathContext::ToRadians(prototype->GetAngle()),
+														  massData.mass,
+														  massData.I);
+		simulatedVehicle->SetKinematicModel(m_kinematicModel, index);
+		m_kinematicVehicles.push_back(simulatedVehicle);
+		m_kinematicShapes.push_back(polygonShape);
+		return simulatedVehicle;
+	}
+
 	// Create fixture definition
 	b2FixtureDef fixtureDefinition;
 	fixtureDefinition.filter.categoryBits = SimulatedAbstract::CategoryVehicle;
@@ -105,6 +136,41 @@ SimulatedVehicle* SimulatedWorld::AddVehicle(VehiclePrototype* prototype)
 	return simulatedVehicle;
 }
 
+void SimulatedWorld::UpdateSensors(double timeStep)
+{
+	PROFILE_ZONE("SimulatedWorld::UpdateSensors");
+	for (auto& vehicle : m_vehicles)
+		vehicle->UpdateSensorsPose();
+
+	m_simulatedSensors.Update(m_edgesWorld, timeStep);
+
+	for (auto& vehicle : m_vehicles)
+		vehicle->UpdateSensors();
+}
+
+void SimulatedWorld::SaveState(SimulatedState& state) const
+{
+	state.Write(m_vehicles.size());
+	for (const auto& vehicle : m_vehicles)
+		vehicle->SaveState(state);
+}
+
+bool SimulatedWorld::RestoreState(SimulatedState& state)
+{
+	size_t numberOfVehicles = 0;
+	if (!state.Read(numberOfVehicles) || numberOfVehicles != m_vehicles.size())
+		return false;
+
+	// Box2D contacts are not stored, they are found again in the next step
+	for (auto& vehicle : m_vehicles)
+	{
+		if (!vehicle->RestoreState(state))
+			return false;
+	}
+
+	return true;
+}
+
 void SimulatedWorld::AddEdgesChain(const EdgeVector& edgesChain)
 {
 	const size_t numberOfEdges = edgesChain.size();
@@ -112,10 +178,7 @@ void SimulatedWorld::AddEdgesChain(const EdgeVector& edgesChain)
 	SimulatedEdge* simulatedEdge = new SimulatedEdge[numberOfEdges];
 	m_simulatedObjects.push_back(simulatedEdge);
 	for (size_t i = 0; i < numberOfEdges; ++i)
-	{
 		vertices[i] = MathContext::ToBox2DPosition(edgesChain[i][0]);
-		simulatedEdge[i].SetPosition(edgesChain[i]);
-	}
 
 	b2ChainShape chainShape;
 	chainShape.CreateLoop(vertices, int32(numberOfEdges));
@@ -145,9 +208,11 @@ void SimulatedWorld::AddCheckpoints(const RectangleVector& checkpoints)
 		points[1] = MathContext::ToBox2DPosition(checkpoints[i][1]);
 		points[2] = MathContext::ToBox2DPosition(checkpoints[i][2]);
 		points[3] = MathContext::ToBox2DPosition(checkpoints[i][3]);
-		SimulatedCheckpoint* simulatedCheckpoint = new SimulatedCheckpoint(i, checkpoints[i]);
+		SimulatedCheckpoint* simulatedCheckpoint = new SimulatedCheckpoint(i);
 		m_simulatedObjects.push_back(simulatedCheckpoint);
+		m_checkpoints.push_back(simulatedCheckpoint);
 		polygonShape.Set(points, 4);
+		m_checkpointShapes.push_back(polygonShape);
 
 		b2BodyDef bodyDefinition;
 		bodyDefinition.position = b2Vec2(0.0f, 0.0f);
@@ -163,20 +228,148 @@ void SimulatedWorld::AddCheckpoints(const RectangleVector& checkpoints)
 	}
 }
 
-bool SimulatedWorld::DrawQueryCallback::ReportFixture(b2Fixture* fixture, int32 childIndex)
+void SimulatedWorld::ProcessContacts()
 {
-	switch (fixture->GetFilterData().categoryBits)
+	auto& contactEvents = m_contactListener.GetContactEvents();
+	for (const auto& contactEvent : contactEvents)
+	{
+		const ContactHandler contactHandler = m_contactHandlers[contactEvent.m_categoryA][contactEvent.m_categoryB];
+		if (contactHandler)
+			(this->*contactHandler)(contactEvent.m_objectA, contactEvent.m_objectB);
+	}
+
+	contactEvents.clear(); // Capacity is kept so there are no allocations in next steps
+}
+
+void SimulatedWorld::OnEdgeContact(SimulatedEdge*, SimulatedVehicle* vehicle)
+{
+	if (m_deathOnEdgeContact)
+		vehicle->SetInactive();
+}
+
+void SimulatedWorld::OnCheckpointContact(SimulatedCheckpoint* checkpoint, SimulatedVehicle* vehicle)
+{
+	for (auto& function : m_checkpointFunctions)
+		function(checkpoint, vehicle);
+}
+
+void SimulatedWorld::StepKinematicModel(float timeStep)
+{
+	m_kinematicModel->Step(timeStep, m_edgesWorld);
+
+	// Checkpoints are static, their shapes are stored in world coordinates
+	b2Transform checkpointTransform;
+	checkpointTransform.SetIdentity();
+
+	const size_t numberOfCheckpoints = m_checkpoints.size();
+	for (size_t i = 0; i < m_kinematicVehicles.size(); ++i)
+	{
+		SimulatedVehicle* vehicle = m_kinematicVehicles[i];
+		if (m_deathOnEdgeContact && vehicle->IsKinematicCollision())
+			vehicle->SetInactive();
+
+		// Checkpoint fitness equals its index plus one, only neighbouring checkpoints may change vehicle fitness
+		// Whole body is tested with the same overlap test that Box2D uses for sensor fixtures, so both backends award checkpoints at the same time
+		const size_t fitness = size_t(vehicle->GetFitness());
+		const b2Transform vehicleTransform(m_kinematicModel->GetPosition(i), b2Rot(m_kinematicModel->GetAngle(i)));
+		const size_t neighbours[2] = { fitness, fitness - 2 };
+		for (const auto index : neighbours)
+		{
+			if (index >= numberOfCheckpoints)
+				continue;
+
+			if (b2TestOverlap(&m_checkpointShapes[index], 0, &m_kinematicShapes[i], 0, checkpointTransform, vehicleTransform))
+			{
+				for (auto& function : m_checkpointFunctions)
+					function(m_checkpoints[index], vehicle);
+				break;
+			}
+		}
+	}
+}
+
+void SimulatedWorld::Draw()
+{
+	PROFILE_ZONE("SimulatedWorld::Draw");
+	b2AABB aabb;
+	aabb.lowerBound = MathContext::ToBox2DPosition(CoreWindow::GetViewOffset());
+	aabb.upperBound = MathContext::ToBox2DPosition(CoreWindow::GetViewOffset() + CoreWindow::GetViewSize());
+	m_drawnVehicles.clear();
+	m_world->QueryAABB(&m_drawQueryCallback, aabb);
+	if (m_kinematicModel)
+		GatherKinematicVehicles();
+
+	// Levels of detail are selected once all vehicles in the view are known
+	m_vehicleBatch.Begin(CoreWindow::GetViewCenter());
+	for (const auto& vehicle : m_drawnVehicles)
+		m_vehicleBatch.AddCandidate(vehicle->GetCenter(), vehicle->IsActive(), vehicle->IsLeader());
+	m_vehicleBatch.SelectDetails();
+	for (size_t i = 0; i < m_drawnVehicles.size(); ++i)
+		m_drawnVehicles[i]->Draw(m_vehicleBatch, m_vehicleBatch.GetDetail(i));
+	m_vehicleBatch.Draw();
+}
+
+void SimulatedWorld::GatherKinematicVehicles()
+{
+	// Vehicle is drawn together with its beams so the view is extended by the body bound and beam length
+	const float beamLength = float(VehicleBuilder::GetDefaultBeamLength());
+	const sf::Vector2f margin = VehicleBuilder::GetMaxBodyBound() + sf::Vector2f(beamLength, beamLength);
+	const sf::Vector2f viewOffset = CoreWindow::GetViewOffset() - margin;
+	const sf::Vector2f viewSize = CoreWindow::GetViewSize() + margin * 2.f;
+	for (auto& vehicle : m_kinematicVehicles)
+	{
+		if (MathContext::IsPointInsideRectangle(viewSize, viewOffset, vehicle->GetCenter()))
+			m_drawnVehicles.push_back(vehicle);
+	}
+}
+
+void SimulatedWorld::ContactListener::BeginContact(b2Contact* contact)
+{
+	ContactEvent contactEvent;
+	b2Fixture* fixtureA = contact->GetFixtureA();
+	b2Fixture* fixtureB = contact->GetFixtureB();
+	contactEvent.m_categoryA = ToContactCategory(fixtureA->GetFilterData().categoryBits);
+	contactEvent.m_objectA = (void*)fixtureA->GetUserData().pointer;
+	contactEvent.m_categoryB = ToContactCategory(fixtureB->GetFilterData().categoryBits);
+	contactEvent.m_objectB = (void*)fixtureB->GetUserData().pointer;
+	if (contactEvent.m_categoryA == NUMBER_OF_CONTACT_CATEGORIES || contactEvent.m_categoryB == NUMBER_OF_CONTACT_CATEGORIES)
+		return;
+
+	// Edges chain user data points to the array of edges, pick the edge that was hit
+	if (contactEvent.m_categoryA == EDGE_CONTACT_CATEGORY)
+		contactEvent.m_objectA = (SimulatedEdge*)contactEvent.m_objectA + contact->GetChildIndexA();
+	if (contactEvent.m_categoryB == EDGE_CONTACT_CATEGORY)
+		contactEvent.m_objectB = (SimulatedEdge*)contactEvent.m_objectB + contact->GetChildIndexB();
+
+	if (contactEvent.m_categoryA > contactEvent.m_categoryB)
+	{
+		std::swap(contactEvent.m_categoryA, contactEvent.m_categoryB);
+		std::swap(contactEvent.m_objectA, contactEvent.m_objectB);
+	}
+
+	m_contactEvents.push_back(contactEvent);
+}
+
+size_t SimulatedWorld::ContactListener::ToContactCategory(uint16 categoryBits)
+{
+	switch (categoryBits)
 	{
 		case SimulatedAbstract::CategoryEdge:
-			((SimulatedEdge*)fixture->GetUserData().pointer)[childIndex].Draw();
-			break;
+			return EDGE_CONTACT_CATEGORY;
 		case SimulatedAbstract::CategoryCheckpoint:
-			((SimulatedCheckpoint*)fixture->GetUserData().pointer)->Draw();
-			break;
+			return CHECKPOINT_CONTACT_CATEGORY;
 		case SimulatedAbstract::CategoryVehicle:
-			((SimulatedVehicle*)fixture->GetUserData().pointer)->Draw();
-			break;
+			return VEHICLE_CONTACT_CATEGORY;
 	}
-	
+
+	return NUMBER_OF_CONTACT_CATEGORIES;
+}
+
+bool SimulatedWorld::DrawQueryCallback::ReportFixture(b2Fixture* fixture, int32)
+{
+	// Edges and checkpoints are static, they are drawn from map prototype geometry
+	if (fixture->GetFilterData().categoryBits == SimulatedAbstract::CategoryVehicle)
+		m_drawnVehicles->push_back((SimulatedVehicle*)fixture->GetUserData().pointer);
+
 	return true; // Return true to continue the query
 }
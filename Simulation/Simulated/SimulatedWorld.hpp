@@ -2,9 +2,26 @@
 #include "MathContext.hpp"
 #include "CoreWindow.hpp"
 #include "SimulatedVehicle.hpp"
+#include "CoreProfiler.hpp"
 
 class MapPrototype;
 class VehiclePrototype;
+class SimulatedEdge;
+class SimulatedCheckpoint;
+class KinematicVehicleModel;
+
+// Vehicle dynamics backends
+enum : int
+{
+	BOX2D_DYNAMICS,
+	KINEMATIC_DYNAMICS,
+	NUMBER_OF_DYNAMICS_TYPES
+};
+
+const char* const DynamicsTypeStrings[NUMBER_OF_DYNAMICS_TYPES] = {
+	"Box2D",
+	"Kinematic"
+};
 
 // This class is responsible for connection between simulator physics and drawing
 // Here we connect Box2D functionality and SFML functionality
@@ -13,33 +30,49 @@ class SimulatedWorld
 {
 public:
 
-	SimulatedWorld();
+	explicit SimulatedWorld(int dynamicsType = BOX2D_DYNAMICS);
 
 	~SimulatedWorld();
 
-	// Update internal world state
-	inline void Update()
+	// Performs single physics step of specified duration
+	inline void Step(float timeStep)
 	{
-		const float step = 1.f / 600.f;
-		const float elapsedTime = float(CoreWindow::GetElapsedTime());
-		static float leftProgress = 0.f;
-		float progress = leftProgress;
-		while (progress < elapsedTime)
+		PROFILE_ZONE("SimulatedWorld::Step");
+		if (m_kinematicModel)
+			StepKinematicModel(timeStep);
+		else
 		{
-			m_world->Step(step, 8, 8);
-			progress += step;
+			m_world->Step(timeStep, 8, 8);
+			ProcessContacts();
 		}
-		leftProgress = progress - elapsedTime;
-		//m_world->Step(float(CoreWindow::GetElapsedTime()), 8, 3);
 	}
 
-	// Draws simulation environment
-	inline void Draw()
+	// Calculates sensors of all vehicles at once, motion ranges are moved by specified time step
+	void UpdateSensors(double timeStep);
+
+	// Draws vehicles, static track geometry is drawn by map prototype
+	void Draw();
+
+	// Fills snapshot with all vehicles, previous snapshot vehicles are removed
+	inline void Capture(SimulatedSnapshot& snapshot) const
 	{
-		b2AABB aabb;
-		aabb.lowerBound = MathContext::ToBox2DPosition(CoreWindow::GetViewOffset());
-		aabb.upperBound = MathContext::ToBox2DPosition(CoreWindow::GetViewOffset() + CoreWindow::GetViewSize());
-		m_world->QueryAABB(&m_drawQueryCallback, aabb);
+		snapshot.Clear();
+		for (const auto& vehicle : m_vehicles)
+			vehicle->Capture(snapshot);
+	}
+
+	// Appends state of all vehicles to the state
+	void SaveState(SimulatedState& state) const;
+
+	// Restores state of all vehicles, world has to be created from the same map and vehicle prototypes
+	// Single vehicle state can be restored into many vehicles with SimulatedVehicle::RestoreState to fork candidates
+	// Returns false if state is incomplete or number of vehicles is different
+	bool RestoreState(SimulatedState& state);
+
+	// Returns dynamics type
+	inline int GetDynamicsType() const
+	{
+		return m_kinematicModel ? KINEMATIC_DYNAMICS : BOX2D_DYNAMICS;
 	}
 
 	// Returns edges world representation
@@ -48,10 +81,11 @@ public:
 		return m_edgesWorld;
 	}
 
-	// Adds contact listener
-	inline void AddBeginContactFunction(std::function<void(b2Contact*)> function)
+	// Adds function called when vehicle enters checkpoint
+	inline void AddCheckpointFunction(std::function<void(SimulatedCheckpoint*, SimulatedVehicle*)> function)
 	{
-		m_contactListener.AddBeginContactFunction(function);
+		m_checkpointFunctions.push_back(function);
+		m_checkpointFunctions.shrink_to_fit();
 	}
 
 	// If called then vehicle will be inactive after it made contact with edge
@@ -71,42 +105,114 @@ private:
 	// Adds checkpoints to the world
 	void AddCheckpoints(const RectangleVector& checkpoints);
 
-	// Callback called to draw all polygons
+	// Dispatches contacts queued during last physics step to typed handlers
+	void ProcessContacts();
+
+	// Handles contact between edge and vehicle
+	void OnEdgeContact(SimulatedEdge* edge, SimulatedVehicle* vehicle);
+
+	// Handles contact between checkpoint and vehicle
+	void OnCheckpointContact(SimulatedCheckpoint* checkpoint, SimulatedVehicle* vehicle);
+
+	// Casts objects of contact to types of its categories and calls typed handler
+	// Every table entry is instantiated for its pair of categories, so the only casts are made here
+	template<class ObjectA, class ObjectB, void (SimulatedWorld::*Handler)(ObjectA*, ObjectB*)>
+	inline void DispatchContact(void* objectA, void* objectB)
+	{
+		(this->*Handler)(static_cast<ObjectA*>(objectA), static_cast<ObjectB*>(objectB));
+	}
+
+	// Steps kinematic model and handles edges and checkpoints contacts of kinematic vehicles
+	void StepKinematicModel(float timeStep);
+
+	// Gathers kinematic vehicles that are inside the view
+	void GatherKinematicVehicles();
+
+	// Vehicles found by draw query are gathered here and drawn at once
+	DrawableVehicleBatch m_vehicleBatch;
+	SimulatedVehicles m_drawnVehicles;
+
+	// Callback called to gather vehicles found in the view
 	class DrawQueryCallback :
 		public b2QueryCallback
 	{
+		SimulatedVehicles* m_drawnVehicles;
+
 	public:
 
-		// Draws reported fixture
+		explicit DrawQueryCallback(SimulatedVehicles* drawnVehicles) :
+			m_drawnVehicles(drawnVehicles)
+		{
+		}
+
+		// Adds reported vehicle to the drawn vehicles
 		bool ReportFixture(b2Fixture* fixture, int32 childIndex);
 	};
 	DrawQueryCallback m_drawQueryCallback;
 
-	// Contact listener wrapper
+	// Contact categories used as contact handlers table indexes
+	enum : size_t
+	{
+		EDGE_CONTACT_CATEGORY,
+		CHECKPOINT_CONTACT_CATEGORY,
+		VEHICLE_CONTACT_CATEGORY,
+		NUMBER_OF_CONTACT_CATEGORIES
+	};
+
+	// Contact handler thunk, receives objects ordered by category
+	using ContactHandler = void (SimulatedWorld::*)(void*, void*);
+	ContactHandler m_contactHandlers[NUMBER_OF_CONTACT_CATEGORIES][NUMBER_OF_CONTACT_CATEGORIES];
+
+	// Contact reported during physics step
+	struct ContactEvent
+	{
+		size_t m_categoryA;
+		void* m_objectA;
+		size_t m_categoryB;
+		void* m_objectB;
+	};
+
+	// Contact listener, contacts are queued and processed after physics step
 	class ContactListener :
 		public b2ContactListener
 	{
-		std::vector<std::function<void(b2Contact*)>> m_beginContactFunctions;
+		std::vector<ContactEvent> m_contactEvents;
 
 	public:
 
-		// Adds begin contact function
-		void AddBeginContactFunction(std::function<void(b2Contact*)> function)
+		ContactListener()
 		{
-			m_beginContactFunctions.push_back(function);
-			m_beginContactFunctions.shrink_to_fit();
+			m_contactEvents.reserve(256);
 		}
 
-		// Detects begin contact
-		void BeginContact(b2Contact* contact)
+		// Returns contacts queued during last physics step
+		inline std::vector<ContactEvent>& GetContactEvents()
 		{
-			for (auto& function : m_beginContactFunctions)
-				function(contact);
+			return m_contactEvents;
 		}
+
+		// Queues begin contact, objects are ordered so that lower category is first
+		void BeginContact(b2Contact* contact);
+
+	private:
+
+		// Converts category bits to contact category
+		static size_t ToContactCategory(uint16 categoryBits);
 	};
 	ContactListener m_contactListener;
 
 	b2World* m_world; // World representation
 	b2World* m_edgesWorld; // Static world representation used as dynamic tree for edges
 	std::vector<SimulatedAbstract*> m_simulatedObjects;
+	SimulatedVehicles m_vehicles;
+	SimulatedSensors m_simulatedSensors;
+
+	// Kinematic dynamics, vehicles are not added to Box2D world
+	KinematicVehicleModel* m_kinematicModel;
+	SimulatedVehicles m_kinematicVehicles;
+	std::vector<b2PolygonShape> m_kinematicShapes; // Body shapes of kinematic vehicles relative to the center
+	std::vector<SimulatedCheckpoint*> m_checkpoints;
+	std::vector<b2PolygonShape> m_checkpointShapes;
+	std::vector<std::function<void(SimulatedCheckpoint*, SimulatedVehicle*)>> m_checkpointFunctions;
+	bool m_deathOnEdgeContact;
 };
\ No newline at end of file
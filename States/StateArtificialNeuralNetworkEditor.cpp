@@ -293,7 +293,7 @@ void StateArtificialNeuralNetworkEditor::Draw()
 	{
 		m_weightShape[0].position = m_weightPositions[i][0];
 		m_weightShape[1].position = m_weightPositions[i][1];
-		m_weightShape[0].color = m_weightStrengths[i];
+		m_weightShape[0].color = ColorContext::Convert(m_weightStrengths[i]);
 		m_weightShape[1].color = m_weightShape[0].color;
 		CoreWindow::Draw(m_weightShape.data(), m_weightShape.size(), sf::Lines);
 	}
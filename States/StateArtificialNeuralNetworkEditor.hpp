@@ -78,7 +78,7 @@ private:
 	// Drawable shapes and their position
 	std::vector<std::vector<sf::Vector2f>> m_layersPositions;
 	std::vector<Edge> m_weightPositions;
-	std::vector<sf::Color> m_weightStrengths;
+	std::vector<sf::Color> m_weightStrengths; // Colors of weights in dark palette
 	sf::CircleShape m_neuronShape;
 	EdgeShape m_weightShape;
 
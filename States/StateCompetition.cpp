@@ -9,7 +9,9 @@
 #include "SimulatedWorld.hpp"
 #include "MapPrototype.hpp"
 #include "FitnessSystem.hpp"
-#include "DrawableCheckpoint.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 StateCompetition::StateCompetition() :
 	m_numberOfVehicles(0),
@@ -69,6 +71,10 @@ StateCompetition::StateCompetition() :
 	m_simulatedWorld = nullptr;
 	m_fitnessSystem = nullptr;
 	m_mapPrototype = nullptr;
+	m_leaderIndex = 0;
+	m_userDriveForward = 0.0;
+	m_userDriveBackward = 0.0;
+	m_userTurn = VehicleBuilder::GetDefaultTorque();
 
 	// Initialize user vehicle with dummy vehicle
 	m_vehicleBuilder.CreateDummy();
@@ -84,6 +90,7 @@ StateCompetition::StateCompetition() :
 
 StateCompetition::~StateCompetition()
 {
+	m_simulationThread.Stop();
 	delete m_simulatedWorld;
 	delete m_fitnessSystem;
 	delete m_mapPrototype;
@@ -101,6 +108,10 @@ StateCompetition::~StateCompetition()
 
 void StateCompetition::Reload()
 {
+	// Stop simulation thread before simulation objects are removed
+	m_simulationThread.Stop();
+	m_drawableSnapshot.Clear();
+
 	// Reset states
 	m_mode = STOPPED_MODE;
 	m_fileFormat = MAP_FILE_FORMAT;
@@ -116,9 +127,11 @@ void StateCompetition::Reload()
 	m_enableUserVehicle.ResetValue();
 	m_enableCheckpoints.ResetValue();
 	m_zoom.ResetValue();
+	m_timeWarp.Reset();
 	m_zoomThreshold = m_zoom.Max();
 	m_viewTimer.Reset();
 	m_pressedKeyTimer.MakeTimeout();
+	m_rateScheduler.Reset();
 
 	// Reset objects of environment
 	delete m_simulatedWorld;
@@ -265,10 +278,9 @@ void StateCompetition::Capture()
 								delete m_simulatedWorld;
 								m_simulatedWorld = new SimulatedWorld;
 								m_simulatedWorld->AddMap(m_mapPrototype);
-								DrawableCheckpoint::SetVisibility(m_enableCheckpoints);
 								delete m_fitnessSystem;
 								m_fitnessSystem = new FitnessSystem(totalNumberOfSimulatedVehicles, m_mapPrototype->GetNumberOfCheckpoints(), 0.0);
-								m_simulatedWorld->AddBeginContactFunction(m_fitnessSystem->GetBeginContactFunction());
+								m_simulatedWorld->AddCheckpointFunction(m_fitnessSystem->GetCheckpointFunction());
 
 								// Add bot vehicles to the world
 								m_simulatedVehicles.resize(totalNumberOfSimulatedVehicles, nullptr);
@@ -283,8 +295,14 @@ void StateCompetition::Capture()
 									m_simulatedVehicles.back() = m_userVehicle;
 								}
 
+								m_rateScheduler.Reset();
 								m_mode = RUNNING_MODE;
 								m_textObservers[MODE_TEXT]->Notify();
+
+								// Run simulation in its own thread
+								m_leaderIndex = 0;
+								m_drawableSnapshot.Clear();
+								StartSimulation();
 								break;
 							}
 							case CHANGE_FILENAME_TYPE:
@@ -405,6 +423,7 @@ void StateCompetition::Capture()
 						{
 							if (m_pressedKeys[iterator->second])
 								break;
+							StopSimulation();
 							m_mode = STOPPED_MODE;
 							m_textObservers[MODE_TEXT]->Notify();
 
@@ -418,7 +437,16 @@ void StateCompetition::Capture()
 						case CHANGE_FILENAME_TYPE:
 							break;
 						case INCREASE_PARAMETER:
+							if (m_pressedKeys[iterator->second])
+								break;
+							m_timeWarp.Increase();
+							m_textObservers[TIME_WARP_TEXT]->Notify();
+							break;
 						case DECREASE_PARAMETER:
+							if (m_pressedKeys[iterator->second])
+								break;
+							m_timeWarp.Decrease();
+							m_textObservers[TIME_WARP_TEXT]->Notify();
 							break;
 						case INCREASE_ZOOM:
 							if (m_pressedKeyTimer.Update())
@@ -451,6 +479,7 @@ void StateCompetition::Capture()
 						{
 							if (m_pressedKeys[iterator->second])
 								break;
+							StopSimulation();
 							m_mode = PAUSED_MODE;
 							m_textObservers[MODE_TEXT]->Notify();
 							break;
@@ -502,6 +531,7 @@ void StateCompetition::Capture()
 								break;
 							m_mode = RUNNING_MODE;
 							m_textObservers[MODE_TEXT]->Notify();
+							StartSimulation();
 							break;
 						}
 						default:
@@ -568,7 +598,6 @@ void StateCompetition::Update()
 						delete m_mapPrototype;
 						m_mapPrototype = m_mapBuilder.Get();
 						m_mapPrototype->CalculateProperties();
-						DrawableCheckpoint::SetVisibility(m_enableCheckpoints);
 
 						// Set dummy vehicle
 						m_dummyVehiclePrototype->SetCenter(m_mapBuilder.GetVehicleCenter());
@@ -697,63 +726,53 @@ void StateCompetition::Update()
 		}
 		case RUNNING_MODE:
 		{
-			const auto currentLeaderindex = m_fitnessSystem->MarkLeader(m_simulatedVehicles);
+			// Simulation is performed by simulation thread, here only the newest snapshot is taken
+			m_snapshots.Consume();
+			const auto& snapshot = m_snapshots.GetFront();
 			if (m_userVehicle)
 			{
-				m_userVehicle->Update(m_simulatedWorld->GetEdgesWorld());
-
-				if (m_userVehicle->IsActive())
+				// Actuators are held by vehicle so they are passed to simulation thread in every frame
+				double driveForward = 0.0, driveBackward = 0.0, turn = VehicleBuilder::GetDefaultTorque();
+				if (m_pressedKeys[USER_VEHICLE_TURN_LEFT])
 				{
-					if (m_pressedKeys[USER_VEHICLE_TURN_LEFT])
-					{
-						m_userVehicle->Turn(VehicleBuilder::GetDefaultTorque() - m_defaultUserVehicleTorque);
-					}
-					else if (m_pressedKeys[USER_VEHICLE_TURN_RIGHT])
-					{
-						m_userVehicle->Turn(VehicleBuilder::GetDefaultTorque() + m_defaultUserVehicleTorque);
-					}
+					turn = VehicleBuilder::GetDefaultTorque() - m_defaultUserVehicleTorque;
+				}
+				else if (m_pressedKeys[USER_VEHICLE_TURN_RIGHT])
+				{
+					turn = VehicleBuilder::GetDefaultTorque() + m_defaultUserVehicleTorque;
+				}
 
-					if (m_pressedKeys[USER_VEHICLE_DRIVE_FORWARD])
-					{
-						m_userVehicle->DriveForward(1.0);
-					}
+				if (m_pressedKeys[USER_VEHICLE_DRIVE_FORWARD])
+				{
+					driveForward = 1.0;
+				}
 
-					if (m_pressedKeys[USER_VEHICLE_DRIVE_BACKWARD])
-					{
-						m_userVehicle->DriveBackward(1.0);
-					}
+				if (m_pressedKeys[USER_VEHICLE_DRIVE_BACKWARD])
+				{
+					driveBackward = 1.0;
 				}
 
-				if (m_zoom < m_zoomThreshold)
-					CoreWindow::SetViewCenter(m_userVehicle->GetCenter());
+				m_userDriveForward = driveForward;
+				m_userDriveBackward = driveBackward;
+				m_userTurn = turn;
+
+				// User vehicle is added to the world after bot vehicles
+				if (m_zoom < m_zoomThreshold && m_numberOfVehicles < snapshot.GetNumberOfVehicles())
+					CoreWindow::SetViewCenter(snapshot.GetCenter(m_numberOfVehicles));
 			}
 			else if (m_zoom < m_zoomThreshold && m_viewTimer.Update())
 			{
-				sf::Vector2f m_viewCenter = m_dummyVehiclePrototype->GetCenter();
-				if (m_numberOfVehicles)
-					m_viewCenter = m_simulatedVehicles[currentLeaderindex]->GetCenter();
+				sf::Vector2f leaderCenter = m_dummyVehiclePrototype->GetCenter();
+				if (snapshot.GetLeaderIndex() < snapshot.GetNumberOfVehicles())
+					leaderCenter = snapshot.GetCenter(snapshot.GetLeaderIndex());
 
 				// Update view
 				auto viewCenter = CoreWindow::GetViewCenter();
-				const auto distance = MathContext::Distance(viewCenter, m_viewCenter);
-				const auto angle = MathContext::DifferenceVectorAngle(viewCenter, m_viewCenter);
+				const auto distance = MathContext::Distance(viewCenter, leaderCenter);
+				const auto angle = MathContext::DifferenceVectorAngle(viewCenter, leaderCenter);
 				viewCenter = MathContext::GetEndPoint(viewCenter, angle, float(-distance * m_viewMovementOffset * CoreWindow::GetElapsedTime()));
 				CoreWindow::SetViewCenter(viewCenter);
 			}
-
-			// Iterate over all bot vehicles, remember that in simulated vehicles
-			// the last vehicle is user vehicle
-			for (size_t i = 0; i < m_numberOfVehicles; ++i)
-			{
-				m_simulatedVehicles[i]->Update(m_simulatedWorld->GetEdgesWorld());
-				if (!m_simulatedVehicles[i]->IsActive())
-					continue;
-				const NeuronLayer& input = m_simulatedVehicles[i]->ProcessOutput();
-				const NeuronLayer& output = m_artificialNeuralNetworks[i]->Update(input);
-				m_simulatedVehicles[i]->ProcessInput(output);
-			}
-
-			m_simulatedWorld->Update();
 			break;
 		}
 		case PAUSED_MODE:
@@ -779,6 +798,8 @@ bool StateCompetition::Load()
 	m_texts[ENABLE_USER_VEHICLE_TEXT] = new DoubleText({ m_parameterTypesStrings[ENABLE_USER_VEHICLE] + ":" });
 	m_texts[USER_FITNESS_TEXT] = new DoubleText({ "User fitness:" });
 	m_texts[ZOOM_TEXT] = new TripleText({ "Zoom:", "", "| [/] [*]" });
+	m_texts[TIME_WARP_TEXT] = new TripleText({ "Time warp:", "", "| [+] [-]" });
+	m_texts[THROUGHPUT_TEXT] = new DoubleText({ "Throughput:" });
 
 	// Create observers
 	m_textObservers[MODE_TEXT] = new FunctionEventObserver<std::string>([&] { return m_modeStrings[m_mode]; });
@@ -789,8 +810,10 @@ bool StateCompetition::Load()
 	m_textObservers[NUMBER_OF_BOT_VEHICLES_TEXT] = new TypeEventObserver<size_t>(m_numberOfVehicles);
 	m_textObservers[ENABLE_CHECKPOINTS_TEXT] = new FunctionEventObserver<bool>([&] { return m_enableCheckpoints; });
 	m_textObservers[ENABLE_USER_VEHICLE_TEXT] = new FunctionEventObserver<bool>([&] { return m_enableUserVehicle; });
-	m_textObservers[USER_FITNESS_TEXT] = new FunctionTimerObserver<std::string>([&]{ return !m_userVehicle ? "Unknown" : std::to_string(size_t(m_fitnessSystem->ToFitnessRatio(m_userVehicle->GetFitness()))) + "%"; }, 0.5);
+	m_textObservers[USER_FITNESS_TEXT] = new FunctionTimerObserver<std::string>([&]{ return !m_userVehicle ? "Unknown" : std::to_string(size_t(m_snapshots.GetFront().GetValue(USER_FITNESS_VALUE))) + "%"; }, 0.5);
 	m_textObservers[ZOOM_TEXT] = new FunctionEventObserver<float>([&] { return m_zoom; });
+	m_textObservers[TIME_WARP_TEXT] = new FunctionEventObserver<std::string>([&] { return m_timeWarp.ToString(); });
+	m_textObservers[THROUGHPUT_TEXT] = new FunctionTimerObserver<std::string>([&] { const auto& snapshot = m_snapshots.GetFront(); return TimeWarp::ToThroughputString(snapshot.GetValue(SIMULATED_SECONDS_PER_SECOND_VALUE), snapshot.GetValue(STEPS_PER_SECOND_VALUE)); }, 0.5);
 
 	// Set text observers
 	for (size_t i = 0; i < TEXT_COUNT; ++i)
@@ -808,6 +831,8 @@ bool StateCompetition::Load()
 	m_texts[ENABLE_USER_VEHICLE_TEXT]->SetPosition({ FontContext::Component(1, true), {0}, {5} });
 	m_texts[USER_FITNESS_TEXT]->SetPosition({ FontContext::Component(1, true), {7}, {10} });
 	m_texts[ZOOM_TEXT]->SetPosition({ FontContext::Component(1), {0}, {3}, {8} });
+	m_texts[TIME_WARP_TEXT]->SetPosition({ FontContext::Component(2), {0}, {3}, {8} });
+	m_texts[THROUGHPUT_TEXT]->SetPosition({ FontContext::Component(3), {0}, {3} });
 
 	CoreLogger::PrintSuccess("StateCompetition dependencies loaded correctly");
 	return true;
@@ -853,12 +878,22 @@ void StateCompetition::Draw()
 			m_texts[NUMBER_OF_BOT_VEHICLES_TEXT]->Draw();
 			break;
 		case RUNNING_MODE:
-			m_simulatedWorld->Draw();
+			// Simulated world belongs to simulation thread, the newest snapshot is drawn instead
+			if (m_enableCheckpoints)
+				m_mapPrototype->DrawCheckpoints();
+			m_mapPrototype->DrawEdges();
+			m_drawableSnapshot.SetSnapshot(&m_snapshots.GetFront());
+			m_drawableSnapshot.Draw();
 			if (m_enableUserVehicle)
 				m_texts[USER_FITNESS_TEXT]->Draw();
 			m_texts[ZOOM_TEXT]->Draw();
+			m_texts[TIME_WARP_TEXT]->Draw();
+			m_texts[THROUGHPUT_TEXT]->Draw();
 			break;
 		case PAUSED_MODE:
+			if (m_enableCheckpoints)
+				m_mapPrototype->DrawCheckpoints();
+			m_mapPrototype->DrawEdges();
 			m_simulatedWorld->Draw();
 			if (m_enableUserVehicle)
 				m_texts[USER_FITNESS_TEXT]->Draw();
@@ -972,3 +1007,103 @@ std::string StateCompetition::GetUserVehicleName() const
 		return "None";
 	return std::string("Body \"") + m_userVehicleFilename + "\"";
 }
+
+bool StateCompetition::Simulate(double elapsedTime)
+{
+	// Calculate number of steps of this frame, only the final state of the frame is published
+	const bool frameBudget = m_timeWarp.IsFrameBudget();
+	size_t numberOfSteps = 0;
+	if (m_timeWarp.IsRealTime())
+		numberOfSteps = m_rateScheduler.Accumulate(elapsedTime);
+	else if (m_timeWarp.UpdateFrame(elapsedTime))
+		numberOfSteps = frameBudget ? std::numeric_limits<size_t>::max() : m_timeWarp.GetStepsPerFrame();
+
+	// Steps are performed in chunks of at most 1/60 of simulated second so that leader and user input
+	// are updated as often as in real time, in case of frame budget steps are performed until budget is used
+	const auto startTime = std::chrono::steady_clock::now();
+	const size_t stepsPerChunk = std::max<size_t>(1, m_rateScheduler.GetPhysicsRate() / 60);
+	size_t performedSteps = 0;
+	while (performedSteps < numberOfSteps)
+	{
+		const size_t chunk = std::min(stepsPerChunk, numberOfSteps - performedSteps);
+		SimulateSteps(chunk);
+		performedSteps += chunk;
+		if (frameBudget && std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >= TimeWarp::GetFrameBudget())
+			break;
+	}
+
+	m_timeWarp.MeasureThroughput(performedSteps, double(performedSteps) * m_rateScheduler.GetPhysicsTimeStep(), elapsedTime);
+	if (performedSteps)
+		PublishSnapshot();
+	return true;
+}
+
+void StateCompetition::SimulateSteps(size_t numberOfSteps)
+{
+	m_leaderIndex = m_fitnessSystem->MarkLeader(m_simulatedVehicles);
+	if (m_userVehicle && m_userVehicle->IsActive())
+	{
+		// Actuators are held by vehicle so they have to be set in every iteration
+		m_userVehicle->ResetActuators();
+		m_userVehicle->DriveForward(m_userDriveForward);
+		m_userVehicle->DriveBackward(m_userDriveBackward);
+		m_userVehicle->Turn(m_userTurn);
+	}
+
+	// Iterate over all bot vehicles, remember that in simulated vehicles
+	// the last vehicle is user vehicle
+	// Sensors and controllers are updated only on their ticks
+	const float timeStep = float(m_rateScheduler.GetPhysicsTimeStep());
+	for (size_t step = 0; step < numberOfSteps; ++step)
+	{
+		const bool sensorTick = m_rateScheduler.IsSensorTick();
+		const bool controllerTick = m_rateScheduler.IsControllerTick();
+		if (sensorTick)
+			m_simulatedWorld->UpdateSensors(m_rateScheduler.GetSensorTimeStep());
+
+		for (size_t i = 0; i < m_numberOfVehicles; ++i)
+		{
+			if (controllerTick && m_simulatedVehicles[i]->IsActive())
+			{
+				const NeuronLayer& input = m_simulatedVehicles[i]->ProcessOutput();
+				const NeuronLayer& output = m_artificialNeuralNetworks[i]->Update(input);
+				m_simulatedVehicles[i]->ProcessInput(output);
+			}
+
+			m_simulatedVehicles[i]->Update(timeStep);
+		}
+
+		if (m_userVehicle)
+			m_userVehicle->Update(timeStep);
+
+		m_simulatedWorld->Step(timeStep);
+		m_rateScheduler.Step();
+	}
+}
+
+void StateCompetition::PublishSnapshot()
+{
+	auto& snapshot = m_snapshots.GetBack();
+	m_simulatedWorld->Capture(snapshot);
+	snapshot.SetLeaderIndex(m_leaderIndex);
+	if (m_userVehicle)
+		snapshot.SetValue(USER_FITNESS_VALUE, m_fitnessSystem->ToFitnessRatio(m_userVehicle->GetFitness()));
+	snapshot.SetValue(SIMULATED_SECONDS_PER_SECOND_VALUE, m_timeWarp.GetSimulatedSecondsPerSecond());
+	snapshot.SetValue(STEPS_PER_SECOND_VALUE, m_timeWarp.GetStepsPerSecond());
+	m_snapshots.Publish();
+}
+
+void StateCompetition::StartSimulation()
+{
+	// Publish the first snapshot so that vehicles are ready before the first frame
+	m_timeWarp.Restart();
+	PublishSnapshot();
+	m_snapshots.Consume();
+	m_simulationThread.Start([this](double elapsedTime) { return Simulate(elapsedTime); });
+}
+
+void StateCompetition::StopSimulation()
+{
+	m_simulationThread.Stop();
+	m_snapshots.Consume();
+}
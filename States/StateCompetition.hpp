@@ -4,8 +4,14 @@
 #include "VehicleBuilder.hpp"
 #include "ArtificialNeuralNetworkBuilder.hpp"
 #include "ContinuousTimer.hpp"
+#include "RateScheduler.hpp"
 #include "Property.hpp"
 #include "SimulatedVehicle.hpp"
+#include "SimulationThread.hpp"
+#include "TimeWarp.hpp"
+#include "TripleBuffer.hpp"
+#include "SimulatedSnapshot.hpp"
+#include "DrawableSnapshot.hpp"
 
 class AbstractText;
 class ObserverInterface;
@@ -49,6 +55,21 @@ private:
 	// Returns user vehicle name
 	std::string GetUserVehicleName() const;
 
+	// Performs physics steps of one frame according to time warp, called by simulation thread
+	bool Simulate(double elapsedTime);
+
+	// Performs specified number of physics steps
+	void SimulateSteps(size_t numberOfSteps);
+
+	// Fills snapshot with current competition state and publishes it
+	void PublishSnapshot();
+
+	// Starts simulation thread
+	void StartSimulation();
+
+	// Stops simulation thread, simulation objects can be used again after this call
+	void StopSimulation();
+
 	// Modes
 	enum
 	{
@@ -131,6 +152,8 @@ private:
 	ContinuousTimer m_viewTimer;
 	const double m_viewMovementOffset;
 	ContinuousTimer m_pressedKeyTimer;
+	RateScheduler m_rateScheduler;
+	TimeWarp m_timeWarp;
 
 	// Objects of environment
 	SimulatedWorld* m_simulatedWorld;
@@ -146,6 +169,24 @@ private:
 	ArtificialNeuralNetworks m_artificialNeuralNetworks; // Bot anns
 	std::vector<std::string> m_botVehicleFilenames;
 	std::vector<std::string> m_botArtificialNeuralNetworkFilenames;
+	size_t m_leaderIndex;
+
+	// Simulation thread and snapshots handed over to the render thread
+	enum
+	{
+		USER_FITNESS_VALUE,
+		SIMULATED_SECONDS_PER_SECOND_VALUE,
+		STEPS_PER_SECOND_VALUE,
+		SNAPSHOT_VALUES_COUNT
+	};
+	SimulationThread m_simulationThread;
+	TripleBuffer<SimulatedSnapshot> m_snapshots;
+	DrawableSnapshot m_drawableSnapshot;
+
+	// User vehicle actuators set by render thread and read by simulation thread
+	std::atomic<double> m_userDriveForward;
+	std::atomic<double> m_userDriveBackward;
+	std::atomic<double> m_userTurn;
 
 	// Builders
 	MapBuilder m_mapBuilder;
@@ -166,6 +207,8 @@ private:
 		ENABLE_USER_VEHICLE_TEXT,
 		USER_FITNESS_TEXT,
 		ZOOM_TEXT,
+		TIME_WARP_TEXT,
+		THROUGHPUT_TEXT,
 		TEXT_COUNT
 	};
 	std::vector<AbstractText*> m_texts;
@@ -44,7 +44,6 @@ StateMapEditor::StateMapEditor() :
 	const auto allowedMapArea = m_mapBuilder.GetMaxAllowedMapArea();
 	const auto allowedViewArea = m_mapBuilder.GetMaxAllowedViewArea();
 	m_allowedMapAreaShape.setFillColor(ColorContext::ClearBackground);
-	m_allowedMapAreaShape.setOutlineColor(ColorContext::Create(ColorContext::ClearBackground, ColorContext::MaxChannelValue / 4));
 	m_allowedMapAreaShape.setOutlineThickness(5);
 	m_allowedMapAreaShape.setPosition(allowedMapArea.first);
 	m_allowedMapAreaShape.setSize(allowedMapArea.second);
@@ -514,6 +513,7 @@ void StateMapEditor::Draw()
 
 	m_mapPrototype.DrawEdges();
 
+	m_allowedMapAreaShape.setOutlineColor(ColorContext::Convert(ColorContext::Create(ColorContext::ClearBackground, ColorContext::MaxChannelValue / 4)));
 	CoreWindow::Draw(m_allowedMapAreaShape);
 
 	switch (m_mode)
@@ -3,12 +3,18 @@
 #include "FitnessSystem.hpp"
 #include "GeneticAlgorithm.hpp"
 #include "FunctionEventObserver.hpp"
+#include "FunctionTimerObserver.hpp"
 #include "TypeEventObserver.hpp"
 #include "FilenameText.hpp"
 #include "CoreLogger.hpp"
-#include "DrawableCheckpoint.hpp"
 #include "SimulatedWorld.hpp"
 #include "MapPrototype.hpp"
+#include "JobSystem.hpp"
+#include "CoreProfiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 
 StateSimulation::StateSimulation() :
 	m_population(12, 75, 1, 30),
@@ -21,12 +27,16 @@ StateSimulation::StateSimulation() :
 	m_numberOfParents(1, 10, 1, 2),
 	m_requiredFitnessImprovement(0.01, 0.2, 0.01, 0.05),
 	m_requiredFitnessImprovementRise(1.0, 15.0, 0.5, 3.0),
+	m_physicsRate(60, 1200, 60, 600),
+	m_sensorRate(5, 120, 5, 60),
+	m_controllerRate(5, 120, 5, 60),
+	m_dynamicsType(BOX2D_DYNAMICS, KINEMATIC_DYNAMICS, 1, BOX2D_DYNAMICS),
 	m_zoom(1.f, 4.f, 0.3f, 1.f),
 	m_zoomThreshold(m_zoom.Max()),
 	m_viewMovementOffset(3.0),
-	m_viewTimer(1.0, 0.2),
 	m_pressedKeyTimer(0.0, 1.0, 5000),
-	m_requiredFitnessImprovementRiseTimer(0.0, 0.0)
+	m_requiredFitnessImprovementRiseTimer(0.0, 0.0),
+	m_rateScheduler(m_physicsRate, m_sensorRate, m_controllerRate)
 {
 	// Initialize modes
 	m_modeStrings[STOPPED_MODE] = "Stopped";
@@ -38,11 +48,16 @@ StateSimulation::StateSimulation() :
 	m_fileFormatStrings[MAP_FILE_FORMAT] = "Map";
 	m_fileFormatStrings[ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT] = "Artificial Neural Network";
 	m_fileFormatStrings[VEHICLE_FILE_FORMAT] = "Vehicle";
+	m_fileFormatStrings[POPULATION_FILE_FORMAT] = "Population";
+	m_fileFormatStrings[REPLAY_FILE_FORMAT] = "Replay";
 	m_fileFormat = MAP_FILE_FORMAT;
 
 	// Initialize file formats in paused mode
 	m_fileFormatPausedStrings[ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT_PAUSED] = "Artificial Neural Network";
 	m_fileFormatPausedStrings[STATISTICS_FILE_FORMAT_PAUSED] = "Statistics";
+	m_fileFormatPausedStrings[POPULATION_FILE_FORMAT_PAUSED] = "Population";
+	m_fileFormatPausedStrings[LINEAGE_FILE_FORMAT_PAUSED] = "Lineage";
+	m_fileFormatPausedStrings[REPLAY_FILE_FORMAT_PAUSED] = "Replay";
 	m_fileFormatPaused = ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT_PAUSED;
 
 	// Initialize parameter types
@@ -56,6 +71,10 @@ StateSimulation::StateSimulation() :
 	m_parameterTypesStrings[NUMBER_OF_PARENTS] = "Number of parents";
 	m_parameterTypesStrings[REQUIRED_FITNESS_IMPROVEMENT_RISE] = "Required fitness improvement rise";
 	m_parameterTypesStrings[REQUIRED_FITNESS_IMPROVEMENT] = "Required fitness improvement";
+	m_parameterTypesStrings[PHYSICS_RATE] = "Physics rate";
+	m_parameterTypesStrings[SENSOR_RATE] = "Sensor rate";
+	m_parameterTypesStrings[CONTROLLER_RATE] = "Controller rate";
+	m_parameterTypesStrings[DYNAMICS_TYPE] = "Vehicle dynamics";
 	m_parameterType = POPULATION_SIZE;
 
 	// Initialize control keys
@@ -66,6 +85,10 @@ StateSimulation::StateSimulation() :
 	m_controlKeys.insert(std::pair(sf::Keyboard::Subtract, DECREASE_PARAMETER));
 	m_controlKeys.insert(std::pair(sf::Keyboard::Multiply, INCREASE_ZOOM));
 	m_controlKeys.insert(std::pair(sf::Keyboard::Divide, DECREASE_ZOOM));
+	m_controlKeys.insert(std::pair(sf::Keyboard::C, CHANGE_CAPTURE_MODE));
+	m_controlKeys.insert(std::pair(sf::Keyboard::T, CHANGE_TRACE_STATE));
+	m_controlKeys.insert(std::pair(sf::Keyboard::Left, SEEK_REPLAY_BACKWARD));
+	m_controlKeys.insert(std::pair(sf::Keyboard::Right, SEEK_REPLAY_FORWARD));
 
 	for (auto & pressedKey : m_pressedKeys)
 		pressedKey = false;
@@ -76,6 +99,7 @@ StateSimulation::StateSimulation() :
 	m_internalErrorsStrings[ERROR_NO_VEHICLE_SPECIFIED] = "Error: No vehicle is specified!";
 	m_internalErrorsStrings[ERROR_VEHICLE_IS_IN_A_COLLISION_WITH_EDGES_CHAIN] = "Error: Vehicle is in a collision with edges chain!";
 	m_internalErrorsStrings[ERROR_ARTIFICIAL_NEURAL_NETWORK_INPUT_MISMATCH] = "Error: Artificial neural network number of input neurons mismatches number of vehicle sensors!";
+	m_internalErrorsStrings[ERROR_REPLAY_MAP_OR_VEHICLE_MISMATCH] = "Error: Replay was recorded with different map or vehicle!";
 
 	// Initialize timers
 	m_pressedKeyTimer.MakeTimeout();
@@ -83,9 +107,12 @@ StateSimulation::StateSimulation() :
 
 	// Initialize objects of environment
 	m_geneticAlgorithm = nullptr;
+	m_lineageStore = nullptr;
 	m_artificialNeuralNetworks.resize(m_population, nullptr);
 	m_simulatedWorld = nullptr;
 	m_fitnessSystem = nullptr;
+	m_leaderIndex = 0;
+	m_replayLoaded = false;
 
 	// Initialize prototypes
 	m_artificialNeuralNetworkPrototype = nullptr;
@@ -99,7 +126,9 @@ StateSimulation::StateSimulation() :
 
 StateSimulation::~StateSimulation()
 {
+	m_simulationThread.Stop();
 	delete m_geneticAlgorithm;
+	delete m_lineageStore;
 	for (const auto& artificialNeuralNetwork : m_artificialNeuralNetworks)
 		delete artificialNeuralNetwork;
 	delete m_simulatedWorld;
@@ -115,6 +144,11 @@ StateSimulation::~StateSimulation()
 
 void StateSimulation::Reload()
 {
+	// Stop simulation thread before simulation objects are removed
+	m_simulationThread.Stop();
+	m_statisticsWriter.Stop();
+	m_drawableSnapshot.Clear();
+
 	// Reset states
 	m_mode = STOPPED_MODE;
 	m_fileFormat = MAP_FILE_FORMAT;
@@ -135,18 +169,27 @@ void StateSimulation::Reload()
 	m_numberOfParents.ResetValue();
 	m_requiredFitnessImprovement.ResetValue();
 	m_requiredFitnessImprovementRise.ResetValue();
+	m_physicsRate.ResetValue();
+	m_sensorRate.ResetValue();
+	m_controllerRate.ResetValue();
+	m_dynamicsType.ResetValue();
 	m_zoom.ResetValue();
 	m_zoomThreshold = m_zoom.Max();
+	m_timeWarp.Reset();
+	m_frameCapture.Reset();
+	CoreProfiler::Reset();
 
 	// Reset timers
-	m_viewTimer.Reset();
 	m_pressedKeyTimer.MakeTimeout();
 	m_requiredFitnessImprovementRiseTimer.SetTimeout(m_requiredFitnessImprovementRise);
 	m_requiredFitnessImprovementRiseTimer.Reset();
+	m_rateScheduler.SetRates(m_physicsRate, m_sensorRate, m_controllerRate);
 
 	// Reset objects of environment
 	delete m_geneticAlgorithm;
 	m_geneticAlgorithm = nullptr;
+	delete m_lineageStore;
+	m_lineageStore = nullptr;
 	for (auto& artificialNeuralNetwork : m_artificialNeuralNetworks)
 	{
 		delete artificialNeuralNetwork;
@@ -158,6 +201,9 @@ void StateSimulation::Reload()
 	delete m_fitnessSystem;
 	m_fitnessSystem = nullptr;
 	m_simulatedVehicles.clear();
+	m_replayPlayer.Stop();
+	m_replayRecorder.Clear();
+	m_replayLoaded = false;
 
 	// Reset prototypes
 	delete m_artificialNeuralNetworkPrototype;
@@ -206,6 +252,13 @@ void StateSimulation::Capture()
 								if (m_pressedKeys[iterator->second])
 									break;
 
+								// Loaded replay is played instead of training
+								if (m_replayLoaded)
+								{
+									StartReplay();
+									break;
+								}
+
 								StatusText* modeText = static_cast<StatusText*>(m_texts[MODE_TEXT]);
 								if (!m_artificialNeuralNetworkPrototype)
 								{
@@ -262,11 +315,10 @@ void StateSimulation::Capture()
 
 								// Create simulated world
 								delete m_simulatedWorld;
-								m_simulatedWorld = new SimulatedWorld;
+								m_simulatedWorld = new SimulatedWorld(m_dynamicsType);
 								m_simulatedWorld->AddMap(m_mapPrototype);
 								if (m_deathOnEdgeContact)
 									m_simulatedWorld->EnableDeathOnEdgeContact();
-								DrawableCheckpoint::SetVisibility(false);
 
 								// Initialize fitness system
 								delete m_fitnessSystem;
@@ -276,7 +328,7 @@ void StateSimulation::Capture()
 								m_textObservers[BEST_TIME_TEXT]->Notify();
 								m_textObservers[BEST_TIME_OVERALL_TEXT]->Notify();
 								m_textObservers[CURRENT_POPULATION_TEXT]->Notify();
-								m_simulatedWorld->AddBeginContactFunction(m_fitnessSystem->GetBeginContactFunction());
+								m_simulatedWorld->AddCheckpointFunction(m_fitnessSystem->GetCheckpointFunction());
 
 								// Create vehicles
 								m_simulatedVehicles.resize(m_population, nullptr);
@@ -311,9 +363,30 @@ void StateSimulation::Capture()
 								);
 								m_textObservers[CURRENT_GENERATION_TEXT]->Notify();
 
+								// Record lineage of the whole run
+								delete m_lineageStore;
+								m_lineageStore = new LineageStore<Neuron>(m_artificialNeuralNetworkPrototype->GetNumberOfWeights(),
+									m_population,
+									m_numberOfParents,
+									m_crossoverType);
+								m_geneticAlgorithm->SetLineageStore(m_lineageStore);
+
 								// Set first individual in genetic algorithm (this one may be already optimized)
 								m_artificialNeuralNetworks[0]->GetRawData(m_geneticAlgorithm->GetIndividualGenes(0));
 
+								// Seed population with archived individuals, they are copied straight from the mapped file
+								if (m_populationArchive.IsOpen() && m_populationArchive.GetNumberOfWeights() == m_artificialNeuralNetworkPrototype->GetNumberOfWeights())
+								{
+									const size_t numberOfArchivedIndividuals = std::min<size_t>(m_populationArchive.GetNumberOfIndividuals(), m_population);
+									for (size_t i = 0; i < numberOfArchivedIndividuals; ++i)
+									{
+										const Neuron* individual = m_populationArchive.GetIndividual(i);
+										std::copy(individual, individual + m_populationArchive.GetNumberOfWeights(), m_geneticAlgorithm->GetIndividualGenes(i));
+									}
+									m_artificialNeuralNetworks[0]->SetFromRawData(m_geneticAlgorithm->GetIndividualGenes(0));
+								}
+								m_populationArchive.Close();
+
 								// Reset artificial neural networks except first one
 								for (size_t i = 1; i < m_artificialNeuralNetworks.size(); ++i)
 									m_artificialNeuralNetworks[i]->SetFromRawData(m_geneticAlgorithm->GetIndividualGenes(i));
@@ -321,6 +394,23 @@ void StateSimulation::Capture()
 								// Reset required fitness improvement rise timer
 								m_requiredFitnessImprovementRiseTimer.Reset();
 								m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT]->Notify();
+
+								// Set physics, sensor and controller rates
+								m_rateScheduler.SetRates(m_physicsRate, m_sensorRate, m_controllerRate);
+
+								// Record the best vehicle of every generation
+								SimulatedReplayRecorder::Settings replaySettings;
+								replaySettings.m_mapHash = SimulatedReplayRecorder::CalculateMapHash(m_mapPrototype);
+								replaySettings.m_vehicleHash = SimulatedReplayRecorder::CalculateVehicleHash(m_vehiclePrototype);
+								replaySettings.m_seed = m_geneticAlgorithm->GetSeed();
+								replaySettings.m_dynamicsType = m_dynamicsType;
+								replaySettings.m_deathOnEdgeContact = m_deathOnEdgeContact;
+								replaySettings.m_physicsRate = m_rateScheduler.GetPhysicsRate();
+								replaySettings.m_sensorInterval = m_rateScheduler.GetSensorInterval();
+								replaySettings.m_controllerInterval = m_rateScheduler.GetControllerInterval();
+								m_replayRecorder.Start(replaySettings);
+								m_replayRecorder.BeginGeneration(m_population);
+
 								m_mode = RUNNING_MODE;
 								m_textObservers[MODE_TEXT]->Notify();
 
@@ -329,6 +419,15 @@ void StateSimulation::Capture()
 									m_fitnessSystem,
 									m_deathOnEdgeContact,
 									m_requiredFitnessImprovementRise);
+
+								// Stream statistics of this run
+								if (m_statisticsWriter.Start(StatisticsWriter::MakeFilename("statistics")))
+									CoreLogger::PrintSuccess("Statistics of every generation are streamed to a file");
+
+								// Run simulation in its own thread
+								m_leaderIndex = 0;
+								m_drawableSnapshot.Clear();
+								StartSimulation();
 								break;
 							}
 							case CHANGE_FILENAME_TYPE:
@@ -395,6 +494,22 @@ void StateSimulation::Capture()
 										m_requiredFitnessImprovementRiseTimer.SetTimeout(m_requiredFitnessImprovementRise);
 										m_textObservers[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT]->Notify();
 										break;
+									case PHYSICS_RATE:
+										m_physicsRate.Increase();
+										m_textObservers[PHYSICS_RATE_TEXT]->Notify();
+										break;
+									case SENSOR_RATE:
+										m_sensorRate.Increase();
+										m_textObservers[SENSOR_RATE_TEXT]->Notify();
+										break;
+									case CONTROLLER_RATE:
+										m_controllerRate.Increase();
+										m_textObservers[CONTROLLER_RATE_TEXT]->Notify();
+										break;
+									case DYNAMICS_TYPE:
+										m_dynamicsType.Increase();
+										m_textObservers[DYNAMICS_TYPE_TEXT]->Notify();
+										break;
 								}
 
 								break;
@@ -447,6 +562,22 @@ void StateSimulation::Capture()
 										m_requiredFitnessImprovementRiseTimer.SetTimeout(m_requiredFitnessImprovementRise);
 										m_textObservers[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT]->Notify();
 										break;
+									case PHYSICS_RATE:
+										m_physicsRate.Decrease();
+										m_textObservers[PHYSICS_RATE_TEXT]->Notify();
+										break;
+									case SENSOR_RATE:
+										m_sensorRate.Decrease();
+										m_textObservers[SENSOR_RATE_TEXT]->Notify();
+										break;
+									case CONTROLLER_RATE:
+										m_controllerRate.Decrease();
+										m_textObservers[CONTROLLER_RATE_TEXT]->Notify();
+										break;
+									case DYNAMICS_TYPE:
+										m_dynamicsType.Decrease();
+										m_textObservers[DYNAMICS_TYPE_TEXT]->Notify();
+										break;
 								}
 
 								break;
@@ -454,6 +585,12 @@ void StateSimulation::Capture()
 							case INCREASE_ZOOM:
 							case DECREASE_ZOOM:
 								break;
+							case CHANGE_CAPTURE_MODE:
+								if (m_pressedKeys[iterator->second])
+									break;
+								m_frameCapture.ChangeMode();
+								m_textObservers[CAPTURE_TEXT]->Notify();
+								break;
 						}
 
 						m_pressedKeys[iterator->second] = true;
@@ -484,6 +621,7 @@ void StateSimulation::Capture()
 									break;
 								m_mode = STOPPED_MODE;
 								m_textObservers[MODE_TEXT]->Notify();
+								m_statisticsWriter.Stop();
 
 								// Reset view so that the center is vehicle starting position
 								m_zoom.ResetValue();
@@ -513,6 +651,7 @@ void StateSimulation::Capture()
 								m_textObservers[MODE_TEXT]->Notify();
 								m_fileFormatPaused = ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT_PAUSED;
 								m_textObservers[FILE_FORMAT_PAUSED_TEXT]->Notify();
+								StartSimulation();
 								break;
 							}
 							case INCREASE_PARAMETER:
@@ -547,8 +686,11 @@ void StateSimulation::Capture()
 					{
 						if (m_pressedKeys[iterator->second])
 							break;
+						StopSimulation();
+						m_replayPlayer.Stop();
 						m_mode = STOPPED_MODE;
 						m_textObservers[MODE_TEXT]->Notify();
+						m_statisticsWriter.Stop();
 
 						// Reset view so that the center is vehicle starting position
 						m_zoom.ResetValue();
@@ -561,14 +703,24 @@ void StateSimulation::Capture()
 						break;
 					case PAUSED_CHANGE_MODE:
 					{
-						if (m_pressedKeys[iterator->second])
+						if (m_pressedKeys[iterator->second] || m_replayPlayer.IsStarted())
 							break;
+						StopSimulation();
 						m_mode = PAUSED_MODE;
 						m_textObservers[MODE_TEXT]->Notify();
 						break;
 					}
 					case INCREASE_PARAMETER:
+						if (m_pressedKeys[iterator->second])
+							break;
+						m_timeWarp.Increase();
+						m_textObservers[TIME_WARP_TEXT]->Notify();
+						break;
 					case DECREASE_PARAMETER:
+						if (m_pressedKeys[iterator->second])
+							break;
+						m_timeWarp.Decrease();
+						m_textObservers[TIME_WARP_TEXT]->Notify();
 						break;
 					case INCREASE_ZOOM:
 						if (m_pressedKeyTimer.Update())
@@ -592,6 +744,34 @@ void StateSimulation::Capture()
 							m_textObservers[ZOOM_TEXT]->Notify();
 						}
 						break;
+					case CHANGE_CAPTURE_MODE:
+						if (m_pressedKeys[iterator->second])
+							break;
+						m_frameCapture.ChangeMode();
+						m_textObservers[CAPTURE_TEXT]->Notify();
+						break;
+					case CHANGE_TRACE_STATE:
+						if (m_pressedKeys[iterator->second])
+							break;
+						CoreProfiler::ChangeState();
+						m_textObservers[TRACE_TEXT]->Notify();
+						break;
+					case SEEK_REPLAY_BACKWARD:
+					case SEEK_REPLAY_FORWARD:
+					{
+						if (m_pressedKeys[iterator->second] || !m_replayPlayer.IsStarted())
+							break;
+
+						// Replay is moved to the previous or to the next keyframe
+						StopSimulation();
+						const size_t keyframeIndex = m_replayPlayer.GetKeyframeIndex();
+						if (iterator->second == SEEK_REPLAY_FORWARD)
+							m_replayPlayer.Seek(keyframeIndex + 1);
+						else if (keyframeIndex > 0)
+							m_replayPlayer.Seek(keyframeIndex - 1);
+						StartSimulation();
+						break;
+					}
 					default:
 						break;
 				}
@@ -630,6 +810,7 @@ void StateSimulation::Capture()
 
 void StateSimulation::Update()
 {
+	PROFILE_ZONE("StateSimulation::Update");
 	switch (m_mode)
 	{
 		case STOPPED_MODE:
@@ -691,6 +872,63 @@ void StateSimulation::Update()
 						delete m_artificialNeuralNetworkPrototype;
 						m_artificialNeuralNetworkPrototype = m_artificialNeuralNetworkBuilder.Get();
 						m_artificialNeuralNetworkPrototype->SetFromRawData(m_artificialNeuralNetworkBuilder.GetRawNeuronData());
+						m_populationArchive.Close();
+						m_replayLoaded = false;
+						break;
+					}
+					case POPULATION_FILE_FORMAT:
+					{
+						bool success = m_populationArchive.Open(filenameText->GetFilename());
+						auto status = m_populationArchive.GetLastOperationStatus();
+						if (success && !m_populationArchive.GetNumberOfIndividuals())
+						{
+							m_populationArchive.Close();
+							success = false;
+							status.second = "Error: population archive is empty!";
+						}
+
+						// Topology is validated by the builder, the first individual becomes the prototype
+						if (success)
+						{
+							const Neuron* firstIndividual = m_populationArchive.GetIndividual(0);
+							m_artificialNeuralNetworkBuilder.Clear();
+							m_artificialNeuralNetworkBuilder.SetNeuronLayerSizes(m_populationArchive.GetNeuronLayerSizes());
+							m_artificialNeuralNetworkBuilder.SetActivationFunctionIndexes(m_populationArchive.GetActivationFunctionIndexes());
+							m_artificialNeuralNetworkBuilder.SetBiasVector(m_populationArchive.GetBiasVector());
+							m_artificialNeuralNetworkBuilder.SetRawNeuronData(NeuronLayer(firstIndividual, firstIndividual + m_populationArchive.GetNumberOfWeights()));
+							auto* artificialNeuralNetwork = m_artificialNeuralNetworkBuilder.Get();
+							if (!artificialNeuralNetwork)
+							{
+								m_populationArchive.Close();
+								success = false;
+								status = m_artificialNeuralNetworkBuilder.GetLastOperationStatus();
+							}
+							else
+							{
+								delete m_artificialNeuralNetworkPrototype;
+								m_artificialNeuralNetworkPrototype = artificialNeuralNetwork;
+								m_artificialNeuralNetworkPrototype->SetFromRawData(firstIndividual);
+								m_replayLoaded = false;
+							}
+						}
+
+						// Set filename text
+						if (!success)
+							filenameText->SetErrorStatusText(status.second);
+						else
+							filenameText->SetSuccessStatusText(status.second);
+						break;
+					}
+					case REPLAY_FILE_FORMAT:
+					{
+						// Replays are played instead of training until artificial neural network or population is loaded
+						m_replayLoaded = m_replayRecorder.Load(filenameText->GetFilename()) && !m_replayRecorder.GetReplays().empty();
+
+						// Set filename text
+						if (!m_replayLoaded)
+							filenameText->SetErrorStatusText("Error: cannot read replays, file does not exist or is corrupted!");
+						else
+							filenameText->SetSuccessStatusText("Success: correctly loaded replays of " + std::to_string(m_replayRecorder.GetReplays().size()) + " generations!");
 						break;
 					}
 					case VEHICLE_FILE_FORMAT:
@@ -737,94 +975,48 @@ void StateSimulation::Update()
 		}
 		case RUNNING_MODE:
 		{
-			bool activity = false;
-			for (size_t i = 0; i < m_population; ++i)
+			// Simulation is performed by simulation thread, here only the newest snapshot is taken
+			const bool consumed = ConsumeSnapshot();
+			const auto& snapshot = m_snapshots.GetFront();
+			if (snapshot.IsFinished() && m_replayPlayer.IsStarted())
 			{
-				m_simulatedVehicles[i]->Update(m_simulatedWorld->GetEdgesWorld());
-				if (!m_simulatedVehicles[i]->IsActive())
-					continue;
-				activity = true;
-				const NeuronLayer& input = m_simulatedVehicles[i]->ProcessOutput();
-				const NeuronLayer& output = m_artificialNeuralNetworks[i]->Update(input);
-				m_simulatedVehicles[i]->ProcessInput(output);
+				// Replay has ended
+				StopSimulation();
+				m_replayPlayer.Stop();
+				m_mode = STOPPED_MODE;
+				m_textObservers[MODE_TEXT]->Notify();
+
+				// Reset view so that the center is vehicle starting position
+				m_zoom.ResetValue();
+				m_textObservers[ZOOM_TEXT]->Notify();
+				CoreWindow::Reset();
+				CoreWindow::SetViewCenter(m_vehiclePrototype->GetCenter());
+				break;
 			}
 
-			m_simulatedWorld->Update();
-
-			sf::Vector2f m_viewCenter;
-			if (!activity)
+			if (snapshot.IsFinished())
 			{
-				// Set highest fitness overall
-				m_fitnessSystem->Iterate(m_simulatedVehicles);
-				m_textObservers[HIGHEST_FITNESS_OVERALL_TEXT]->Notify();
-				m_textObservers[BEST_TIME_OVERALL_TEXT]->Notify();
-
-				// Generate new generation
-				if (m_geneticAlgorithm->Iterate(m_fitnessSystem->GetFitnessVector()))
-				{
-					m_textObservers[CURRENT_GENERATION_TEXT]->Notify();
-					m_textObservers[CURRENT_POPULATION_TEXT]->Notify();
-					m_textObservers[MEAN_REQUIRED_FITNESS_IMPROVEMENT]->Notify();
-
-					// Set artificial neural networks new raw data
-					for (size_t i = 0; i < m_artificialNeuralNetworks.size(); ++i)
-						m_artificialNeuralNetworks[i]->SetFromRawData(m_geneticAlgorithm->GetIndividualGenes(i));
-
-					// Reset simulated world
-					delete m_simulatedWorld;
-					m_simulatedWorld = new SimulatedWorld;
-					m_simulatedWorld->AddMap(m_mapPrototype);
-					if (m_deathOnEdgeContact)
-						m_simulatedWorld->EnableDeathOnEdgeContact();
-					DrawableCheckpoint::SetVisibility(false);
-					m_fitnessSystem->Reset();
-					m_simulatedWorld->AddBeginContactFunction(m_fitnessSystem->GetBeginContactFunction());
-
-					// Reset vehicles
-					for (auto& vehicle : m_simulatedVehicles)
-						vehicle = m_simulatedWorld->AddVehicle(m_vehiclePrototype);
-
-					// Reset required fitness improvement rise timer
-					m_requiredFitnessImprovementRiseTimer.Reset();
-					m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT]->Notify();
-				}
-				else
-				{
-					m_mode = PAUSED_MODE;
-					m_textObservers[MODE_TEXT]->Notify();
-					delete m_geneticAlgorithm;
-					m_geneticAlgorithm = nullptr;
-				}
+				// There are no more generations
+				StopSimulation();
+				m_statisticsWriter.Stop();
+				m_mode = PAUSED_MODE;
+				m_textObservers[MODE_TEXT]->Notify();
+				delete m_geneticAlgorithm;
+				m_geneticAlgorithm = nullptr;
+				break;
 			}
-			else
-			{
-				if (m_viewTimer.Update())
-				{
-					const auto index = m_fitnessSystem->MarkLeader(m_simulatedVehicles);
-					m_viewCenter = m_simulatedVehicles[index]->GetCenter();
-					m_textObservers[HIGHEST_FITNESS_TEXT]->Notify();
-					m_textObservers[BEST_TIME_TEXT]->Notify();
-				}
-
-				if (m_requiredFitnessImprovementRiseTimer.Update())
-				{
-					m_fitnessSystem->Punish(m_simulatedVehicles);
-					m_textObservers[CURRENT_POPULATION_TEXT]->Notify();
-					m_textObservers[MEAN_REQUIRED_FITNESS_IMPROVEMENT]->Notify();
-					m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT]->Notify();
-				}
-				else if (size_t(m_requiredFitnessImprovementRiseTimer.GetValue() * 100) % 25 == 0)
-					m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT]->Notify(); // Notify every 0.25 seconds
 
-				m_fitnessSystem->UpdateTimers(m_simulatedVehicles);
-			}
+			// Every new snapshot of selected generation is captured off-screen
+			if (consumed)
+				m_frameCapture.Capture(m_mapPrototype, m_drawableSnapshot, snapshot, size_t(snapshot.GetValue(CURRENT_GENERATION_VALUE)));
 
-			// Update view
-			if (m_zoom < m_zoomThreshold)
+			// Update view, follow the leader
+			if (m_zoom < m_zoomThreshold && snapshot.GetLeaderIndex() < snapshot.GetNumberOfVehicles())
 			{
+				const auto& leaderCenter = snapshot.GetCenter(snapshot.GetLeaderIndex());
 				auto viewCenter = CoreWindow::GetViewCenter();
-				const auto distance = MathContext::Distance(viewCenter, m_viewCenter);
-				const auto angle = MathContext::DifferenceVectorAngle(viewCenter, m_viewCenter);
+				const auto distance = MathContext::Distance(viewCenter, leaderCenter);
+				const auto angle = MathContext::DifferenceVectorAngle(viewCenter, leaderCenter);
 				viewCenter = MathContext::GetEndPoint(viewCenter, angle, float(-distance * m_viewMovementOffset * CoreWindow::GetElapsedTime()));
 				CoreWindow::SetViewCenter(viewCenter);
 			}
@@ -855,6 +1047,58 @@ void StateSimulation::Update()
 							filenameText->SetSuccessStatusText(status.second);
 						break;
 					}
+					case POPULATION_FILE_FORMAT_PAUSED:
+					{
+						// Whole population is appended to existing archive, archive with different topology is not overwritten
+						m_artificialNeuralNetworkBuilder.Clear();
+						m_artificialNeuralNetworkBuilder.Set(m_artificialNeuralNetworks[0]);
+						const auto filename = filenameText->GetFilename();
+						const auto& neuronLayerSizes = m_artificialNeuralNetworkBuilder.GetNeuronLayerSizes();
+						const auto& activationFunctionIndexes = m_artificialNeuralNetworkBuilder.GetActivationFunctionIndexes();
+						const auto& biasVector = m_artificialNeuralNetworkBuilder.GetBiasVector();
+						PopulationArchive populationArchive;
+						bool success = std::ifstream(filename).is_open() ?
+							populationArchive.OpenForAppending(filename, neuronLayerSizes, activationFunctionIndexes, biasVector) :
+							populationArchive.Create(filename, neuronLayerSizes, activationFunctionIndexes, biasVector);
+						if (success)
+						{
+							const size_t numberOfWeights = m_artificialNeuralNetworks[0]->GetNumberOfWeights();
+							NeuronLayer individuals(m_artificialNeuralNetworks.size() * numberOfWeights);
+							for (size_t i = 0; i < m_artificialNeuralNetworks.size(); ++i)
+								m_artificialNeuralNetworks[i]->GetRawData(&individuals[i * numberOfWeights]);
+							success = populationArchive.Append(individuals.data(), m_artificialNeuralNetworks.size());
+						}
+						const auto status = populationArchive.GetLastOperationStatus();
+
+						// Set filename text
+						if (!success)
+							filenameText->SetErrorStatusText(status.second);
+						else
+							filenameText->SetSuccessStatusText(status.second);
+						break;
+					}
+					case LINEAGE_FILE_FORMAT_PAUSED:
+					{
+						// Set filename text
+						if (!m_lineageStore || m_lineageStore->IsEmpty())
+							filenameText->SetErrorStatusText("Error: there is no lineage to save!");
+						else if (!m_lineageStore->Save(filenameText->GetFilename()))
+							filenameText->SetErrorStatusText("Error: cannot open file for writing!");
+						else
+							filenameText->SetSuccessStatusText("Success: correctly saved lineage of " + std::to_string(m_lineageStore->GetNumberOfGenerations()) + " generations!");
+						break;
+					}
+					case REPLAY_FILE_FORMAT_PAUSED:
+					{
+						// Set filename text
+						if (m_replayRecorder.GetReplays().empty())
+							filenameText->SetErrorStatusText("Error: there are no replays to save!");
+						else if (!m_replayRecorder.Save(filenameText->GetFilename()))
+							filenameText->SetErrorStatusText("Error: cannot open file for writing!");
+						else
+							filenameText->SetSuccessStatusText("Success: correctly saved replays of " + std::to_string(m_replayRecorder.GetReplays().size()) + " generations!");
+						break;
+					}
 					case STATISTICS_FILE_FORMAT_PAUSED:
 					{
 						m_statisticsBuilder.Extract(m_geneticAlgorithm ? m_geneticAlgorithm->GetCurrentGeneration() : m_generation,
@@ -902,6 +1146,10 @@ bool StateSimulation::Load()
 	m_texts[NUMBER_OF_PARENTS_TEXT] = new DoubleText({ m_parameterTypesStrings[NUMBER_OF_PARENTS] + ":" });
 	m_texts[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT] = new DoubleText({ m_parameterTypesStrings[REQUIRED_FITNESS_IMPROVEMENT_RISE] + ":" });
 	m_texts[REQUIRED_FITNESS_IMPROVEMENT_TEXT] = new DoubleText({ m_parameterTypesStrings[REQUIRED_FITNESS_IMPROVEMENT] + ":" });
+	m_texts[PHYSICS_RATE_TEXT] = new DoubleText({ m_parameterTypesStrings[PHYSICS_RATE] + ":" });
+	m_texts[SENSOR_RATE_TEXT] = new DoubleText({ m_parameterTypesStrings[SENSOR_RATE] + ":" });
+	m_texts[CONTROLLER_RATE_TEXT] = new DoubleText({ m_parameterTypesStrings[CONTROLLER_RATE] + ":" });
+	m_texts[DYNAMICS_TYPE_TEXT] = new DoubleText({ m_parameterTypesStrings[DYNAMICS_TYPE] + ":" });
 	m_texts[CURRENT_POPULATION_TEXT] = new DoubleText({ "Current population size:" });
 	m_texts[CURRENT_GENERATION_TEXT] = new DoubleText({ "Current generation:" });
 	m_texts[HIGHEST_FITNESS_TEXT] = new DoubleText({ "Highest fitness:" });
@@ -911,6 +1159,11 @@ bool StateSimulation::Load()
 	m_texts[ZOOM_TEXT] = new TripleText({ "Zoom:", "", "| [/] [*]" });
 	m_texts[BEST_TIME_TEXT] = new DoubleText({ "Best time:" });
 	m_texts[BEST_TIME_OVERALL_TEXT] = new DoubleText({ "Best time overall:" });
+	m_texts[TIME_WARP_TEXT] = new TripleText({ "Time warp:", "", "| [+] [-]" });
+	m_texts[THROUGHPUT_TEXT] = new DoubleText({ "Throughput:" });
+	m_texts[CAPTURE_TEXT] = new TripleText({ "Capture:", "", "| [C]" });
+	m_texts[TRACE_TEXT] = new TripleText({ "Trace:", "", "| [T]" });
+	m_texts[REPLAY_TEXT] = new TripleText({ "Replay:", "", "| [Left] [Right]" });
 
 	// Create observers
 	m_textObservers[MODE_TEXT] = new FunctionEventObserver<std::string>([&] { return m_modeStrings[m_mode]; });
@@ -927,15 +1180,24 @@ bool StateSimulation::Load()
 	m_textObservers[NUMBER_OF_PARENTS_TEXT] = new FunctionEventObserver<size_t>([&] { return m_numberOfParents; });
 	m_textObservers[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(m_requiredFitnessImprovementRiseTimer.GetTimeout()) + " seconds"; });
 	m_textObservers[REQUIRED_FITNESS_IMPROVEMENT_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_requiredFitnessImprovement * 100.0)); }, "", "%");
-	m_textObservers[CURRENT_POPULATION_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(m_fitnessSystem ? (m_population - m_fitnessSystem->GetNumberOfPunishedVehicles()) : m_population) + "/" + std::to_string(m_population); });
-	m_textObservers[CURRENT_GENERATION_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(m_geneticAlgorithm ? m_geneticAlgorithm->GetCurrentGeneration() : m_generation) + "/" + std::to_string(m_generation); });
-	m_textObservers[HIGHEST_FITNESS_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(!m_fitnessSystem ? 0 : size_t(m_fitnessSystem->GetHighestFitnessRatio())); }, "", "%");
-	m_textObservers[HIGHEST_FITNESS_OVERALL_TEXT] = new FunctionEventObserver<std::string>([&] { return !m_fitnessSystem || (m_geneticAlgorithm && m_geneticAlgorithm->GetCurrentGeneration() == 0) ? "Unknown" : std::to_string(size_t(m_fitnessSystem->GetHighestFitnessOverallRatio())) + "%"; });
-	m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(m_requiredFitnessImprovementRiseTimer.GetTimeout() - m_requiredFitnessImprovementRiseTimer.GetValue()); }, "", " seconds");
-	m_textObservers[MEAN_REQUIRED_FITNESS_IMPROVEMENT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t((m_fitnessSystem ? m_fitnessSystem->GetMeanRequiredFitnessImprovementRatio() : 0))); }, "", "%");
+	m_textObservers[PHYSICS_RATE_TEXT] = new FunctionEventObserver<size_t>([&] { return m_physicsRate; }, "", " Hz");
+	m_textObservers[SENSOR_RATE_TEXT] = new FunctionEventObserver<size_t>([&] { return m_sensorRate; }, "", " Hz");
+	m_textObservers[CONTROLLER_RATE_TEXT] = new FunctionEventObserver<size_t>([&] { return m_controllerRate; }, "", " Hz");
+	m_textObservers[DYNAMICS_TYPE_TEXT] = new FunctionEventObserver<std::string>([&] { return DynamicsTypeStrings[m_dynamicsType]; });
+	m_textObservers[CURRENT_POPULATION_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_snapshots.GetFront().GetValue(CURRENT_POPULATION_VALUE))) + "/" + std::to_string(m_population); });
+	m_textObservers[CURRENT_GENERATION_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_snapshots.GetFront().GetValue(CURRENT_GENERATION_VALUE))) + "/" + std::to_string(m_generation); });
+	m_textObservers[HIGHEST_FITNESS_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_snapshots.GetFront().GetValue(HIGHEST_FITNESS_VALUE))); }, "", "%");
+	m_textObservers[HIGHEST_FITNESS_OVERALL_TEXT] = new FunctionEventObserver<std::string>([&] { const double value = m_snapshots.GetFront().GetValue(HIGHEST_FITNESS_OVERALL_VALUE); return value < 0.0 ? "Unknown" : std::to_string(size_t(value)) + "%"; });
+	m_textObservers[RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(m_snapshots.GetFront().GetValue(RAISING_REQUIRED_FITNESS_IMPROVEMENT_VALUE)); }, "", " seconds");
+	m_textObservers[MEAN_REQUIRED_FITNESS_IMPROVEMENT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_snapshots.GetFront().GetValue(MEAN_REQUIRED_FITNESS_IMPROVEMENT_VALUE))); }, "", "%");
 	m_textObservers[ZOOM_TEXT] = new FunctionEventObserver<float>([&] { return m_zoom; });
-	m_textObservers[BEST_TIME_TEXT] = new FunctionEventObserver<double>([&] { return !m_fitnessSystem ? 0.0 : m_fitnessSystem->GetBestTime(); }, "", " seconds");
-	m_textObservers[BEST_TIME_OVERALL_TEXT] = new FunctionEventObserver<std::string>([&] { return !m_fitnessSystem || (m_geneticAlgorithm && m_geneticAlgorithm->GetCurrentGeneration() == 0) ? "Unknown" : std::to_string(m_fitnessSystem->GetBestTimeOverall()) + " seconds"; });
+	m_textObservers[BEST_TIME_TEXT] = new FunctionEventObserver<double>([&] { return m_snapshots.GetFront().GetValue(BEST_TIME_VALUE); }, "", " seconds");
+	m_textObservers[BEST_TIME_OVERALL_TEXT] = new FunctionEventObserver<std::string>([&] { const double value = m_snapshots.GetFront().GetValue(BEST_TIME_OVERALL_VALUE); return value < 0.0 ? "Unknown" : std::to_string(value) + " seconds"; });
+	m_textObservers[TIME_WARP_TEXT] = new FunctionEventObserver<std::string>([&] { return m_timeWarp.ToString(); });
+	m_textObservers[THROUGHPUT_TEXT] = new FunctionEventObserver<std::string>([&] { const auto& snapshot = m_snapshots.GetFront(); return TimeWarp::ToThroughputString(snapshot.GetValue(SIMULATED_SECONDS_PER_SECOND_VALUE), snapshot.GetValue(STEPS_PER_SECOND_VALUE)); });
+	m_textObservers[CAPTURE_TEXT] = new FunctionTimerObserver<std::string>([&] { return m_frameCapture.ToString(); }, 0.5);
+	m_textObservers[TRACE_TEXT] = new FunctionTimerObserver<std::string>([&] { return CoreProfiler::ToString(); }, 0.5);
+	m_textObservers[REPLAY_TEXT] = new FunctionEventObserver<std::string>([&] { return std::to_string(size_t(m_snapshots.GetFront().GetValue(REPLAY_TICK_VALUE))) + "/" + std::to_string(m_replayPlayer.GetNumberOfTicks()) + " ticks"; });
 
 	// Set text observers
 	for (size_t i = 0; i < TEXT_COUNT; ++i)
@@ -947,17 +1209,21 @@ bool StateSimulation::Load()
 	m_texts[FILE_FORMAT_PAUSED_TEXT]->SetPosition({ FontContext::Component(1), {0}, {3}, {8} });
 	m_texts[FILENAME_STOPPED_TEXT]->SetPosition({ FontContext::Component(2), {0}, {3}, {8}, {14} });
 	m_texts[FILENAME_PAUSED_TEXT]->SetPosition({ FontContext::Component(2), {0}, {3}, {8}, {14} });
-	m_texts[PARAMETER_TYPE_TEXT]->SetPosition({ FontContext::Component(11, true), {0}, {10}, {20} });
-	m_texts[POPULATION_SIZE_TEXT]->SetPosition({ FontContext::Component(10, true), {0}, {10} });
-	m_texts[NUMBER_OF_GENERATIONS_TEXT]->SetPosition({ FontContext::Component(9, true), {0}, {10} });
-	m_texts[DEATH_ON_EDGE_CONTACT_TEXT]->SetPosition({ FontContext::Component(8, true), {0}, {10} });
-	m_texts[CROSSOVER_TYPE_TEXT]->SetPosition({ FontContext::Component(7, true), {0}, {10} });
-	m_texts[REPEAT_CROSSOVER_PER_INDIVIDUAL_TEXT]->SetPosition({ FontContext::Component(6, true), {0}, {10} });
-	m_texts[MUTATION_PROBABILITY_TEXT]->SetPosition({ FontContext::Component(5, true), {0}, {10} });
-	m_texts[DECREASE_MUTATION_PROBABILITY_OVER_GENERATIONS_TEXT]->SetPosition({ FontContext::Component(4, true), {0}, {10} });
-	m_texts[NUMBER_OF_PARENTS_TEXT]->SetPosition({ FontContext::Component(3, true), {0}, {10} });
-	m_texts[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT]->SetPosition({ FontContext::Component(2, true), {0}, {10} });
-	m_texts[REQUIRED_FITNESS_IMPROVEMENT_TEXT]->SetPosition({ FontContext::Component(1, true), {0}, {10} });
+	m_texts[PARAMETER_TYPE_TEXT]->SetPosition({ FontContext::Component(15, true), {0}, {10}, {20} });
+	m_texts[POPULATION_SIZE_TEXT]->SetPosition({ FontContext::Component(14, true), {0}, {10} });
+	m_texts[NUMBER_OF_GENERATIONS_TEXT]->SetPosition({ FontContext::Component(13, true), {0}, {10} });
+	m_texts[DEATH_ON_EDGE_CONTACT_TEXT]->SetPosition({ FontContext::Component(12, true), {0}, {10} });
+	m_texts[CROSSOVER_TYPE_TEXT]->SetPosition({ FontContext::Component(11, true), {0}, {10} });
+	m_texts[REPEAT_CROSSOVER_PER_INDIVIDUAL_TEXT]->SetPosition({ FontContext::Component(10, true), {0}, {10} });
+	m_texts[MUTATION_PROBABILITY_TEXT]->SetPosition({ FontContext::Component(9, true), {0}, {10} });
+	m_texts[DECREASE_MUTATION_PROBABILITY_OVER_GENERATIONS_TEXT]->SetPosition({ FontContext::Component(8, true), {0}, {10} });
+	m_texts[NUMBER_OF_PARENTS_TEXT]->SetPosition({ FontContext::Component(7, true), {0}, {10} });
+	m_texts[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT]->SetPosition({ FontContext::Component(6, true), {0}, {10} });
+	m_texts[REQUIRED_FITNESS_IMPROVEMENT_TEXT]->SetPosition({ FontContext::Component(5, true), {0}, {10} });
+	m_texts[PHYSICS_RATE_TEXT]->SetPosition({ FontContext::Component(4, true), {0}, {10} });
+	m_texts[SENSOR_RATE_TEXT]->SetPosition({ FontContext::Component(3, true), {0}, {10} });
+	m_texts[CONTROLLER_RATE_TEXT]->SetPosition({ FontContext::Component(2, true), {0}, {10} });
+	m_texts[DYNAMICS_TYPE_TEXT]->SetPosition({ FontContext::Component(1, true), {0}, {10} });
 	m_texts[CURRENT_POPULATION_TEXT]->SetPosition({ FontContext::Component(6, true), {14}, {23} });
 	m_texts[CURRENT_GENERATION_TEXT]->SetPosition({ FontContext::Component(5, true), {14}, {23} });
 	m_texts[HIGHEST_FITNESS_TEXT]->SetPosition({ FontContext::Component(4, true), {14}, {23} });
@@ -967,6 +1233,11 @@ bool StateSimulation::Load()
 	m_texts[ZOOM_TEXT]->SetPosition({ FontContext::Component(1), {0}, {3}, {8} });
 	m_texts[BEST_TIME_TEXT]->SetPosition({ FontContext::Component(2, true), {27}, {31} });
 	m_texts[BEST_TIME_OVERALL_TEXT]->SetPosition({ FontContext::Component(1, true), {27}, {31} });
+	m_texts[TIME_WARP_TEXT]->SetPosition({ FontContext::Component(2), {0}, {3}, {8} });
+	m_texts[THROUGHPUT_TEXT]->SetPosition({ FontContext::Component(3), {0}, {3} });
+	m_texts[CAPTURE_TEXT]->SetPosition({ FontContext::Component(4), {0}, {3}, {8} });
+	m_texts[TRACE_TEXT]->SetPosition({ FontContext::Component(5), {0}, {3}, {8} });
+	m_texts[REPLAY_TEXT]->SetPosition({ FontContext::Component(6), {0}, {3}, {8} });
 
 	CoreLogger::PrintSuccess("StateSimulation dependencies loaded correctly");
 	return true;
@@ -974,6 +1245,7 @@ bool StateSimulation::Load()
 
 void StateSimulation::Draw()
 {
+	PROFILE_ZONE("StateSimulation::Draw");
 	switch (m_mode)
 	{
 		case STOPPED_MODE:
@@ -997,8 +1269,10 @@ void StateSimulation::Draw()
 			m_texts[POPULATION_SIZE_TEXT]->Draw();
 			m_texts[NUMBER_OF_GENERATIONS_TEXT]->Draw();
 			m_texts[DEATH_ON_EDGE_CONTACT_TEXT]->Draw();
+			m_texts[CAPTURE_TEXT]->Draw();
 			break;
 		case PAUSED_MODE:
+			m_mapPrototype->DrawEdges();
 			m_simulatedWorld->Draw();
 			m_texts[FILE_FORMAT_PAUSED_TEXT]->Draw();
 			m_texts[FILENAME_PAUSED_TEXT]->Draw();
@@ -1012,7 +1286,10 @@ void StateSimulation::Draw()
 			m_texts[BEST_TIME_OVERALL_TEXT]->Draw();
 			break;
 		case RUNNING_MODE:
-			m_simulatedWorld->Draw();
+			// Simulated world belongs to simulation thread, the newest snapshot is drawn instead
+			m_mapPrototype->DrawEdges();
+			m_drawableSnapshot.SetSnapshot(&m_snapshots.GetFront());
+			m_drawableSnapshot.Draw();
 			m_texts[CURRENT_POPULATION_TEXT]->Draw();
 			m_texts[CURRENT_GENERATION_TEXT]->Draw();
 			m_texts[HIGHEST_FITNESS_TEXT]->Draw();
@@ -1022,6 +1299,12 @@ void StateSimulation::Draw()
 			m_texts[ZOOM_TEXT]->Draw();
 			m_texts[BEST_TIME_TEXT]->Draw();
 			m_texts[BEST_TIME_OVERALL_TEXT]->Draw();
+			m_texts[TIME_WARP_TEXT]->Draw();
+			m_texts[THROUGHPUT_TEXT]->Draw();
+			m_texts[CAPTURE_TEXT]->Draw();
+			m_texts[TRACE_TEXT]->Draw();
+			if (m_replayPlayer.IsStarted())
+				m_texts[REPLAY_TEXT]->Draw();
 			break;
 		default:
 			break;
@@ -1035,4 +1318,300 @@ void StateSimulation::Draw()
 	m_texts[NUMBER_OF_PARENTS_TEXT]->Draw();
 	m_texts[REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT]->Draw();
 	m_texts[REQUIRED_FITNESS_IMPROVEMENT_TEXT]->Draw();
+	m_texts[PHYSICS_RATE_TEXT]->Draw();
+	m_texts[SENSOR_RATE_TEXT]->Draw();
+	m_texts[CONTROLLER_RATE_TEXT]->Draw();
+	m_texts[DYNAMICS_TYPE_TEXT]->Draw();
+}
+
+bool StateSimulation::Simulate(double elapsedTime)
+{
+	PROFILE_ZONE("StateSimulation::Simulate");
+	// Calculate number of steps of this frame, only the final state of the frame is published
+	const bool frameBudget = m_timeWarp.IsFrameBudget();
+	size_t numberOfSteps = 0;
+	if (m_timeWarp.IsRealTime())
+		numberOfSteps = m_rateScheduler.Accumulate(elapsedTime);
+	else if (m_timeWarp.UpdateFrame(elapsedTime))
+		numberOfSteps = frameBudget ? std::numeric_limits<size_t>::max() : m_timeWarp.GetStepsPerFrame();
+
+	// Steps are performed in chunks of at most 1/60 of simulated second so that generations and timers
+	// are handled as often as in real time, in case of frame budget steps are performed until budget is used
+	const auto startTime = std::chrono::steady_clock::now();
+	const size_t stepsPerChunk = std::max<size_t>(1, m_rateScheduler.GetPhysicsRate() / 60);
+	size_t performedSteps = 0;
+	bool running = true;
+	while (running && performedSteps < numberOfSteps)
+	{
+		const size_t chunk = std::min(stepsPerChunk, numberOfSteps - performedSteps);
+		running = SimulateSteps(chunk);
+		performedSteps += chunk;
+		if (frameBudget && std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >= TimeWarp::GetFrameBudget())
+			break;
+	}
+
+	m_timeWarp.MeasureThroughput(performedSteps, double(performedSteps) * m_rateScheduler.GetPhysicsTimeStep(), elapsedTime);
+	if (!running)
+		return false;
+
+	if (performedSteps)
+		PublishSnapshot(false);
+	return true;
+}
+
+bool StateSimulation::SimulateSteps(size_t numberOfSteps)
+{
+	PROFILE_ZONE("StateSimulation::SimulateSteps");
+	if (m_replayPlayer.IsStarted())
+	{
+		// Recorded actuators are applied instead of evaluating artificial neural networks
+		const bool playing = m_replayPlayer.Step(numberOfSteps);
+		m_leaderIndex = m_fitnessSystem->MarkLeader(m_simulatedVehicles);
+		m_fitnessSystem->UpdateTimers(m_simulatedVehicles, double(numberOfSteps) * m_rateScheduler.GetPhysicsTimeStep());
+		if (!playing)
+			PublishSnapshot(true);
+		return playing;
+	}
+
+	// Perform physics steps, sensors and controllers are updated only on their ticks
+	const float timeStep = float(m_rateScheduler.GetPhysicsTimeStep());
+	for (size_t step = 0; step < numberOfSteps; ++step)
+	{
+		const bool sensorTick = m_rateScheduler.IsSensorTick();
+		const bool controllerTick = m_rateScheduler.IsControllerTick();
+		if (sensorTick)
+			m_simulatedWorld->UpdateSensors(m_rateScheduler.GetSensorTimeStep());
+
+		// Every vehicle has its own artificial neural network so that controllers are updated in parallel
+		if (controllerTick)
+		{
+			JobSystem::GetInstance().ParallelFor(0, m_population, [this](size_t begin, size_t end) {
+				PROFILE_ZONE("Controllers");
+				for (size_t i = begin; i < end; ++i)
+				{
+					if (m_simulatedVehicles[i]->IsActive())
+					{
+						const NeuronLayer& input = m_simulatedVehicles[i]->ProcessOutput();
+						const NeuronLayer& output = m_artificialNeuralNetworks[i]->Update(input);
+						m_simulatedVehicles[i]->ProcessInput(output);
+						m_replayRecorder.Record(i, m_simulatedVehicles[i]);
+					}
+				}
+			});
+		}
+
+		for (size_t i = 0; i < m_population; ++i)
+			m_simulatedVehicles[i]->Update(timeStep);
+
+		m_simulatedWorld->Step(timeStep);
+		m_rateScheduler.Step();
+	}
+
+	// Timers are updated with simulated time
+	const double simulatedTime = double(numberOfSteps) * m_rateScheduler.GetPhysicsTimeStep();
+
+	bool activity = false;
+	for (const auto& vehicle : m_simulatedVehicles)
+	{
+		if (vehicle->IsActive())
+		{
+			activity = true;
+			break;
+		}
+	}
+
+	if (!activity)
+	{
+		// Set highest fitness overall
+		m_fitnessSystem->Iterate(m_simulatedVehicles);
+
+		// Stream statistics of finished generation
+		GenerationStatistics statistics;
+		statistics.m_generation = m_geneticAlgorithm->GetCurrentGeneration();
+		statistics.m_highestFitness = m_fitnessSystem->GetHighestFitnessOverall();
+		statistics.m_highestFitnessRatio = m_fitnessSystem->GetHighestFitnessOverallRatio();
+		statistics.m_meanFitness = m_fitnessSystem->GetMeanFitnessVector().back();
+		statistics.m_meanFitnessRatio = m_fitnessSystem->ToFitnessRatio(statistics.m_meanFitness);
+		statistics.m_numberOfSucceededIndividuals = m_fitnessSystem->GetNumberOfSucceededIndividualsVector().back();
+		statistics.m_numberOfSucceededIndividualsRatio = double(statistics.m_numberOfSucceededIndividuals) / double(m_simulatedVehicles.size()) * 100.0;
+		statistics.m_bestTime = m_fitnessSystem->GetBestTimeOverall();
+		statistics.m_meanTime = m_fitnessSystem->GetMeanTimeVector().back();
+		m_statisticsWriter.Push(statistics);
+
+		// Keep replay of the best vehicle of finished generation
+		m_replayRecorder.EndGeneration(m_geneticAlgorithm->GetCurrentGeneration(), m_fitnessSystem->GetFitnessVector());
+
+		// Generate new generation
+		if (!m_geneticAlgorithm->Iterate(m_fitnessSystem->GetFitnessVector()))
+		{
+			PublishSnapshot(true);
+			return false;
+		}
+		CoreProfiler::BeginGeneration(m_geneticAlgorithm->GetCurrentGeneration());
+
+		// Set artificial neural networks new raw data
+		for (size_t i = 0; i < m_artificialNeuralNetworks.size(); ++i)
+			m_artificialNeuralNetworks[i]->SetFromRawData(m_geneticAlgorithm->GetIndividualGenes(i));
+
+		// Reset simulated world
+		delete m_simulatedWorld;
+		m_simulatedWorld = new SimulatedWorld(m_dynamicsType);
+		m_simulatedWorld->AddMap(m_mapPrototype);
+		if (m_deathOnEdgeContact)
+			m_simulatedWorld->EnableDeathOnEdgeContact();
+		m_fitnessSystem->Reset();
+		m_simulatedWorld->AddCheckpointFunction(m_fitnessSystem->GetCheckpointFunction());
+
+		// Reset vehicles
+		for (auto& vehicle : m_simulatedVehicles)
+			vehicle = m_simulatedWorld->AddVehicle(m_vehiclePrototype);
+		m_replayRecorder.BeginGeneration(m_simulatedVehicles.size());
+		m_rateScheduler.Reset();
+		m_leaderIndex = 0;
+
+		// Reset required fitness improvement rise timer
+		m_requiredFitnessImprovementRiseTimer.Reset();
+	}
+	else
+	{
+		m_leaderIndex = m_fitnessSystem->MarkLeader(m_simulatedVehicles);
+		if (m_requiredFitnessImprovementRiseTimer.Update(simulatedTime))
+			m_fitnessSystem->Punish(m_simulatedVehicles);
+		m_fitnessSystem->UpdateTimers(m_simulatedVehicles, simulatedTime);
+	}
+
+	return true;
+}
+
+void StateSimulation::PublishSnapshot(bool finished)
+{
+	auto& snapshot = m_snapshots.GetBack();
+	m_simulatedWorld->Capture(snapshot);
+	snapshot.SetLeaderIndex(m_leaderIndex);
+	snapshot.SetFinished(finished);
+
+	// Values shown in texts, negative value means that value is unknown
+	const bool unknown = m_geneticAlgorithm && m_geneticAlgorithm->GetCurrentGeneration() == 0;
+	const double raisingRequiredFitnessImprovement = m_requiredFitnessImprovementRiseTimer.GetTimeout() - m_requiredFitnessImprovementRiseTimer.GetValue();
+	snapshot.SetValue(CURRENT_POPULATION_VALUE, double(m_simulatedVehicles.size() - m_fitnessSystem->GetNumberOfPunishedVehicles()));
+	snapshot.SetValue(CURRENT_GENERATION_VALUE, double(m_geneticAlgorithm ? m_geneticAlgorithm->GetCurrentGeneration() : m_generation));
+	snapshot.SetValue(HIGHEST_FITNESS_VALUE, m_fitnessSystem->GetHighestFitnessRatio());
+	snapshot.SetValue(HIGHEST_FITNESS_OVERALL_VALUE, unknown ? -1.0 : m_fitnessSystem->GetHighestFitnessOverallRatio());
+	snapshot.SetValue(RAISING_REQUIRED_FITNESS_IMPROVEMENT_VALUE, std::ceil(raisingRequiredFitnessImprovement * 4.0) / 4.0); // Changes every 0.25 seconds
+	snapshot.SetValue(MEAN_REQUIRED_FITNESS_IMPROVEMENT_VALUE, m_fitnessSystem->GetMeanRequiredFitnessImprovementRatio());
+	snapshot.SetValue(BEST_TIME_VALUE, m_fitnessSystem->GetBestTime());
+	snapshot.SetValue(BEST_TIME_OVERALL_VALUE, unknown ? -1.0 : m_fitnessSystem->GetBestTimeOverall());
+	snapshot.SetValue(SIMULATED_SECONDS_PER_SECOND_VALUE, m_timeWarp.GetSimulatedSecondsPerSecond());
+	snapshot.SetValue(STEPS_PER_SECOND_VALUE, m_timeWarp.GetStepsPerSecond());
+	snapshot.SetValue(REPLAY_TICK_VALUE, double(m_replayPlayer.GetTick()));
+	m_snapshots.Publish();
+}
+
+bool StateSimulation::ConsumeSnapshot()
+{
+	if (!m_snapshots.Consume())
+		return false;
+
+	// Notify only texts which values have changed so that they are not blended all the time
+	const size_t valueTexts[SNAPSHOT_VALUES_COUNT] = {
+		CURRENT_POPULATION_TEXT,
+		CURRENT_GENERATION_TEXT,
+		HIGHEST_FITNESS_TEXT,
+		HIGHEST_FITNESS_OVERALL_TEXT,
+		RAISING_REQUIRED_FITNESS_IMPROVEMENT_TEXT,
+		MEAN_REQUIRED_FITNESS_IMPROVEMENT,
+		BEST_TIME_TEXT,
+		BEST_TIME_OVERALL_TEXT,
+		THROUGHPUT_TEXT,
+		THROUGHPUT_TEXT,
+		REPLAY_TEXT
+	};
+
+	const auto& snapshot = m_snapshots.GetFront();
+	m_snapshotValues.resize(SNAPSHOT_VALUES_COUNT, std::numeric_limits<double>::quiet_NaN());
+	for (size_t i = 0; i < SNAPSHOT_VALUES_COUNT; ++i)
+	{
+		const double value = snapshot.GetValue(i);
+		if (m_snapshotValues[i] != value)
+		{
+			m_snapshotValues[i] = value;
+			m_textObservers[valueTexts[i]]->Notify();
+		}
+	}
+
+	return true;
+}
+
+void StateSimulation::StartSimulation()
+{
+	// Publish the first snapshot so that texts and vehicles are ready before the first frame
+	m_snapshotValues.clear();
+	m_timeWarp.Restart();
+	PublishSnapshot(false);
+	ConsumeSnapshot();
+	m_simulationThread.Start([this](double elapsedTime) { return Simulate(elapsedTime); });
+}
+
+void StateSimulation::StopSimulation()
+{
+	m_simulationThread.Stop();
+	ConsumeSnapshot();
+}
+
+bool StateSimulation::StartReplay()
+{
+	StatusText* modeText = static_cast<StatusText*>(m_texts[MODE_TEXT]);
+	if (!m_mapPrototype)
+	{
+		modeText->SetErrorStatusText(m_internalErrorsStrings[ERROR_NO_MAP_SPECIFIED]);
+		return false;
+	}
+
+	if (!m_vehiclePrototype)
+	{
+		modeText->SetErrorStatusText(m_internalErrorsStrings[ERROR_NO_VEHICLE_SPECIFIED]);
+		return false;
+	}
+
+	const auto& settings = m_replayRecorder.GetSettings();
+	if (settings.m_mapHash != SimulatedReplayRecorder::CalculateMapHash(m_mapPrototype) ||
+		settings.m_vehicleHash != SimulatedReplayRecorder::CalculateVehicleHash(m_vehiclePrototype))
+	{
+		modeText->SetErrorStatusText(m_internalErrorsStrings[ERROR_REPLAY_MAP_OR_VEHICLE_MISMATCH]);
+		return false;
+	}
+
+	// Replay does not evolve anything
+	delete m_geneticAlgorithm;
+	m_geneticAlgorithm = nullptr;
+
+	// Create simulated world with the same dynamics as recorded run
+	delete m_simulatedWorld;
+	m_simulatedWorld = new SimulatedWorld(settings.m_dynamicsType);
+	m_simulatedWorld->AddMap(m_mapPrototype);
+	if (settings.m_deathOnEdgeContact)
+		m_simulatedWorld->EnableDeathOnEdgeContact();
+
+	// Initialize fitness system for single vehicle
+	delete m_fitnessSystem;
+	m_fitnessSystem = new FitnessSystem(1, m_mapPrototype->GetNumberOfCheckpoints(), m_requiredFitnessImprovement);
+	m_simulatedWorld->AddCheckpointFunction(m_fitnessSystem->GetCheckpointFunction());
+	m_simulatedVehicles.assign(1, m_simulatedWorld->AddVehicle(m_vehiclePrototype));
+	m_leaderIndex = 0;
+
+	// Only physics time step is used, sensor and controller ticks are counted by replay player
+	m_rateScheduler.SetRates(settings.m_physicsRate, settings.m_physicsRate, settings.m_physicsRate);
+
+	// The best vehicle of the last recorded generation is played
+	const SimulatedReplay& replay = m_replayRecorder.GetReplays().back();
+	m_replayPlayer.Start(&replay, settings, m_simulatedWorld, m_simulatedVehicles.front());
+	CoreLogger::PrintMessage("Playing replay of generation " + std::to_string(replay.GetGeneration()) + " with " + DynamicsTypeStrings[settings.m_dynamicsType] + " dynamics");
+
+	m_mode = RUNNING_MODE;
+	m_textObservers[MODE_TEXT]->Notify();
+	m_textObservers[CURRENT_POPULATION_TEXT]->Notify();
+	m_drawableSnapshot.Clear();
+	CoreWindow::SetViewCenter(m_vehiclePrototype->GetCenter());
+	StartSimulation();
+	return true;
 }
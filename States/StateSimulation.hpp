@@ -4,11 +4,23 @@
 #include "MapBuilder.hpp"
 #include "VehicleBuilder.hpp"
 #include "ContinuousTimer.hpp"
+#include "RateScheduler.hpp"
+#include "TimeWarp.hpp"
 #include "Property.hpp"
 #include "SimulatedVehicle.hpp"
 #include "StatisticsBuilder.hpp"
+#include "PopulationArchive.hpp"
+#include "SimulationThread.hpp"
+#include "TripleBuffer.hpp"
+#include "StatisticsWriter.hpp"
+#include "SimulatedReplay.hpp"
+#include "SimulatedSnapshot.hpp"
+#include "DrawableSnapshot.hpp"
+#include "DrawableFrameCapture.hpp"
 
 class GeneticAlgorithmNeuron;
+template<class Gene>
+class LineageStore;
 class AbstractText;
 class ObserverInterface;
 class SimulatedWorld;
@@ -39,6 +51,30 @@ public:
 
 private:
 
+	// Performs physics steps of one frame according to time warp, called by simulation thread
+	// Returns false if there are no more generations
+	bool Simulate(double elapsedTime);
+
+	// Performs specified number of physics steps and handles generations
+	// Returns false if there are no more generations
+	bool SimulateSteps(size_t numberOfSteps);
+
+	// Fills snapshot with current simulation state and publishes it
+	void PublishSnapshot(bool finished);
+
+	// Takes the newest snapshot and notifies texts which values have changed
+	// Returns true if new snapshot was taken
+	bool ConsumeSnapshot();
+
+	// Starts simulation thread
+	void StartSimulation();
+
+	// Stops simulation thread, simulation objects can be used again after this call
+	void StopSimulation();
+
+	// Plays the best vehicle of the last generation of loaded replays, returns false if replays do not match map or vehicle
+	bool StartReplay();
+
 	// Modes
 	enum
 	{
@@ -56,6 +92,8 @@ private:
 		MAP_FILE_FORMAT,
 		ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT,
 		VEHICLE_FILE_FORMAT,
+		POPULATION_FILE_FORMAT,
+		REPLAY_FILE_FORMAT,
 		FILE_FORMATS_COUNT
 	};
 	std::array<std::string, FILE_FORMATS_COUNT> m_fileFormatStrings;
@@ -66,6 +104,9 @@ private:
 	{
 		ARTIFICIAL_NEURAL_NETWORK_FILE_FORMAT_PAUSED,
 		STATISTICS_FILE_FORMAT_PAUSED,
+		POPULATION_FILE_FORMAT_PAUSED,
+		LINEAGE_FILE_FORMAT_PAUSED,
+		REPLAY_FILE_FORMAT_PAUSED,
 		FILE_FORMATS_PAUSED_COUNT
 	};
 	std::array<std::string, FILE_FORMATS_PAUSED_COUNT> m_fileFormatPausedStrings;
@@ -84,6 +125,10 @@ private:
 		NUMBER_OF_PARENTS,
 		REQUIRED_FITNESS_IMPROVEMENT_RISE,
 		REQUIRED_FITNESS_IMPROVEMENT,
+		PHYSICS_RATE,
+		SENSOR_RATE,
+		CONTROLLER_RATE,
+		DYNAMICS_TYPE,
 		PARAMETERS_COUNT
 	};
 	std::array<std::string, PARAMETERS_COUNT> m_parameterTypesStrings;
@@ -100,6 +145,10 @@ private:
 		DECREASE_PARAMETER,
 		INCREASE_ZOOM,
 		DECREASE_ZOOM,
+		CHANGE_CAPTURE_MODE,
+		CHANGE_TRACE_STATE,
+		SEEK_REPLAY_BACKWARD,
+		SEEK_REPLAY_FORWARD,
 		CONTROLS_COUNT
 	};
 	std::map<const size_t, const size_t> m_controlKeys;
@@ -113,6 +162,7 @@ private:
 		ERROR_NO_VEHICLE_SPECIFIED,
 		ERROR_VEHICLE_IS_IN_A_COLLISION_WITH_EDGES_CHAIN,
 		ERROR_ARTIFICIAL_NEURAL_NETWORK_INPUT_MISMATCH,
+		ERROR_REPLAY_MAP_OR_VEHICLE_MISMATCH,
 		INTERNAL_ERRORS_COUNT
 	};
 	std::array<std::string, INTERNAL_ERRORS_COUNT> m_internalErrorsStrings;
@@ -128,21 +178,50 @@ private:
 	Property<size_t> m_numberOfParents;
 	Property<double> m_requiredFitnessImprovement;
 	Property<double> m_requiredFitnessImprovementRise;
+	Property<size_t> m_physicsRate;
+	Property<size_t> m_sensorRate;
+	Property<size_t> m_controllerRate;
+	Property<int> m_dynamicsType;
 	Property<float> m_zoom;
 
 	// Offsets, timers
 	float m_zoomThreshold;
 	const double m_viewMovementOffset;
-	ContinuousTimer m_viewTimer;
 	ContinuousTimer m_pressedKeyTimer;
 	ContinuousTimer m_requiredFitnessImprovementRiseTimer;
+	RateScheduler m_rateScheduler;
+	TimeWarp m_timeWarp;
 
 	// Objects of environment
 	GeneticAlgorithmNeuron* m_geneticAlgorithm;
+	LineageStore<Neuron>* m_lineageStore; // History of all generations, it outlives genetic algorithm so that it can be saved after the last generation
 	ArtificialNeuralNetworks m_artificialNeuralNetworks;
 	SimulatedWorld* m_simulatedWorld;
 	FitnessSystem* m_fitnessSystem;
 	SimulatedVehicles m_simulatedVehicles; // Bot vehicles, pointer are cleared by world
+	size_t m_leaderIndex;
+
+	// Simulation thread and snapshots handed over to the render thread
+	enum
+	{
+		CURRENT_POPULATION_VALUE,
+		CURRENT_GENERATION_VALUE,
+		HIGHEST_FITNESS_VALUE,
+		HIGHEST_FITNESS_OVERALL_VALUE,
+		RAISING_REQUIRED_FITNESS_IMPROVEMENT_VALUE,
+		MEAN_REQUIRED_FITNESS_IMPROVEMENT_VALUE,
+		BEST_TIME_VALUE,
+		BEST_TIME_OVERALL_VALUE,
+		SIMULATED_SECONDS_PER_SECOND_VALUE,
+		STEPS_PER_SECOND_VALUE,
+		REPLAY_TICK_VALUE,
+		SNAPSHOT_VALUES_COUNT
+	};
+	SimulationThread m_simulationThread;
+	TripleBuffer<SimulatedSnapshot> m_snapshots;
+	DrawableSnapshot m_drawableSnapshot;
+	DrawableFrameCapture m_frameCapture; // Off-screen capture of selected generations
+	std::vector<double> m_snapshotValues; // Values shown in texts
 
 	// Prototypes
 	ArtificialNeuralNetwork* m_artificialNeuralNetworkPrototype;
@@ -154,6 +233,11 @@ private:
 	MapBuilder m_mapBuilder;
 	VehicleBuilder m_vehicleBuilder;
 	StatisticsBuilder m_statisticsBuilder;
+	StatisticsWriter m_statisticsWriter; // Streams statistics of every generation of current run
+	PopulationArchive m_populationArchive; // Loaded archive seeds the first generation, it is closed when simulation starts
+	SimulatedReplayRecorder m_replayRecorder; // Replays of the best vehicle of every generation of current run or loaded replays
+	SimulatedReplayPlayer m_replayPlayer; // Used instead of artificial neural networks while replay is played
+	bool m_replayLoaded; // If true then loaded replay is played when simulation is started
 
 	// Texts and text observers
 	enum
@@ -174,6 +258,10 @@ private:
 		NUMBER_OF_PARENTS_TEXT,
 		REQUIRED_FITNESS_IMPROVEMENT_RISE_TEXT,
 		REQUIRED_FITNESS_IMPROVEMENT_TEXT,
+		PHYSICS_RATE_TEXT,
+		SENSOR_RATE_TEXT,
+		CONTROLLER_RATE_TEXT,
+		DYNAMICS_TYPE_TEXT,
 		CURRENT_POPULATION_TEXT,
 		CURRENT_GENERATION_TEXT,
 		HIGHEST_FITNESS_TEXT,
@@ -183,6 +271,11 @@ private:
 		ZOOM_TEXT,
 		BEST_TIME_TEXT,
 		BEST_TIME_OVERALL_TEXT,
+		TIME_WARP_TEXT,
+		THROUGHPUT_TEXT,
+		CAPTURE_TEXT,
+		TRACE_TEXT,
+		REPLAY_TEXT,
 		TEXT_COUNT
 	};
 	std::vector<AbstractText*> m_texts;
@@ -31,7 +31,6 @@ StateVehicleEditor::StateVehicleEditor() :
 	const float allowedAreaX = (windowSize.x / 2.0f - maxVehicleSize.x / 2.0f);
 	const float allowedAreaY = (windowSize.y / 2.0f - maxVehicleSize.y / 2.0f);
 	m_allowedAreaShape.setFillColor(ColorContext::ClearBackground);
-	m_allowedAreaShape.setOutlineColor(ColorContext::Grid);
 	m_allowedAreaShape.setOutlineThickness(2);
 	m_allowedAreaShape.setSize(maxVehicleSize);
 	m_allowedAreaShape.setPosition(allowedAreaX, allowedAreaY);
@@ -43,6 +42,7 @@ StateVehicleEditor::StateVehicleEditor() :
 	m_currentSensorMotionRange = m_vehiclePrototype->GetSensorMotionRange(m_currentSensorIndex);
 	m_currentSensorAngle = m_vehiclePrototype->GetSensorBeamAngle(m_currentSensorIndex);
 	m_upToDate = false;
+	m_palette = ColorContext::NUMBER_OF_PALETTES; // Colors are set on the first draw
 
 	// Initialize grid
 	const size_t numberOfGridAxes = size_t(m_axesPrecision);
@@ -53,12 +53,10 @@ StateVehicleEditor::StateVehicleEditor() :
 	for (size_t i = 0; i < numberOfGridAxes; ++i)
 	{
 		auto& a = m_axes[i];
-		a[0].color = a[1].color = ColorContext::Grid;
 		a[0].position = sf::Vector2f(allowedAreaX + m_horizontalOffset * i + (m_horizontalOffset / 2.f), allowedAreaY);
 		a[1].position = sf::Vector2f(a[0].position.x, allowedAreaY + maxVehicleSize.y);
 
 		auto& b = m_axes[i + numberOfGridAxes];
-		b[0].color = b[1].color = ColorContext::Grid;
 		b[0].position = sf::Vector2f(allowedAreaX, allowedAreaY + m_verticalOffset * i + (m_verticalOffset / 2.f));
 		b[1].position = sf::Vector2f(allowedAreaX + maxVehicleSize.x, b[0].position.y);
 	}
@@ -66,10 +64,6 @@ StateVehicleEditor::StateVehicleEditor() :
 	// Add axes
 	const auto windowCenter = CoreWindow::GetWindowCenter();
 	const auto offset = totalNumberOfGridAxes;
-	m_axes[offset][0].color = m_axes[offset][1].color = ColorContext::Grid;
-	m_axes[offset + 1][0].color = m_axes[offset + 1][1].color = ColorContext::Grid;
-	m_axes[offset + 2][0].color = m_axes[offset + 2][1].color = ColorContext::Grid;
-	m_axes[offset + 3][0].color = m_axes[offset + 3][1].color = ColorContext::Grid;
 	m_axes[offset][0].position.x = m_axes[offset][1].position.x = m_axes[offset + 1][0].position.x = m_axes[offset + 1][1].position.x = windowCenter.x;
 	m_axes[offset + 2][0].position.y = m_axes[offset + 2][1].position.y = m_axes[offset + 3][0].position.y = m_axes[offset + 3][1].position.y = windowCenter.y;
 	m_axes[offset][0].position.y = m_axes[offset + 2][0].position.x = 0;
@@ -409,6 +403,18 @@ bool StateVehicleEditor::Load()
 
 void StateVehicleEditor::Draw()
 {
+	if (m_palette != ColorContext::CurrentPalette)
+	{
+		for (auto& axis : m_axes)
+			axis[0].color = axis[1].color = ColorContext::Grid;
+		m_allowedAreaShape.setOutlineColor(ColorContext::Grid);
+		for (auto& vertex : m_lineShape)
+			vertex.color = ColorContext::PassiveText;
+		for (auto& vertex : m_triangleShape)
+			vertex.color = ColorContext::PassiveText;
+		m_palette = ColorContext::CurrentPalette;
+	}
+
 	m_vehiclePrototype->DrawBody();
 	m_vehiclePrototype->DrawBeams();
 	m_vehiclePrototype->DrawSensors();
@@ -85,6 +85,7 @@ private:
 	std::vector<EdgeShape> m_axes;
 	EdgeShape m_lineShape;
 	TriangleShape m_triangleShape;
+	size_t m_palette; // Palette of grid and shapes colors
 
 	// Texts and text observers
 	enum
@@ -1,13 +1,23 @@
 #pragma once
 #include "TestGeneticAlgorithm.hpp"
+#include "TestJobSystem.hpp"
+#include "TestSimulatedState.hpp"
 
 struct TestEngine
 {
 	TestEngine()
 	{
 		const bool runTestGeneticAlgorithm = false;
+		const bool runTestJobSystem = false;
+		const bool runTestSimulatedState = false;
 
 		if (runTestGeneticAlgorithm)
 			TestGeneticAlgorithm::RunTests();
+
+		if (runTestJobSystem)
+			TestJobSystem::RunTests();
+
+		if (runTestSimulatedState)
+			TestSimulatedState::RunTests();
 	}
 };
\ No newline at end of file
@@ -303,6 +303,88 @@ namespace TestGeneticAlgorithm
 		PrintTestStatistics<Neuron>(numOfGenerations, expectedResults, bestResults, expectedChromosome, bestChromosome);
 	}
 
+	void TestLineage(const size_t chromosomeLength,
+					 const size_t populationSize,
+					 const size_t numOfGenerations,
+					 const int crossoverType,
+					 const bool repeatCrossover,
+					 const double mutationProbability,
+					 const size_t numberOfParents,
+					 const size_t keyframeInterval)
+	{
+		std::cout << "\tTest parameters:\n";
+		std::cout << "\t\tChromosome length: " << chromosomeLength << std::endl;
+		std::cout << "\t\tPupulation size: " << populationSize << std::endl;
+		std::cout << "\t\tNumber of generations: " << numOfGenerations << std::endl;
+		std::cout << "\t\tCrossover type: " << crossoverType << std::endl;
+		std::cout << "\t\tRepeat crossover: " << repeatCrossover << std::endl;
+		std::cout << "\t\tMutation probability: " << mutationProbability << std::endl;
+		std::cout << "\t\tNumber of parents: " << numberOfParents << std::endl;
+		std::cout << "\t\tKeyframe interval: " << keyframeInterval << std::endl;
+
+		// Random fitness, lineage does not depend on the goal
+		FitnessVector fitnessVector(populationSize);
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<Fitness> fitnessDistribution(0.0, 1.0);
+
+		GeneticAlgorithmNeuron geneticAlgorithm(numOfGenerations,
+												chromosomeLength,
+												populationSize,
+												crossoverType,
+												repeatCrossover,
+												mutationProbability,
+												false,
+												numberOfParents,
+												1000,
+												std::pair(-1.0, 1.0));
+		LineageStore<Neuron> lineageStore(chromosomeLength, populationSize, numberOfParents, crossoverType, keyframeInterval);
+		geneticAlgorithm.SetLineageStore(&lineageStore);
+
+		// Keep full copy of every generation to compare with reconstructed individuals
+		std::vector<std::vector<std::vector<Neuron>>> history;
+		auto copyPopulation = [&] {
+			history.emplace_back();
+			for (size_t j = 0; j < populationSize; ++j)
+				history.back().push_back(geneticAlgorithm.GetIndividualChromosome(j));
+		};
+
+		copyPopulation();
+		TestTimer testTimer;
+		while (true)
+		{
+			for (auto& fitness : fitnessVector)
+				fitness = fitnessDistribution(generator);
+			if (!geneticAlgorithm.Iterate(fitnessVector))
+				break;
+			copyPopulation();
+		}
+		testTimer.Stop();
+
+		const std::string filename = "lineage_test.bin";
+		LineageStore<Neuron> loadedLineageStore(0, 0, 0, 0);
+		const bool loaded = lineageStore.Save(filename) && loadedLineageStore.Load(filename);
+		std::remove(filename.c_str());
+
+		size_t numberOfMismatches = 0;
+		for (size_t i = 0; i < history.size(); ++i)
+		{
+			for (size_t j = 0; j < populationSize; ++j)
+			{
+				if (lineageStore.Reconstruct(i, j) != history[i][j] || loadedLineageStore.Reconstruct(i, j) != history[i][j])
+					++numberOfMismatches;
+			}
+		}
+
+		const size_t fullSize = history.size() * populationSize * chromosomeLength * sizeof(Neuron);
+		const bool passed = loaded && numberOfMismatches == 0 && lineageStore.GetNumberOfGenerations() == history.size();
+		HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+		SetConsoleTextAttribute(handle, passed ? 10 : 12);
+		std::cout << "\tReconstructed " << history.size() * populationSize << " individuals, " << numberOfMismatches << " mismatches, ";
+		std::cout << "save and load " << (loaded ? "succeeded" : "failed") << ", ";
+		std::cout << "lineage takes " << 100.0 * double(lineageStore.GetStoredSize()) / double(fullSize) << "% of full history\n\n";
+		SetConsoleTextAttribute(handle, 7);
+	}
+
 	void RunTests()
 	{
 		std::cout << "Test title: TestGeneticAlgorithm\n";
@@ -310,6 +392,7 @@ namespace TestGeneticAlgorithm
 		const bool runTestGroupCharacters = true;
 		const bool runTestGroupFloatingPoints = true;
 		const bool runTestGroupNeurons = true;
+		const bool runTestGroupLineage = true;
 		
 		if (runTestGroupCharacters)
 		{
@@ -350,5 +433,16 @@ namespace TestGeneticAlgorithm
 			TestNeurons(512, 256, 256, 0, true, 0.06, 1000, std::pair(-1.0, 1.0), false, false, 0.85); // 1.5min
 			TestNeurons(1024, 256, 512, 0, true, 0.06, 1000, std::pair(-5.0, 5.0), false, false, 0.8); // 6min
 		}
+
+		if (runTestGroupLineage)
+		{
+			std::cout << "Test group name: TestLineage\n";
+			TestLineage(64, 32, 100, UNIFORM_CROSSOVER, true, 0.05, 2, 16);
+			TestLineage(64, 32, 100, UNIFORM_CROSSOVER, false, 0.05, 3, 16);
+			TestLineage(64, 32, 100, MEAN_CROSSOVER, true, 0.05, 4, 16);
+			TestLineage(256, 64, 100, ONE_POINT_CROSSOVER, true, 0.02, 2, 32);
+			TestLineage(256, 64, 100, TWO_POINT_CROSSOVER, true, 0.02, 2, 32);
+			TestLineage(256, 64, 100, TWO_POINT_CROSSOVER, false, 0.02, 2, 1);
+		}
 	}
 };
\ No newline at end of file
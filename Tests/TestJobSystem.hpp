@@ -0,0 +1,113 @@
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "JobSystem.hpp"
+
+namespace TestJobSystem
+{
+	// Returns elapsed time of function in seconds
+	template<class Function>
+	double Measure(const Function& function)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		function();
+		auto finish = std::chrono::high_resolution_clock::now();
+		std::chrono::duration<double> elapsed = finish - start;
+		return elapsed.count();
+	}
+
+	// CPU bound workload, every element is computed independently
+	inline void Compute(std::vector<double>& results, size_t begin, size_t end, size_t numberOfIterations)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			double value = double(i);
+			for (size_t j = 0; j < numberOfIterations; ++j)
+				value = std::sin(value) + std::sqrt(std::fabs(value) + 1.0);
+			results[i] = value;
+		}
+	}
+
+	// Compares parallel loop executed with different number of workers against serial baseline
+	void TestScaling(const size_t numberOfElements, const size_t numberOfIterations)
+	{
+		std::cout << "\tTest parameters:\n";
+		std::cout << "\t\tNumber of elements: " << numberOfElements << std::endl;
+		std::cout << "\t\tNumber of iterations: " << numberOfIterations << std::endl;
+
+		std::vector<double> expectedResults(numberOfElements);
+		const double serialTime = Measure([&] { Compute(expectedResults, 0, numberOfElements, numberOfIterations); });
+		std::cout << "\tSerial baseline: " << serialTime << "s\n";
+
+		std::vector<size_t> numbersOfWorkers = { 0, 1, 3 };
+		if (JobSystem::GetDefaultNumberOfWorkers() > 3)
+			numbersOfWorkers.push_back(JobSystem::GetDefaultNumberOfWorkers());
+
+		for (const auto& numberOfWorkers : numbersOfWorkers)
+		{
+			JobSystem jobSystem(numberOfWorkers);
+			std::vector<double> results(numberOfElements);
+			const double parallelTime = Measure([&] {
+				jobSystem.ParallelFor(0, numberOfElements, [&](size_t begin, size_t end) {
+					Compute(results, begin, end, numberOfIterations);
+				});
+			});
+
+			std::cout << "\t" << numberOfWorkers + 1 << " threads: " << parallelTime << "s, speedup ";
+			std::cout << std::fixed << std::setprecision(2) << serialTime / parallelTime << "x" << std::defaultfloat;
+			std::cout << (results == expectedResults ? "\n" : ", results differ from serial baseline!\n");
+		}
+
+		std::cout << std::endl;
+	}
+
+	// Checks that jobs of graph are started only after their dependencies and futures of async jobs are set
+	void TestGraph()
+	{
+		JobSystem jobSystem(JobSystem::GetDefaultNumberOfWorkers());
+		std::atomic<size_t> order = 0;
+		std::vector<size_t> finished(4);
+
+		JobGraph graph;
+		const size_t first = graph.AddJob([&] { finished[0] = ++order; });
+		const size_t second = graph.AddJob([&] { finished[1] = ++order; });
+		const size_t third = graph.AddJob([&] { finished[2] = ++order; });
+		const size_t last = graph.AddJob([&] { finished[3] = ++order; });
+		graph.AddDependency(second, first);
+		graph.AddDependency(third, first);
+		graph.AddDependency(last, second);
+		graph.AddDependency(last, third);
+		graph.Run(jobSystem);
+
+		const bool graphCorrect = finished[0] == 1 && finished[3] == 4 && finished[1] > 1 && finished[2] > 1;
+		std::cout << "\tJob graph order: " << (graphCorrect ? "correct\n" : "incorrect!\n");
+
+		auto future = jobSystem.Async([] { return 42; });
+		std::cout << "\tAsync result: " << (future.get() == 42 ? "correct\n\n" : "incorrect!\n\n");
+	}
+
+	void RunTests()
+	{
+		std::cout << "Test title: TestJobSystem\n";
+
+		const bool runTestGroupScaling = true;
+		const bool runTestGroupGraph = true;
+
+		if (runTestGroupScaling)
+		{
+			std::cout << "Test group name: TestScaling\n";
+			TestScaling(1 << 12, 1 << 10);
+			TestScaling(1 << 16, 1 << 6);
+			TestScaling(1 << 20, 1 << 2);
+		}
+
+		if (runTestGroupGraph)
+		{
+			std::cout << "Test group name: TestGraph\n";
+			TestGraph();
+		}
+	}
+}
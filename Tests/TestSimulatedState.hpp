@@ -0,0 +1,152 @@
+#pragma once
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "CoreWindow.hpp"
+#include "MapBuilder.hpp"
+#include "MapPrototype.hpp"
+#include "VehicleBuilder.hpp"
+#include "VehiclePrototype.hpp"
+#include "SimulatedWorld.hpp"
+#include "FitnessSystem.hpp"
+
+namespace TestSimulatedState
+{
+	// Performs physics steps of all vehicles, actuators depend only on step and vehicle index so that steps can be repeated
+	void Simulate(SimulatedWorld& simulatedWorld, SimulatedVehicles& simulatedVehicles, FitnessSystem& fitnessSystem, size_t firstStep, size_t numberOfSteps)
+	{
+		const float timeStep = 1.0f / 60.0f;
+		for (size_t step = firstStep; step < firstStep + numberOfSteps; ++step)
+		{
+			simulatedWorld.UpdateSensors(timeStep);
+			for (size_t i = 0; i < simulatedVehicles.size(); ++i)
+			{
+				const Neuron turn = Neuron(std::sin(double(step) * 0.05 + double(i)));
+				simulatedVehicles[i]->ProcessInput({ Neuron(0.5 + 0.1 * double(i)), Neuron(0.0), turn });
+				simulatedVehicles[i]->Update(timeStep);
+			}
+
+			simulatedWorld.Step(timeStep);
+			fitnessSystem.UpdateTimers(simulatedVehicles, timeStep);
+		}
+	}
+
+	// Returns true if all vehicles have identical poses and fitness
+	bool Compare(const std::vector<SimulatedVehiclePose>& expectedPoses, const FitnessVector& expectedFitness, const SimulatedVehicles& simulatedVehicles)
+	{
+		for (size_t i = 0; i < simulatedVehicles.size(); ++i)
+		{
+			const auto pose = simulatedVehicles[i]->GetPose();
+			const auto& expectedPose = expectedPoses[i];
+			if (pose.m_positionX != expectedPose.m_positionX ||
+				pose.m_positionY != expectedPose.m_positionY ||
+				pose.m_angle != expectedPose.m_angle ||
+				pose.m_velocityX != expectedPose.m_velocityX ||
+				pose.m_velocityY != expectedPose.m_velocityY ||
+				pose.m_angularVelocity != expectedPose.m_angularVelocity ||
+				simulatedVehicles[i]->GetFitness() != expectedFitness[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	// Saves state, performs steps, restores state and performs the same steps again, both runs have to end in the same state
+	void TestRoundTrip(MapPrototype* mapPrototype, VehiclePrototype* vehiclePrototype, int dynamicsType, size_t numberOfVehicles, size_t numberOfSteps)
+	{
+		std::cout << "\tTest parameters:\n";
+		std::cout << "\t\tDynamics type: " << DynamicsTypeStrings[dynamicsType] << std::endl;
+		std::cout << "\t\tNumber of vehicles: " << numberOfVehicles << std::endl;
+		std::cout << "\t\tNumber of steps: " << numberOfSteps << std::endl;
+
+		FitnessSystem fitnessSystem(numberOfVehicles, mapPrototype->GetNumberOfCheckpoints(), 0.0);
+		SimulatedWorld simulatedWorld(dynamicsType);
+		simulatedWorld.AddMap(mapPrototype);
+		simulatedWorld.AddCheckpointFunction(fitnessSystem.GetCheckpointFunction());
+		SimulatedVehicles simulatedVehicles;
+		for (size_t i = 0; i < numberOfVehicles; ++i)
+			simulatedVehicles.push_back(simulatedWorld.AddVehicle(vehiclePrototype));
+
+		// Vehicles are moving when state is saved
+		Simulate(simulatedWorld, simulatedVehicles, fitnessSystem, 0, numberOfSteps);
+		SimulatedState state;
+		simulatedWorld.SaveState(state);
+		fitnessSystem.SaveState(state);
+
+		Simulate(simulatedWorld, simulatedVehicles, fitnessSystem, numberOfSteps, numberOfSteps);
+		std::vector<SimulatedVehiclePose> expectedPoses;
+		FitnessVector expectedFitness;
+		for (const auto& simulatedVehicle : simulatedVehicles)
+		{
+			expectedPoses.push_back(simulatedVehicle->GetPose());
+			expectedFitness.push_back(simulatedVehicle->GetFitness());
+		}
+
+		SimulatedState expectedState;
+		simulatedWorld.SaveState(expectedState);
+		fitnessSystem.SaveState(expectedState);
+
+		const bool restored = simulatedWorld.RestoreState(state) && fitnessSystem.RestoreState(state) && state.IsAtEnd();
+		std::cout << "\tState restore: " << (restored ? "correct\n" : "incorrect!\n");
+		if (!restored)
+		{
+			std::cout << std::endl;
+			return;
+		}
+
+		Simulate(simulatedWorld, simulatedVehicles, fitnessSystem, numberOfSteps, numberOfSteps);
+		SimulatedState repeatedState;
+		simulatedWorld.SaveState(repeatedState);
+		fitnessSystem.SaveState(repeatedState);
+
+		std::cout << "\tPoses and fitness: " << (Compare(expectedPoses, expectedFitness, simulatedVehicles) ? "identical\n" : "differ!\n");
+		std::cout << "\tWhole state: " << (repeatedState.GetData() == expectedState.GetData() ? "identical\n\n" : "differs!\n\n");
+	}
+
+	void RunTests()
+	{
+		std::cout << "Test title: TestSimulatedState\n";
+
+		// Builders validate dummies against window size, window itself is not created
+		CoreWindow::InitializeHeadless(sf::Vector2f(1600.f, 900.f));
+		if (!VehicleBuilder::Initialize() || !MapBuilder::Initialize())
+		{
+			std::cout << "\tCannot initialize builders!\n\n";
+			return;
+		}
+
+		MapBuilder mapBuilder;
+		mapBuilder.CreateDummy();
+		MapPrototype* mapPrototype = mapBuilder.Get();
+		VehicleBuilder vehicleBuilder;
+		vehicleBuilder.CreateDummy();
+		VehiclePrototype* vehiclePrototype = vehicleBuilder.Get();
+		if (!mapPrototype || !vehiclePrototype)
+		{
+			std::cout << "\tCannot create dummy map or vehicle!\n\n";
+			delete mapPrototype;
+			delete vehiclePrototype;
+			return;
+		}
+
+		mapPrototype->CalculateProperties();
+		vehiclePrototype->SetCenter(mapBuilder.GetVehicleCenter());
+		vehiclePrototype->SetAngle(mapBuilder.GetVehicleAngle());
+		vehiclePrototype->Update();
+
+		const bool runTestGroupRoundTrip = true;
+
+		if (runTestGroupRoundTrip)
+		{
+			std::cout << "Test group name: TestRoundTrip\n";
+			for (int dynamicsType = 0; dynamicsType < NUMBER_OF_DYNAMICS_TYPES; ++dynamicsType)
+			{
+				TestRoundTrip(mapPrototype, vehiclePrototype, dynamicsType, 1, 120);
+				TestRoundTrip(mapPrototype, vehiclePrototype, dynamicsType, 16, 240);
+			}
+		}
+
+		delete mapPrototype;
+		delete vehiclePrototype;
+	}
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 
 using Fitness = double;
@@ -13,6 +14,9 @@ enum : int
 	NUMBER_OF_CROSSOVER_TYPES
 };
 
+// Parent of every gene of uniform crossover is recorded in one byte
+const size_t MaxNumberOfParents = 256;
+
 const char* const CrossoverTypeStrings[NUMBER_OF_CROSSOVER_TYPES] = {
 	"Uniform crossover",
 	"Mean crossover",
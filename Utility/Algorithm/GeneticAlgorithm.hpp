@@ -5,6 +5,9 @@
 #include <iomanip>
 #include "ArtificialNeuralNetwork.hpp"
 #include "Genetic.hpp"
+#include "LineageStore.hpp"
+#include "JobSystem.hpp"
+#include "CoreProfiler.hpp"
 
 template <class Type>
 class GeneticAlgorithm
@@ -23,13 +26,18 @@ protected:
 	const double m_mutationProbability;
 	const bool m_decreaseMutationProbabilityOverGenerations;
 	const size_t m_numberOfParents;
-	static inline std::mt19937 m_mersenneTwister = std::mt19937((std::random_device())());
+	std::vector<size_t> m_selectedIndexes; // Indexes of parents in previous generation
+	LineageStore<Type>* m_lineageStore;
+	const std::mt19937::result_type m_seed; // The same seed and parameters give the same run
+	std::mt19937 m_mersenneTwister; // Every instance has its own generator so that many genetic algorithms can run concurrently
 	static inline std::uniform_int_distribution<std::mt19937::result_type> m_hundredDistribution =
 		std::uniform_int_distribution<std::mt19937::result_type>(0, 100);
 
-	// Creates new chromosome (individual) based on parents
-	Chromosome Crossover()
+	// Creates new chromosome (individual) based on parents, random numbers are taken from given generator
+	// If delta is given crossover descriptor is written to it
+	Chromosome Crossover(std::mt19937& generator, OffspringDelta<Type>* delta = nullptr) const
 	{
+		auto hundredDistribution = m_hundredDistribution;
 		Chromosome newChromosome(m_chromosomeLength);
 		switch (m_crossoverType)
 		{
@@ -39,10 +47,12 @@ protected:
 				for (size_t i = 0; i < m_chromosomeLength; ++i)
 				{
 					// You have a chance to get a gene from each parent with the same probability
-					size_t parentIndex = static_cast<size_t>(std::floor(double(m_hundredDistribution(m_mersenneTwister)) / probabilityPerParent));
+					size_t parentIndex = static_cast<size_t>(std::floor(double(hundredDistribution(generator)) / probabilityPerParent));
 					if (parentIndex >= m_numberOfParents)
 						parentIndex = m_numberOfParents - 1;
 					newChromosome[i] = m_population[parentIndex][i];
+					if (delta)
+						delta->m_parentIndexes.push_back(uint8_t(parentIndex));
 				}
 				break;
 			}
@@ -60,20 +70,22 @@ protected:
 			}
 			case ONE_POINT_CROSSOVER:
 			{
-				const double percentage = double(m_hundredDistribution(m_mersenneTwister)) / 100.0;
+				const double percentage = double(hundredDistribution(generator)) / 100.0;
 				const size_t pivot = size_t(percentage * m_chromosomeLength);
 				for (size_t i = 0; i < pivot; ++i)
 					newChromosome[i] = m_population[0][i];
 				for (size_t i = pivot; i < m_chromosomeLength; ++i)
 					newChromosome[i] = m_population[1][i];
+				if (delta)
+					delta->m_firstPivot = uint32_t(pivot);
 				break;
 			}
 			case TWO_POINT_CROSSOVER:
 			default:
 			{
-				const double percentage1 = double(m_hundredDistribution(m_mersenneTwister)) / 100.0;
+				const double percentage1 = double(hundredDistribution(generator)) / 100.0;
 				const size_t pivot1 = size_t(percentage1 * m_chromosomeLength);
-				const double percentage2 = double(m_hundredDistribution(m_mersenneTwister)) / 100.0;
+				const double percentage2 = double(hundredDistribution(generator)) / 100.0;
 				const size_t pivot2 = pivot1 + size_t(percentage2 * (m_chromosomeLength - pivot1));
 				for (size_t i = 0; i < pivot1; ++i)
 					newChromosome[i] = m_population[0][i];
@@ -81,6 +93,11 @@ protected:
 					newChromosome[i] = m_population[1][i];
 				for (size_t i = pivot2; i < m_chromosomeLength; ++i)
 					newChromosome[i] = m_population[0][i];
+				if (delta)
+				{
+					delta->m_firstPivot = uint32_t(pivot1);
+					delta->m_secondPivot = uint32_t(pivot2);
+				}
 				break;
 			}
 		}
@@ -98,20 +115,22 @@ private:
 
 		// Find best ones
 		std::vector<Chromosome> newPopulation;
+		m_selectedIndexes.clear();
 		for (size_t i = 0; i < m_numberOfParents; ++i)
 		{
 			// Select parent
 			auto bestChromosomeIndex = std::distance(dummy.begin(), std::max_element(dummy.begin(), dummy.end()));
 			dummy[bestChromosomeIndex] = 0;
 			newPopulation.push_back(m_population[bestChromosomeIndex]);
+			m_selectedIndexes.push_back(size_t(bestChromosomeIndex));
 		}
 
 		// New population consists of fittest chromosomes
 		m_population = newPopulation;
 	}
 
-	// Mutates gene
-	virtual void Mutate(Gene& gene) = 0;
+	// Mutates gene, random numbers are taken from given generator
+	virtual void Mutate(Gene& gene, std::mt19937& generator) const = 0;
 
 public:
 
@@ -122,7 +141,8 @@ public:
 					 const bool repeatCrossoverPerIndividual,
 					 const double mutationProbability,
 					 const bool decreaseMutationProbabilityOverGenerations = false,
-					 const size_t numberOfParents = 2) :
+					 const size_t numberOfParents = 2,
+					 const std::mt19937::result_type seed = (std::random_device())()) :
 		m_maxNumberOfGenerations(maxNumberOfGenerations),
 		m_currentGeneration(0),
 		m_chromosomeLength(chromosomeLength),
@@ -131,9 +151,13 @@ public:
 		m_repeatCrossoverPerIndividual(repeatCrossoverPerIndividual),
 		m_mutationProbability(mutationProbability),
 		m_decreaseMutationProbabilityOverGenerations(decreaseMutationProbabilityOverGenerations),
-		m_numberOfParents(numberOfParents)
+		m_numberOfParents(numberOfParents),
+		m_lineageStore(nullptr),
+		m_seed(seed),
+		m_mersenneTwister(seed)
 	{
 		assert(m_populationSize > m_numberOfParents);
+		assert(m_numberOfParents <= MaxNumberOfParents);
 		m_population.resize(m_populationSize);
 		m_population.shrink_to_fit();
 	}
@@ -149,6 +173,12 @@ public:
 		return m_currentGeneration;
 	}
 
+	// Returns seed of random numbers generator
+	inline std::mt19937::result_type GetSeed() const
+	{
+		return m_seed;
+	}
+
 	inline Chromosome GetIndividualChromosome(const size_t identity) const
 	{
 		if (identity < m_populationSize)
@@ -163,8 +193,15 @@ public:
 		return &m_population[identity][0];
 	}
 
+	// Sets store to which every next generation is recorded, current population becomes its first generation
+	inline void SetLineageStore(LineageStore<Type>* lineageStore)
+	{
+		m_lineageStore = lineageStore;
+	}
+
 	bool Iterate(const FitnessVector& points)
 	{
+		PROFILE_ZONE("GeneticAlgorithm::Iterate");
 		++m_currentGeneration;
 		if (m_currentGeneration > m_maxNumberOfGenerations)
 		{
@@ -172,38 +209,50 @@ public:
 			return false;
 		}
 
+		// Population evaluated before the first recorded iteration is the first generation of lineage
+		if (m_lineageStore && m_lineageStore->IsEmpty())
+			m_lineageStore->AddGeneration(m_population, {}, {});
+
 		Select(points);
 
+		// New individuals are created in parallel, every individual has its own generator seeded here
+		// so that the result does not depend on the order in which jobs are executed
 		const size_t repeatCount = m_populationSize - m_numberOfParents;
-		if (m_repeatCrossoverPerIndividual)
-		{
-			for (size_t i = 0; i < repeatCount; ++i)
-			{
-				auto individual = Crossover();
-				for (auto& gene : individual)
-				{
-					if (m_hundredDistribution(m_mersenneTwister) < (m_mutationProbability * 100))
-						Mutate(gene);
-				}
-				m_population.push_back(individual);
-			}
-		}
-		else
-		{
-			const auto dummy = Crossover();
-			for (size_t i = 0; i < repeatCount; ++i)
+		std::vector<std::mt19937::result_type> seeds(repeatCount);
+		for (auto& seed : seeds)
+			seed = m_mersenneTwister();
+
+		// Every offspring gets its crossover descriptor and mutated genes recorded if lineage is stored
+		std::vector<OffspringDelta<Type>> deltas(m_lineageStore ? repeatCount : 0);
+		OffspringDelta<Type> dummyDelta;
+		const Chromosome dummy = m_repeatCrossoverPerIndividual ? Chromosome() : Crossover(m_mersenneTwister, m_lineageStore ? &dummyDelta : nullptr);
+		m_population.resize(m_populationSize);
+		JobSystem::GetInstance().ParallelFor(0, repeatCount, [&](size_t begin, size_t end) {
+			auto hundredDistribution = m_hundredDistribution;
+			for (size_t i = begin; i < end; ++i)
 			{
-				auto individual = dummy;
-				for (auto& gene : individual)
+				std::mt19937 generator(seeds[i]);
+				OffspringDelta<Type>* delta = deltas.empty() ? nullptr : &deltas[i];
+				if (delta && !m_repeatCrossoverPerIndividual)
+					*delta = dummyDelta;
+
+				Chromosome individual = m_repeatCrossoverPerIndividual ? Crossover(generator, delta) : dummy;
+				for (size_t j = 0; j < m_chromosomeLength; ++j)
 				{
-					if (m_hundredDistribution(m_mersenneTwister) < (m_mutationProbability * 100))
-						Mutate(gene);
+					if (hundredDistribution(generator) < (m_mutationProbability * 100))
+					{
+						Mutate(individual[j], generator);
+						if (delta)
+							delta->m_mutations.emplace_back(uint32_t(j), individual[j]);
+					}
 				}
-				m_population.push_back(individual);
+				m_population[m_numberOfParents + i] = std::move(individual);
 			}
-		}
-		
-		m_population.shrink_to_fit();
+		});
+
+		if (m_lineageStore)
+			m_lineageStore->AddGeneration(m_population, m_selectedIndexes, std::move(deltas));
+
 		return true;
 	}
 
@@ -249,9 +298,10 @@ class GeneticAlgorithmCharacter final :
 	const std::string m_alphabet;
 	std::uniform_int_distribution<std::mt19937::result_type> m_alphabetDistribution;
 
-	void Mutate(char& gene)
+	void Mutate(char& gene, std::mt19937& generator) const
 	{
-		size_t offset = m_alphabetDistribution(m_mersenneTwister);
+		auto alphabetDistribution = m_alphabetDistribution;
+		size_t offset = alphabetDistribution(generator);
 
 		if (m_decreaseMutationProbabilityOverGenerations)
 		{
@@ -304,9 +354,10 @@ class GeneticAlgorithmFloat final :
 	std::pair<float, float> m_range;
 	std::uniform_int_distribution<std::mt19937::result_type> m_rangeDistribution;
 
-	void Mutate(float& gene)
+	void Mutate(float& gene, std::mt19937& generator) const
 	{
-		size_t offset = m_rangeDistribution(m_mersenneTwister);
+		auto rangeDistribution = m_rangeDistribution;
+		size_t offset = rangeDistribution(generator);
 
 		if (m_decreaseMutationProbabilityOverGenerations)
 		{
@@ -365,9 +416,10 @@ class GeneticAlgorithmNeuron final :
 	std::pair<Neuron, Neuron> m_range;
 	std::uniform_int_distribution<std::mt19937::result_type> m_rangeDistribution;
 
-	void Mutate(Neuron& gene)
+	void Mutate(Neuron& gene, std::mt19937& generator) const
 	{
-		size_t offset = m_rangeDistribution(m_mersenneTwister);
+		auto rangeDistribution = m_rangeDistribution;
+		size_t offset = rangeDistribution(generator);
 
 		if (m_decreaseMutationProbabilityOverGenerations)
 		{
@@ -392,7 +444,8 @@ public:
 						   bool decreaseMutationProbabilityOverGenerations,
 						   const size_t numberOfParents,
 						   unsigned precision,
-						   std::pair<Neuron, Neuron> range) :
+						   std::pair<Neuron, Neuron> range,
+						   std::mt19937::result_type seed = (std::random_device())()) :
 		GeneticAlgorithm(maxNumberOfGenerations,
 						 chromosomeLength,
 						 populationSize,
@@ -400,7 +453,8 @@ public:
 						 repeatCrossoverPerIndividual,
 						 mutationProbability,
 						 decreaseMutationProbabilityOverGenerations,
-						 numberOfParents),
+						 numberOfParents,
+						 seed),
 		m_precision(precision),
 		m_range(range)
 	{
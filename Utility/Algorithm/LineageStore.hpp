@@ -0,0 +1,372 @@
+#pragma once
+#include <algorithm>
+#include <map>
+#include <string>
+#include "Genetic.hpp"
+#include "BinaryContainer.hpp"
+
+// Describes how one offspring was created from parents selected in previous generation
+template<class Gene>
+struct OffspringDelta
+{
+	uint32_t m_firstPivot = 0; // Cut points of one point and two point crossover
+	uint32_t m_secondPivot = 0;
+	std::vector<uint8_t> m_parentIndexes; // Parent of every gene, only for uniform crossover
+	std::vector<std::pair<uint32_t, Gene>> m_mutations; // Indexes and values of mutated genes
+};
+
+// History of all generations of genetic algorithm stored as differences between generations
+// Parents are stored as indexes into previous generation, offspring as crossover descriptor and sparse list of mutated genes
+// Every keyframe interval generations the whole population is stored, so reconstruction never goes back further than that
+template<class Gene>
+class LineageStore final
+{
+	using Chromosome = std::vector<Gene>;
+
+	// Generation is either a keyframe or a delta from previous generation
+	struct Generation
+	{
+		Chromosome m_keyframe; // Genes of whole population, empty for delta generations
+		std::vector<size_t> m_parentIndexes; // Indexes of selected parents in previous generation
+		std::vector<OffspringDelta<Gene>> m_offspring;
+	};
+
+	size_t m_chromosomeLength;
+	size_t m_populationSize;
+	size_t m_numberOfParents;
+	int m_crossoverType;
+	size_t m_keyframeInterval;
+	std::vector<Generation> m_generations;
+	inline static const uint32_t m_containerType = BinaryContainer::MakeIdentifier("LING");
+	inline static const uint32_t m_parametersSection = BinaryContainer::MakeIdentifier("INFO");
+	inline static const uint32_t m_keyframesSection = BinaryContainer::MakeIdentifier("KEYF");
+	inline static const uint32_t m_parentsSection = BinaryContainer::MakeIdentifier("PRNT");
+	inline static const uint32_t m_pivotsSection = BinaryContainer::MakeIdentifier("PIVT");
+	inline static const uint32_t m_uniformSection = BinaryContainer::MakeIdentifier("UNIF"); // Parent of every gene of uniform crossover
+	inline static const uint32_t m_mutationCountsSection = BinaryContainer::MakeIdentifier("MCNT");
+	inline static const uint32_t m_mutationIndexesSection = BinaryContainer::MakeIdentifier("MIDX");
+	inline static const uint32_t m_mutationValuesSection = BinaryContainer::MakeIdentifier("MVAL");
+
+	// Returns true if generation is stored as a keyframe
+	inline bool IsKeyframe(size_t generation) const
+	{
+		return generation % m_keyframeInterval == 0;
+	}
+
+	// Creates offspring from parents the same way as genetic algorithm did
+	Chromosome ApplyDelta(const std::vector<const Chromosome*>& parents, const OffspringDelta<Gene>& delta) const
+	{
+		Chromosome result(m_chromosomeLength);
+		switch (m_crossoverType)
+		{
+			case UNIFORM_CROSSOVER:
+			{
+				for (size_t i = 0; i < m_chromosomeLength; ++i)
+					result[i] = (*parents[delta.m_parentIndexes[i]])[i];
+				break;
+			}
+			case MEAN_CROSSOVER:
+			{
+				for (size_t i = 0; i < m_chromosomeLength; ++i)
+				{
+					Gene gene = (*parents[0])[i];
+					for (size_t j = 1; j < m_numberOfParents; ++j)
+						gene += (*parents[j])[i];
+					result[i] = gene / Gene(m_numberOfParents);
+				}
+				break;
+			}
+			case ONE_POINT_CROSSOVER:
+			{
+				for (size_t i = 0; i < m_chromosomeLength; ++i)
+					result[i] = (*parents[i < delta.m_firstPivot ? 0 : 1])[i];
+				break;
+			}
+			case TWO_POINT_CROSSOVER:
+			default:
+			{
+				for (size_t i = 0; i < m_chromosomeLength; ++i)
+					result[i] = (*parents[i >= delta.m_firstPivot && i < delta.m_secondPivot ? 1 : 0])[i];
+				break;
+			}
+		}
+
+		for (const auto& mutation : delta.m_mutations)
+			result[mutation.first] = mutation.second;
+		return result;
+	}
+
+public:
+
+	LineageStore(const size_t chromosomeLength,
+				 const size_t populationSize,
+				 const size_t numberOfParents,
+				 const int crossoverType,
+				 const size_t keyframeInterval = 16) :
+		m_chromosomeLength(chromosomeLength),
+		m_populationSize(populationSize),
+		m_numberOfParents(numberOfParents),
+		m_crossoverType(crossoverType),
+		m_keyframeInterval(std::max<size_t>(1, keyframeInterval))
+	{
+	}
+
+	~LineageStore()
+	{
+	}
+
+	// Returns true if no generation is stored
+	inline bool IsEmpty() const
+	{
+		return m_generations.empty();
+	}
+
+	// Returns number of stored generations, the first one is the population which existed when recording started
+	inline size_t GetNumberOfGenerations() const
+	{
+		return m_generations.size();
+	}
+
+	// Returns number of bytes used by stored genes, parents and deltas
+	size_t GetStoredSize() const
+	{
+		size_t size = 0;
+		for (const auto& generation : m_generations)
+		{
+			size += generation.m_keyframe.size() * sizeof(Gene) + generation.m_parentIndexes.size() * sizeof(uint64_t);
+			for (const auto& offspring : generation.m_offspring)
+				size += 2 * sizeof(uint32_t) + offspring.m_parentIndexes.size() + offspring.m_mutations.size() * (sizeof(uint32_t) + sizeof(Gene));
+		}
+		return size;
+	}
+
+	// Adds next generation, keyframe generations keep whole population and ignore the deltas
+	void AddGeneration(const std::vector<Chromosome>& population, const std::vector<size_t>& parentIndexes, std::vector<OffspringDelta<Gene>>&& offspring)
+	{
+		Generation generation;
+		if (IsKeyframe(m_generations.size()))
+		{
+			generation.m_keyframe.reserve(m_populationSize * m_chromosomeLength);
+			for (const auto& chromosome : population)
+				generation.m_keyframe.insert(generation.m_keyframe.end(), chromosome.begin(), chromosome.end());
+		}
+		else
+		{
+			generation.m_parentIndexes = parentIndexes;
+			generation.m_offspring = std::move(offspring);
+		}
+		m_generations.push_back(std::move(generation));
+	}
+
+	// Reconstructs individual of past generation, only individuals it descends from since the last keyframe are rebuilt
+	Chromosome Reconstruct(const size_t generation, const size_t index) const
+	{
+		if (generation >= m_generations.size() || index >= m_populationSize)
+			return Chromosome(m_chromosomeLength);
+
+		// Find individuals needed in every generation going back to keyframe
+		const size_t keyframe = generation / m_keyframeInterval * m_keyframeInterval;
+		std::vector<std::vector<size_t>> needed(generation - keyframe + 1);
+		needed.back().push_back(index);
+		for (size_t i = generation; i > keyframe; --i)
+		{
+			const auto& parentIndexes = m_generations[i].m_parentIndexes;
+			auto& previous = needed[i - keyframe - 1];
+			for (const auto& individual : needed[i - keyframe])
+			{
+				if (individual < m_numberOfParents)
+					previous.push_back(parentIndexes[individual]);
+				else
+					previous.insert(previous.end(), parentIndexes.begin(), parentIndexes.end());
+			}
+			std::sort(previous.begin(), previous.end());
+			previous.erase(std::unique(previous.begin(), previous.end()), previous.end());
+		}
+
+		// Rebuild needed individuals going forward from keyframe
+		std::map<size_t, Chromosome> individuals;
+		const auto& keyframeGenes = m_generations[keyframe].m_keyframe;
+		for (const auto& individual : needed.front())
+		{
+			const auto begin = keyframeGenes.begin() + individual * m_chromosomeLength;
+			individuals[individual] = Chromosome(begin, begin + m_chromosomeLength);
+		}
+
+		for (size_t i = keyframe + 1; i <= generation; ++i)
+		{
+			const auto& parentIndexes = m_generations[i].m_parentIndexes;
+			std::vector<const Chromosome*> parents(m_numberOfParents, nullptr);
+			for (size_t j = 0; j < m_numberOfParents; ++j)
+			{
+				auto iterator = individuals.find(parentIndexes[j]);
+				if (iterator != individuals.end())
+					parents[j] = &iterator->second;
+			}
+
+			std::map<size_t, Chromosome> nextIndividuals;
+			for (const auto& individual : needed[i - keyframe])
+			{
+				if (individual < m_numberOfParents)
+					nextIndividuals[individual] = *parents[individual];
+				else
+					nextIndividuals[individual] = ApplyDelta(parents, m_generations[i].m_offspring[individual - m_numberOfParents]);
+			}
+			individuals.swap(nextIndividuals);
+		}
+
+		return individuals[index];
+	}
+
+	// Saves lineage to container file, returns false if file cannot be written
+	bool Save(const std::string& filename) const
+	{
+		std::ofstream output(filename, std::ios::binary);
+		if (!output.is_open())
+			return false;
+
+		// Variable length data of all generations is flattened into arrays
+		const std::vector<uint64_t> parameters = { m_chromosomeLength, m_populationSize, m_numberOfParents, uint64_t(m_crossoverType), m_keyframeInterval, m_generations.size() };
+		Chromosome keyframes;
+		std::vector<uint64_t> parents;
+		std::vector<uint32_t> pivots;
+		std::vector<uint8_t> uniform;
+		std::vector<uint32_t> mutationCounts;
+		std::vector<uint32_t> mutationIndexes;
+		Chromosome mutationValues;
+		for (const auto& generation : m_generations)
+		{
+			keyframes.insert(keyframes.end(), generation.m_keyframe.begin(), generation.m_keyframe.end());
+			parents.insert(parents.end(), generation.m_parentIndexes.begin(), generation.m_parentIndexes.end());
+			for (const auto& offspring : generation.m_offspring)
+			{
+				pivots.push_back(offspring.m_firstPivot);
+				pivots.push_back(offspring.m_secondPivot);
+				uniform.insert(uniform.end(), offspring.m_parentIndexes.begin(), offspring.m_parentIndexes.end());
+				mutationCounts.push_back(uint32_t(offspring.m_mutations.size()));
+				for (const auto& mutation : offspring.m_mutations)
+				{
+					mutationIndexes.push_back(mutation.first);
+					mutationValues.push_back(mutation.second);
+				}
+			}
+		}
+
+		BinaryContainer container(m_containerType);
+		container.AddSection(m_parametersSection, parameters);
+		container.AddSection(m_keyframesSection, keyframes);
+		container.AddSection(m_parentsSection, parents);
+		container.AddSection(m_pivotsSection, pivots);
+		container.AddSection(m_uniformSection, uniform);
+		container.AddSection(m_mutationCountsSection, mutationCounts);
+		container.AddSection(m_mutationIndexesSection, mutationIndexes);
+		container.AddSection(m_mutationValuesSection, mutationValues);
+		return container.Write(output);
+	}
+
+	// Loads lineage from container file, returns false if file is missing, corrupted or inconsistent
+	bool Load(const std::string& filename)
+	{
+		std::ifstream input(filename, std::ios::binary);
+		if (!input.is_open())
+			return false;
+
+		BinaryContainer container;
+		if (container.Read(input) != BinaryContainer::READ_SUCCESS || container.GetType() != m_containerType)
+			return false;
+
+		uint64_t parameters[6];
+		Chromosome keyframes;
+		std::vector<uint64_t> parents;
+		std::vector<uint32_t> pivots;
+		std::vector<uint8_t> uniform;
+		std::vector<uint32_t> mutationCounts;
+		std::vector<uint32_t> mutationIndexes;
+		Chromosome mutationValues;
+		if (!container.GetSection(m_parametersSection, parameters, 6) ||
+			!container.GetSection(m_keyframesSection, keyframes) ||
+			!container.GetSection(m_parentsSection, parents) ||
+			!container.GetSection(m_pivotsSection, pivots) ||
+			!container.GetSection(m_uniformSection, uniform) ||
+			!container.GetSection(m_mutationCountsSection, mutationCounts) ||
+			!container.GetSection(m_mutationIndexesSection, mutationIndexes) ||
+			!container.GetSection(m_mutationValuesSection, mutationValues))
+			return false;
+
+		// Sizes of all arrays follow from parameters, so they are validated before any generation is rebuilt
+		const size_t chromosomeLength = size_t(parameters[0]);
+		const size_t populationSize = size_t(parameters[1]);
+		const size_t numberOfParents = size_t(parameters[2]);
+		const int crossoverType = int(parameters[3]);
+		const size_t keyframeInterval = size_t(parameters[4]);
+		const size_t numberOfGenerations = size_t(parameters[5]);
+		if (!keyframeInterval || numberOfParents >= populationSize || numberOfParents > MaxNumberOfParents || crossoverType < 0 || crossoverType >= NUMBER_OF_CROSSOVER_TYPES)
+			return false;
+
+		const size_t numberOfKeyframes = numberOfGenerations ? (numberOfGenerations - 1) / keyframeInterval + 1 : 0;
+		const size_t numberOfDeltas = numberOfGenerations - numberOfKeyframes;
+		const size_t numberOfOffspring = numberOfDeltas * (populationSize - numberOfParents);
+		const bool uniformCrossover = crossoverType == UNIFORM_CROSSOVER;
+		if (keyframes.size() != numberOfKeyframes * populationSize * chromosomeLength ||
+			parents.size() != numberOfDeltas * numberOfParents ||
+			pivots.size() != numberOfOffspring * 2 ||
+			uniform.size() != (uniformCrossover ? numberOfOffspring * chromosomeLength : 0) ||
+			mutationCounts.size() != numberOfOffspring ||
+			mutationIndexes.size() != mutationValues.size())
+			return false;
+
+		std::vector<Generation> generations;
+		size_t keyframeOffset = 0, parentOffset = 0, offspringOffset = 0, mutationOffset = 0;
+		for (size_t i = 0; i < numberOfGenerations; ++i)
+		{
+			Generation generation;
+			if (i % keyframeInterval == 0)
+			{
+				const size_t length = populationSize * chromosomeLength;
+				generation.m_keyframe.assign(keyframes.begin() + keyframeOffset, keyframes.begin() + keyframeOffset + length);
+				keyframeOffset += length;
+				generations.push_back(std::move(generation));
+				continue;
+			}
+
+			for (size_t j = 0; j < numberOfParents; ++j, ++parentOffset)
+			{
+				if (parents[parentOffset] >= populationSize)
+					return false;
+				generation.m_parentIndexes.push_back(size_t(parents[parentOffset]));
+			}
+
+			generation.m_offspring.resize(populationSize - numberOfParents);
+			for (auto& offspring : generation.m_offspring)
+			{
+				offspring.m_firstPivot = pivots[offspringOffset * 2];
+				offspring.m_secondPivot = pivots[offspringOffset * 2 + 1];
+				if (uniformCrossover)
+				{
+					const auto begin = uniform.begin() + offspringOffset * chromosomeLength;
+					offspring.m_parentIndexes.assign(begin, begin + chromosomeLength);
+					if (std::any_of(offspring.m_parentIndexes.begin(), offspring.m_parentIndexes.end(), [&](uint8_t parent) { return parent >= numberOfParents; }))
+						return false;
+				}
+
+				const size_t mutationCount = mutationCounts[offspringOffset++];
+				if (mutationCount > mutationIndexes.size() - mutationOffset)
+					return false;
+				for (size_t j = 0; j < mutationCount; ++j, ++mutationOffset)
+				{
+					if (mutationIndexes[mutationOffset] >= chromosomeLength)
+						return false;
+					offspring.m_mutations.emplace_back(mutationIndexes[mutationOffset], mutationValues[mutationOffset]);
+				}
+			}
+			generations.push_back(std::move(generation));
+		}
+
+		m_chromosomeLength = chromosomeLength;
+		m_populationSize = populationSize;
+		m_numberOfParents = numberOfParents;
+		m_crossoverType = crossoverType;
+		m_keyframeInterval = keyframeInterval;
+		m_generations.swap(generations);
+		return true;
+	}
+};
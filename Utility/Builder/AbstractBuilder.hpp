@@ -1,4 +1,5 @@
 #pragma once
+#include "BinaryContainer.hpp"
 #include <map>
 #include <fstream>
 
@@ -10,11 +11,17 @@ class AbstractBuilder
 	// Clears internal fields
 	virtual void ClearInternal() = 0;
 
-	// Sets internal fields from loaded file
+	// Sets internal fields from legacy file which has no container header
 	virtual bool LoadInternal(std::ifstream& input) = 0;
 
-	// Saves internal fields into the file
-	virtual bool SaveInternal(std::ofstream& output) = 0;
+	// Sets internal fields from sections of loaded container
+	virtual bool LoadInternal(const BinaryContainer& container) = 0;
+
+	// Saves internal fields into sections of container
+	virtual bool SaveInternal(BinaryContainer& container) = 0;
+
+	// Returns container file type of specific builder
+	virtual uint32_t GetContainerType() const = 0;
 
 	// Create dummy internal implementation
 	virtual void CreateDummyInternal() = 0;
@@ -31,6 +38,10 @@ protected:
 		ERROR_CANNOT_OPEN_FILE_FOR_READING,
 		ERROR_EMPTY_FILENAME_CANNOT_OPEN_FILE_FOR_WRITING,
 		ERROR_CANNOT_OPEN_FILE_FOR_WRITING,
+		ERROR_CANNOT_WRITE_FILE,
+		ERROR_FILE_IS_CORRUPTED,
+		ERROR_UNSUPPORTED_FILE_VERSION,
+		ERROR_INCORRECT_FILE_TYPE,
 		LAST_ENUM_OPERATION_INDEX
 	};
 
@@ -65,6 +76,10 @@ protected:
 		m_operationsMap.insert(std::pair(ERROR_CANNOT_OPEN_FILE_FOR_READING, "Error: cannot open file for reading!"));
 		m_operationsMap.insert(std::pair(ERROR_EMPTY_FILENAME_CANNOT_OPEN_FILE_FOR_WRITING, "Error: filename is empty, cannot open file for writing!"));
 		m_operationsMap.insert(std::pair(ERROR_CANNOT_OPEN_FILE_FOR_WRITING, "Error: cannot open file for writing!"));
+		m_operationsMap.insert(std::pair(ERROR_CANNOT_WRITE_FILE, "Error: cannot write file!"));
+		m_operationsMap.insert(std::pair(ERROR_FILE_IS_CORRUPTED, "Error: file is corrupted, checksum or section lengths are incorrect!"));
+		m_operationsMap.insert(std::pair(ERROR_UNSUPPORTED_FILE_VERSION, "Error: file version is not supported!"));
+		m_operationsMap.insert(std::pair(ERROR_INCORRECT_FILE_TYPE, "Error: file contains different type of data!"));
 		m_lastOperationStatus = ERROR_UNKNOWN;
 		m_validated = false;
 	}
@@ -113,8 +128,36 @@ public:
 			return false;
 		}
 
-		if (!LoadInternal(input))
-			return false;
+		// Files without container header are imported as legacy files
+		if (!BinaryContainer::IsContainer(input))
+		{
+			if (!LoadInternal(input))
+				return false;
+		}
+		else
+		{
+			BinaryContainer container;
+			switch (container.Read(input))
+			{
+				case BinaryContainer::READ_SUCCESS:
+					break;
+				case BinaryContainer::READ_ERROR_UNSUPPORTED_VERSION:
+					m_lastOperationStatus = ERROR_UNSUPPORTED_FILE_VERSION;
+					return false;
+				default:
+					m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+					return false;
+			}
+
+			if (container.GetType() != GetContainerType())
+			{
+				m_lastOperationStatus = ERROR_INCORRECT_FILE_TYPE;
+				return false;
+			}
+
+			if (!LoadInternal(container))
+				return false;
+		}
 
 		m_lastOperationStatus = SUCCESS_LOAD_COMPLETED;
 		m_validated = true;
@@ -143,9 +186,16 @@ public:
 			return false;
 		}
 
-		if (!SaveInternal(output))
+		BinaryContainer container(GetContainerType());
+		if (!SaveInternal(container))
 			return false;
 
+		if (!container.Write(output))
+		{
+			m_lastOperationStatus = ERROR_CANNOT_WRITE_FILE;
+			return false;
+		}
+
 		// Clear data
 		Clear();
 
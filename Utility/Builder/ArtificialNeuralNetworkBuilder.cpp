@@ -252,48 +252,99 @@ bool ArtificialNeuralNetworkBuilder::LoadInternal(std::ifstream& input)
 
 	// Read raw data
 	m_rawData.resize(m_numberOfWeights);
-	for (size_t i = 0; i < m_numberOfWeights; ++i)
-		input.read((char*)&m_rawData[i], sizeof(Neuron));
+	input.read((char*)m_rawData.data(), std::streamsize(m_rawData.size() * sizeof(Neuron)));
+	if (!input)
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
 
 	return true;
 }
 
-bool ArtificialNeuralNetworkBuilder::SaveInternal(std::ofstream& output)
+bool ArtificialNeuralNetworkBuilder::LoadInternal(const BinaryContainer& container)
 {
-	// Save number of neuron layers
-	const size_t numberOfLayers = m_neuronLayerSizes.size();
-	output.write((const char*)&numberOfLayers, sizeof(numberOfLayers));
+	std::vector<uint64_t> neuronLayerSizes;
+	std::vector<uint64_t> activationFunctionIndexes;
+	BiasVector biasVector;
+	if (!container.GetSection(m_layersSection, neuronLayerSizes) ||
+		!container.GetSection(m_activationFunctionsSection, activationFunctionIndexes) ||
+		!container.GetSection(m_biasSection, biasVector) ||
+		!container.GetSection(m_weightsSection, m_rawData))
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
 
-	// Save each neuron layer size
-	for (const auto& neuronLayerSize : m_neuronLayerSizes)
-		output.write((const char*)&neuronLayerSize, sizeof(neuronLayerSize));
+	// Set each neuron layer size
+	if (!ValidateNumberOfLayers(neuronLayerSizes.size()))
+		return false;
 
-	// Save number of activation function indexes
-	const size_t numberOfActivationFunctionIndexes = m_activationFunctionIndexes.size();
-	output.write((const char*)&numberOfActivationFunctionIndexes, sizeof(numberOfActivationFunctionIndexes));
+	for (const auto& neuronLayerSize : neuronLayerSizes)
+	{
+		if (!ValidateNumberOfNeurons(size_t(neuronLayerSize)))
+			return false;
+		m_neuronLayerSizes.push_back(NeuronLayerSize(neuronLayerSize));
+	}
 
-	// Save each activation function index
-	for (const auto& activationFunctionIndex : m_activationFunctionIndexes)
-		output.write((const char*)&activationFunctionIndex, sizeof(activationFunctionIndex));
+	if (!ValidateNumberOfNeuronsInOutputLayer(m_neuronLayerSizes.back()))
+		return false;
 
-	// Save length of bias vector
-	const size_t lengthOfBiasVector = m_biasVector.size();
-	output.write((const char*)&lengthOfBiasVector, sizeof(lengthOfBiasVector));
+	CalculateNumberOfNeurons();
 
-	// Save each bias
-	for (const auto& bias : m_biasVector)
-		output.write((const char*)&bias, sizeof(bias));
+	CalculateNumberOfWeights();
 
-	// Save number of weights
-	output.write((const char*)&m_numberOfWeights, sizeof(m_numberOfWeights));
+	// Set each activation function index
+	if (!ValidateNumberOfActivationFunctionIndexes(activationFunctionIndexes.size()))
+		return false;
 
-	// Save raw data
-	for (auto & data : m_rawData)
-		output.write((const char*)&data, sizeof(Neuron));
+	for (const auto& activationFunctionIndex : activationFunctionIndexes)
+	{
+		if (!ValidateActivationFunctionIndex(ActivationFunctionIndex(activationFunctionIndex)))
+			return false;
+		m_activationFunctionIndexes.push_back(ActivationFunctionIndex(activationFunctionIndex));
+	}
 
+	// Set each bias
+	if (!ValidateBiasVectorLength(biasVector.size()))
+		return false;
+
+	for (const auto& bias : biasVector)
+	{
+		if (!ValidateBias(bias))
+			return false;
+		m_biasVector.push_back(bias);
+	}
+
+	// Raw data was read at once, only its length is checked
+	if (m_rawData.size() != m_numberOfWeights)
+	{
+		m_lastOperationStatus = ERROR_NUMBER_OF_WEIGHTS_MISMATCH;
+		return false;
+	}
+
+	return true;
+}
+
+bool ArtificialNeuralNetworkBuilder::SaveInternal(BinaryContainer& container)
+{
+	// Sizes and indexes are saved with fixed width so that files do not depend on the platform
+	const std::vector<uint64_t> neuronLayerSizes(m_neuronLayerSizes.begin(), m_neuronLayerSizes.end());
+	const std::vector<uint64_t> activationFunctionIndexes(m_activationFunctionIndexes.begin(), m_activationFunctionIndexes.end());
+	container.AddSection(m_layersSection, neuronLayerSizes);
+	container.AddSection(m_activationFunctionsSection, activationFunctionIndexes);
+	container.AddSection(m_biasSection, m_biasVector);
+
+	// Number of weights is given by section length
+	container.AddSection(m_weightsSection, m_rawData);
 	return true;
 }
 
+uint32_t ArtificialNeuralNetworkBuilder::GetContainerType() const
+{
+	return m_containerType;
+}
+
 void ArtificialNeuralNetworkBuilder::CreateDummyInternal()
 {
 	// Rand dummy data
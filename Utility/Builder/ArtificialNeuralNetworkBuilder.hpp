@@ -28,6 +28,11 @@ class ArtificialNeuralNetworkBuilder final :
 	std::vector<Neuron> m_rawData;
 	size_t m_numberOfNeurons;
 	size_t m_numberOfWeights;
+	inline static const uint32_t m_containerType = BinaryContainer::MakeIdentifier("ANN ");
+	inline static const uint32_t m_layersSection = BinaryContainer::MakeIdentifier("LAYR"); // Neuron layer sizes
+	inline static const uint32_t m_activationFunctionsSection = BinaryContainer::MakeIdentifier("ACTV"); // Activation function indexes
+	inline static const uint32_t m_biasSection = BinaryContainer::MakeIdentifier("BIAS");
+	inline static const uint32_t m_weightsSection = BinaryContainer::MakeIdentifier("WGHT");
 
 	// Validates number of layers
 	bool ValidateNumberOfLayers(const size_t size);
@@ -65,11 +70,17 @@ class ArtificialNeuralNetworkBuilder final :
 	// Clears internal fields
 	void ClearInternal();
 
-	// Loads artificial neural network from file
+	// Loads artificial neural network from legacy file
 	bool LoadInternal(std::ifstream& input);
 
-	// Saves artificial neural network to file
-	bool SaveInternal(std::ofstream& output);
+	// Loads artificial neural network from container
+	bool LoadInternal(const BinaryContainer& container);
+
+	// Saves artificial neural network to container
+	bool SaveInternal(BinaryContainer& container);
+
+	// Returns container file type of artificial neural network
+	uint32_t GetContainerType() const;
 
 	// Creates dummy artificial neural network
 	void CreateDummyInternal();
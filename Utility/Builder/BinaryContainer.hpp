@@ -0,0 +1,289 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Portable binary file made of length-prefixed sections
+// Layout: header (magic, version, flags, file type, number of sections), sections (id, length, data padded to 8 bytes), CRC32 of all preceding bytes
+// All values are stored in little-endian byte order with fixed width, so files do not depend on the platform which wrote them
+// Whole file is read with one read call and sections are copied with one memcpy each
+class BinaryContainer final
+{
+public:
+
+	// Read statuses
+	enum
+	{
+		READ_SUCCESS,
+		READ_ERROR_NOT_CONTAINER,
+		READ_ERROR_UNSUPPORTED_VERSION,
+		READ_ERROR_CORRUPTED
+	};
+
+	BinaryContainer(uint32_t type = 0) :
+		m_type(type)
+	{
+	}
+
+	~BinaryContainer()
+	{
+	}
+
+	// Returns four character code used as file type and section identifier
+	constexpr static uint32_t MakeIdentifier(const char(&code)[5])
+	{
+		return uint32_t(uint8_t(code[0])) | (uint32_t(uint8_t(code[1])) << 8) | (uint32_t(uint8_t(code[2])) << 16) | (uint32_t(uint8_t(code[3])) << 24);
+	}
+
+	// Returns file type
+	inline uint32_t GetType() const
+	{
+		return m_type;
+	}
+
+	// Returns true if stream starts with container magic, stream position is not changed
+	inline static bool IsContainer(std::ifstream& input)
+	{
+		const auto position = input.tellg();
+		std::array<char, 4> magic = {};
+		input.read(magic.data(), magic.size());
+		const bool result = input.gcount() == std::streamsize(magic.size()) && std::memcmp(magic.data(), m_magic, magic.size()) == 0;
+		input.clear();
+		input.seekg(position);
+		return result;
+	}
+
+	// Adds section with array of scalars
+	template<class Type>
+	void AddSection(uint32_t identifier, const Type* data, size_t count)
+	{
+		static_assert(std::is_arithmetic<Type>::value, "Sections hold arrays of scalars");
+		const Section section = { identifier, m_data.size(), count * sizeof(Type) };
+		m_data.resize(Align(section.m_offset + section.m_length), 0);
+		if (count)
+			std::memcpy(m_data.data() + section.m_offset, data, section.m_length);
+		ToLittleEndian(m_data.data() + section.m_offset, count, sizeof(Type));
+		m_sections.push_back(section);
+	}
+
+	// Adds section with vector of scalars
+	template<class Type>
+	void AddSection(uint32_t identifier, const std::vector<Type>& data)
+	{
+		AddSection(identifier, data.data(), data.size());
+	}
+
+	// Copies section into vector of scalars, returns false if there is no such section or its length is incorrect
+	template<class Type>
+	bool GetSection(uint32_t identifier, std::vector<Type>& data) const
+	{
+		static_assert(std::is_arithmetic<Type>::value, "Sections hold arrays of scalars");
+		const Section* section = FindSection(identifier);
+		if (!section || section->m_length % sizeof(Type))
+			return false;
+
+		const size_t count = section->m_length / sizeof(Type);
+		data.resize(count);
+		if (count)
+			std::memcpy(data.data(), m_data.data() + section->m_offset, section->m_length);
+		ToLittleEndian(reinterpret_cast<char*>(data.data()), count, sizeof(Type));
+		return true;
+	}
+
+	// Copies section into array of exactly count scalars, returns false if there is no such section or its length is different
+	template<class Type>
+	bool GetSection(uint32_t identifier, Type* data, size_t count) const
+	{
+		static_assert(std::is_arithmetic<Type>::value, "Sections hold arrays of scalars");
+		const Section* section = FindSection(identifier);
+		if (!section || section->m_length != count * sizeof(Type))
+			return false;
+
+		if (count)
+			std::memcpy(data, m_data.data() + section->m_offset, section->m_length);
+		ToLittleEndian(reinterpret_cast<char*>(data), count, sizeof(Type));
+		return true;
+	}
+
+	// Writes header, sections and checksum with one write call
+	bool Write(std::ofstream& output) const
+	{
+		std::vector<char> buffer;
+		buffer.insert(buffer.end(), m_magic, m_magic + 4);
+		Append(buffer, uint16_t(m_version));
+		Append(buffer, uint16_t(LITTLE_ENDIAN_FLAG));
+		Append(buffer, m_type);
+		Append(buffer, uint32_t(m_sections.size()));
+		for (const auto& section : m_sections)
+		{
+			Append(buffer, section.m_identifier);
+			Append(buffer, uint32_t(0));
+			Append(buffer, uint64_t(section.m_length));
+			buffer.insert(buffer.end(), m_data.begin() + section.m_offset, m_data.begin() + Align(section.m_offset + section.m_length));
+		}
+
+		Append(buffer, CalculateChecksum(buffer.data(), buffer.size()));
+		output.write(buffer.data(), std::streamsize(buffer.size()));
+		return bool(output);
+	}
+
+	// Reads whole file with one read call, validates checksum and splits it into sections, section data is not copied
+	size_t Read(std::ifstream& input)
+	{
+		m_sections.clear();
+		m_data.clear();
+		input.seekg(0, std::ios::end);
+		const auto fileSize = input.tellg();
+		input.seekg(0, std::ios::beg);
+		if (fileSize < std::streamoff(m_headerSize + m_checksumSize))
+			return READ_ERROR_NOT_CONTAINER;
+
+		std::vector<char> buffer(static_cast<size_t>(fileSize));
+		input.read(buffer.data(), fileSize);
+		if (input.gcount() != fileSize)
+			return READ_ERROR_CORRUPTED;
+
+		if (std::memcmp(buffer.data(), m_magic, 4))
+			return READ_ERROR_NOT_CONTAINER;
+
+		const size_t dataSize = buffer.size() - m_checksumSize;
+		if (Extract<uint32_t>(buffer, dataSize) != CalculateChecksum(buffer.data(), dataSize))
+			return READ_ERROR_CORRUPTED;
+
+		if (Extract<uint16_t>(buffer, 4) > m_version)
+			return READ_ERROR_UNSUPPORTED_VERSION;
+
+		m_type = Extract<uint32_t>(buffer, 8);
+		const uint32_t numberOfSections = Extract<uint32_t>(buffer, 12);
+		size_t offset = m_headerSize;
+		for (uint32_t i = 0; i < numberOfSections; ++i)
+		{
+			if (offset + m_sectionHeaderSize > dataSize)
+				return READ_ERROR_CORRUPTED;
+
+			const uint32_t identifier = Extract<uint32_t>(buffer, offset);
+			const uint64_t length = Extract<uint64_t>(buffer, offset + 8);
+			offset += m_sectionHeaderSize;
+			if (length > dataSize - offset)
+				return READ_ERROR_CORRUPTED;
+
+			m_sections.push_back({ identifier, offset, size_t(length) });
+			offset = Align(offset + size_t(length));
+		}
+
+		m_data.swap(buffer);
+		return READ_SUCCESS;
+	}
+
+	// Returns CRC32 of data
+	inline static uint32_t CalculateChecksum(const char* data, size_t size, uint32_t crc = 0)
+	{
+		static const std::array<uint32_t, 256> table = [] {
+			std::array<uint32_t, 256> result = {};
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t value = i;
+				for (size_t j = 0; j < 8; ++j)
+					value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+				result[i] = value;
+			}
+			return result;
+		}();
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; ++i)
+			crc = table[(crc ^ uint8_t(data[i])) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	// Returns true if platform stores values in little-endian byte order
+	inline static bool IsLittleEndian()
+	{
+		const uint16_t probe = 1;
+		uint8_t firstByte = 0;
+		std::memcpy(&firstByte, &probe, 1);
+		return firstByte == 1;
+	}
+
+	// Swaps byte order of count values of given size if platform is big-endian, conversion works both ways
+	inline static void ToLittleEndian(char* data, size_t count, size_t size)
+	{
+		if (size == 1 || IsLittleEndian())
+			return;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			char* value = data + i * size;
+			for (size_t j = 0; j < size / 2; ++j)
+				std::swap(value[j], value[size - 1 - j]);
+		}
+	}
+
+private:
+
+	enum
+	{
+		LITTLE_ENDIAN_FLAG = 1 << 0
+	};
+
+	// Section data is a part of data buffer
+	struct Section
+	{
+		uint32_t m_identifier;
+		size_t m_offset;
+		size_t m_length;
+	};
+
+	// Returns section with given identifier or nullptr
+	inline const Section* FindSection(uint32_t identifier) const
+	{
+		for (const auto& section : m_sections)
+		{
+			if (section.m_identifier == identifier)
+				return &section;
+		}
+
+		return nullptr;
+	}
+
+	// Rounds offset up to the multiple of 8 bytes so that sections stay aligned when file is mapped
+	inline static size_t Align(size_t offset)
+	{
+		return (offset + 7) & ~size_t(7);
+	}
+
+	// Appends value in little-endian byte order
+	template<class Type>
+	static void Append(std::vector<char>& buffer, Type value)
+	{
+		char bytes[sizeof(Type)];
+		std::memcpy(bytes, &value, sizeof(Type));
+		ToLittleEndian(bytes, 1, sizeof(Type));
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(Type));
+	}
+
+	// Returns value stored in little-endian byte order at offset
+	template<class Type>
+	static Type Extract(const std::vector<char>& buffer, size_t offset)
+	{
+		char bytes[sizeof(Type)];
+		std::memcpy(bytes, buffer.data() + offset, sizeof(Type));
+		ToLittleEndian(bytes, 1, sizeof(Type));
+		Type value;
+		std::memcpy(&value, bytes, sizeof(Type));
+		return value;
+	}
+
+	inline static const char m_magic[5] = "AVSF";
+	inline static const uint16_t m_version = 1;
+	inline static const size_t m_headerSize = 16;
+	inline static const size_t m_sectionHeaderSize = 16;
+	inline static const size_t m_checksumSize = 4;
+	uint32_t m_type;
+	std::vector<Section> m_sections;
+	std::vector<char> m_data; // Aligned section data when writing, whole file when reading
+};
@@ -1,6 +1,7 @@
 #include "MapBuilder.hpp"
 #include "CoreLogger.hpp"
 #include "CoreWindow.hpp"
+#include "JobSystem.hpp"
 
 std::pair<sf::Vector2f, sf::Vector2f> MapBuilder::m_maxAllowedMapArea;
 std::pair<sf::Vector2f, sf::Vector2f> MapBuilder::m_maxAllowedViewArea;
@@ -47,31 +48,36 @@ EdgeVector MapBuilder::RectangleCheckpointsGenerator::GenerateInternal(const Edg
 		result[i][1] = outerEdgesChain[i][0];
 	}
 
-	// Validate if there are no intersections with inner edges chain
+	// Validate if there are no intersections with inner edges chain, checkpoints are validated in parallel
 	auto Validate = [](const EdgeVector& checkpoints, const EdgeVector& edgesChain) {
 		const size_t length = checkpoints.size();
-
-		for (size_t i = 0; i < length; ++i)
-		{
-			for (size_t j = 0; j < length; ++j)
+		std::atomic<bool> valid = true;
+		JobSystem::GetInstance().ParallelFor(0, length, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end && valid.load(std::memory_order_relaxed); ++i)
 			{
-				if (i == j)
-					continue;
-
-				if (i == 0)
+				for (size_t j = 0; j < length; ++j)
 				{
-					if (j == length - 1)
+					if (i == j)
 						continue;
-				}
-				else if (i - 1 == j)
-					continue;
 
-				if (MathContext::Intersect(checkpoints[i], edgesChain[j]))
-					return false;
+					if (i == 0)
+					{
+						if (j == length - 1)
+							continue;
+					}
+					else if (i - 1 == j)
+						continue;
+
+					if (MathContext::Intersect(checkpoints[i], edgesChain[j]))
+					{
+						valid.store(false, std::memory_order_relaxed);
+						return;
+					}
+				}
 			}
-		}
+		});
 
-		return true;
+		return valid.load();
 	};
 
 	if (!Validate(result, innerEdgesChain))
@@ -83,6 +89,11 @@ EdgeVector MapBuilder::RectangleCheckpointsGenerator::GenerateInternal(const Edg
 	return result;
 }
 
+float MapBuilder::RectangleCheckpointsGenerator::GetMinWidth()
+{
+	return CoreWindow::GetWindowSize().x / 16.f;
+}
+
 RectangleVector MapBuilder::RectangleCheckpointsGenerator::Generate(const EdgeVector& innerEdgesChain, const EdgeVector& outerEdgesChain)
 {
 	const auto lineCheckpoints = GenerateInternal(innerEdgesChain, outerEdgesChain);
@@ -90,7 +101,7 @@ RectangleVector MapBuilder::RectangleCheckpointsGenerator::Generate(const EdgeVe
 		return {};
 
 	auto AddRectangleCheckpoints = [](RectangleVector& result, const Edge& beginEdge, const Edge& endEdge) {
-		const double minWidth = double(CoreWindow::GetWindowSize().x / 16.f);
+		const double minWidth = double(GetMinWidth());
 		const auto innerDistance = MathContext::Distance(beginEdge[0], endEdge[0]);
 		const auto outerDistance = MathContext::Distance(beginEdge[1], endEdge[1]);
 		const size_t innerCount = size_t(innerDistance / minWidth);
@@ -147,22 +158,27 @@ RectangleVector MapBuilder::RectangleCheckpointsGenerator::Generate(const EdgeVe
 		return true;
 	};
 
-	// Generate rectangle checkpoints
+	// Generate rectangle checkpoints and check them against edges, every segment between line checkpoints is independent
 	const auto numberOfLineCheckpoints = lineCheckpoints.size();
-	const auto lastLineCheckpointIndex = numberOfLineCheckpoints - 1;
 	std::vector<RectangleVector> subresults(numberOfLineCheckpoints);
-	for (size_t i = 0; i < lastLineCheckpointIndex; ++i)
-		AddRectangleCheckpoints(subresults[i], lineCheckpoints[i], lineCheckpoints[i + 1]);
-	AddRectangleCheckpoints(subresults[lastLineCheckpointIndex], lineCheckpoints[lastLineCheckpointIndex], lineCheckpoints[0]);
+	std::atomic<bool> valid = true;
+	JobSystem::GetInstance().ParallelFor(0, numberOfLineCheckpoints, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end && valid.load(std::memory_order_relaxed); ++i)
+		{
+			const size_t next = (i + 1) % numberOfLineCheckpoints;
+			AddRectangleCheckpoints(subresults[i], lineCheckpoints[i], lineCheckpoints[next]);
+			if (!CheckCollision(subresults[i], i, innerEdgesChain, outerEdgesChain))
+				valid.store(false, std::memory_order_relaxed);
+		}
+	});
+
+	if (!valid.load())
+		return {};
 
-	// Check chepoints against edges and create result at the same time
+	// Create result
 	RectangleVector result;
 	for (size_t i = 0; i < subresults.size(); ++i)
-	{
-		if (!CheckCollision(subresults[i], i, innerEdgesChain, outerEdgesChain))
-			return {};
 		result.insert(result.end(), subresults[i].begin(), subresults[i].end());
-	}
 		
 	return result;
 }
@@ -242,16 +258,26 @@ bool MapBuilder::ValidateNumberOfEdgesPerChain(size_t count)
 
 bool MapBuilder::ValidateEdgesChainsIntersection()
 {
-	for (const auto & innerEdge : m_innerEdgesChain)
-	{
-		for (const auto& outerEdge : m_outerEdgesChain)
+	// Inner edges are checked in parallel
+	std::atomic<bool> intersection = false;
+	JobSystem::GetInstance().ParallelFor(0, m_innerEdgesChain.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end && !intersection.load(std::memory_order_relaxed); ++i)
 		{
-			if (MathContext::Intersect(innerEdge, outerEdge))
+			for (const auto& outerEdge : m_outerEdgesChain)
 			{
-				m_lastOperationStatus = ERROR_TWO_EDGES_INTERSECTION;
-				return false;
+				if (MathContext::Intersect(m_innerEdgesChain[i], outerEdge))
+				{
+					intersection.store(true, std::memory_order_relaxed);
+					return;
+				}
 			}
 		}
+	});
+
+	if (intersection.load())
+	{
+		m_lastOperationStatus = ERROR_TWO_EDGES_INTERSECTION;
+		return false;
 	}
 
 	return true;
@@ -276,7 +302,8 @@ bool MapBuilder::ValidatesEdgesChains()
 
 bool MapBuilder::ValidateCheckpoints()
 {
-	if (RectangleCheckpointsGenerator::Generate(m_innerEdgesChain, m_outerEdgesChain).empty())
+	m_checkpoints = RectangleCheckpointsGenerator::Generate(m_innerEdgesChain, m_outerEdgesChain);
+	if (m_checkpoints.empty())
 	{
 		m_lastOperationStatus = ERROR_CANNOT_GENERATE_ALL_CHECKPOINTS;
 		return false;
@@ -324,6 +351,7 @@ void MapBuilder::ClearInternal()
 {
 	m_innerEdgesChain.clear();
 	m_outerEdgesChain.clear();
+	m_checkpoints.clear();
 	m_vehiclePositioned = false;
 }
 
@@ -351,20 +379,68 @@ bool MapBuilder::LoadInternal(std::ifstream& input)
 	if (!ValidateNumberOfEdgesPerChain(numberOfEdgesPerChain))
 		return false;
 
-	// Read inner edges points
-	m_innerEdgesChain.resize(numberOfEdgesPerChain);
-	for (auto& i : m_innerEdgesChain)
+	// Read inner and outer edges points, coordinates of every chain are stored one after another
+	std::vector<float> innerPoints(numberOfEdgesPerChain * 2);
+	std::vector<float> outerPoints(numberOfEdgesPerChain * 2);
+	input.read((char*)innerPoints.data(), std::streamsize(innerPoints.size() * sizeof(float)));
+	input.read((char*)outerPoints.data(), std::streamsize(outerPoints.size() * sizeof(float)));
+	if (!input)
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	return LoadEdgesChains(innerPoints, outerPoints);
+}
+
+bool MapBuilder::LoadInternal(const BinaryContainer& container)
+{
+	// Read vehicle center position and angle
+	std::array<double, 3> vehicle = {};
+	if (!container.GetSection(m_vehicleSection, vehicle.data(), vehicle.size()))
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	m_vehicleCenter = sf::Vector2f(float(vehicle[0]), float(vehicle[1]));
+	m_vehiclePositioned = true;
+	if (!ValidateMapAreaVehiclePosition())
+		return false;
+
+	m_vehicleAngle = vehicle[2];
+	if (!ValidateVehicleAngle())
+		return false;
+
+	// Read inner and outer edges points
+	std::vector<float> innerPoints;
+	std::vector<float> outerPoints;
+	if (!container.GetSection(m_innerEdgesSection, innerPoints) ||
+		!container.GetSection(m_outerEdgesSection, outerPoints) ||
+		innerPoints.size() != outerPoints.size() ||
+		innerPoints.size() % 2)
 	{
-		input.read((char*)&i[0].x, sizeof(i[0].x));
-		input.read((char*)&i[0].y, sizeof(i[0].y));
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
 	}
 
-	// Read outer edges points
+	if (!ValidateNumberOfEdgesPerChain(innerPoints.size() / 2))
+		return false;
+
+	// Derived data sections are optional, files without them or saved for different edges are validated from scratch
+	LoadCheckpoints(container, innerPoints, outerPoints);
+	return LoadEdgesChains(innerPoints, outerPoints);
+}
+
+bool MapBuilder::LoadEdgesChains(const std::vector<float>& innerPoints, const std::vector<float>& outerPoints)
+{
+	const size_t numberOfEdgesPerChain = innerPoints.size() / 2;
+	m_innerEdgesChain.resize(numberOfEdgesPerChain);
 	m_outerEdgesChain.resize(numberOfEdgesPerChain);
-	for (auto& i : m_outerEdgesChain)
+	for (size_t i = 0; i < numberOfEdgesPerChain; ++i)
 	{
-		input.read((char*)&i[0].x, sizeof(i[0].x));
-		input.read((char*)&i[0].y, sizeof(i[0].y));
+		m_innerEdgesChain[i][0] = sf::Vector2f(innerPoints[i * 2], innerPoints[i * 2 + 1]);
+		m_outerEdgesChain[i][0] = sf::Vector2f(outerPoints[i * 2], outerPoints[i * 2 + 1]);
 	}
 
 	// Pin edges
@@ -376,16 +452,20 @@ bool MapBuilder::LoadInternal(std::ifstream& input)
 	m_innerEdgesChain[numberOfEdgesPerChain - 1][1] = m_innerEdgesChain[0][0];
 	m_outerEdgesChain[numberOfEdgesPerChain - 1][1] = m_outerEdgesChain[0][0];
 
-	// Validate edges chains intersection
-	if (!ValidateEdgesChainsIntersection())
-		return false;
-
 	if (!ValidatesEdgesChains())
 		return false;
 
-	// Validate checkpoints
-	if (!ValidateCheckpoints())
-		return false;
+	// Checkpoints loaded for the same edges were generated after these edges passed all validations
+	if (m_checkpoints.empty())
+	{
+		// Validate edges chains intersection
+		if (!ValidateEdgesChainsIntersection())
+			return false;
+
+		// Validate checkpoints
+		if (!ValidateCheckpoints())
+			return false;
+	}
 
 	// Validate if vehicle center is inside road area
 	if (!ValidateRoadAreaVehiclePosition())
@@ -394,36 +474,88 @@ bool MapBuilder::LoadInternal(std::ifstream& input)
 	return true;
 }
 
-bool MapBuilder::SaveInternal(std::ofstream& output)
+std::array<uint32_t, 2> MapBuilder::CalculateDerivedDataKey(const std::vector<float>& innerPoints, const std::vector<float>& outerPoints)
+{
+	// Hash is calculated from little-endian representation, so that key does not depend on the platform
+	std::vector<float> values(innerPoints);
+	values.insert(values.end(), outerPoints.begin(), outerPoints.end());
+	values.push_back(RectangleCheckpointsGenerator::GetMinWidth());
+	std::vector<char> bytes(values.size() * sizeof(float));
+	std::memcpy(bytes.data(), values.data(), bytes.size());
+	BinaryContainer::ToLittleEndian(bytes.data(), values.size(), sizeof(float));
+	return { m_derivedDataVersion, BinaryContainer::CalculateChecksum(bytes.data(), bytes.size()) };
+}
+
+bool MapBuilder::LoadCheckpoints(const BinaryContainer& container, const std::vector<float>& innerPoints, const std::vector<float>& outerPoints)
 {
-	// Save vehicle center position
-	output.write((const char*)&m_vehicleCenter.x, sizeof(m_vehicleCenter.x));
-	output.write((const char*)&m_vehicleCenter.y, sizeof(m_vehicleCenter.y));
-
-	// Save vehicle angle
-	output.write((const char*)&m_vehicleAngle, sizeof(m_vehicleAngle));
-	
-	// Save number of edges per chain
-	const size_t numberOfEdgesPerChain = m_innerEdgesChain.size();
-	output.write((const char*)&numberOfEdgesPerChain, sizeof(numberOfEdgesPerChain));
-
-	// Save inner edges beggining position
-	for (auto& i : m_innerEdgesChain)
+	std::array<uint32_t, 2> key = {};
+	if (!container.GetSection(m_derivedDataKeySection, key.data(), key.size()) || key != CalculateDerivedDataKey(innerPoints, outerPoints))
+		return false;
+
+	std::vector<float> corners;
+	const size_t numberOfCornerValues = std::tuple_size<Rectangle>::value * 2;
+	if (!container.GetSection(m_checkpointsSection, corners) || corners.empty() || corners.size() % numberOfCornerValues)
+		return false;
+
+	m_checkpoints.resize(corners.size() / numberOfCornerValues);
+	for (size_t i = 0; i < m_checkpoints.size(); ++i)
+	{
+		for (size_t j = 0; j < m_checkpoints[i].size(); ++j)
+			m_checkpoints[i][j] = sf::Vector2f(corners[i * numberOfCornerValues + j * 2], corners[i * numberOfCornerValues + j * 2 + 1]);
+	}
+
+	return true;
+}
+
+bool MapBuilder::SaveInternal(BinaryContainer& container)
+{
+	// Save vehicle center position and angle
+	const std::array<double, 3> vehicle = { m_vehicleCenter.x, m_vehicleCenter.y, m_vehicleAngle };
+	container.AddSection(m_vehicleSection, vehicle.data(), vehicle.size());
+
+	// Save inner and outer edges beggining positions, number of edges per chain is given by section length
+	std::vector<float> innerPoints;
+	std::vector<float> outerPoints;
+	innerPoints.reserve(m_innerEdgesChain.size() * 2);
+	outerPoints.reserve(m_outerEdgesChain.size() * 2);
+	for (const auto& i : m_innerEdgesChain)
 	{
-		output.write((const char*)&i[0].x, sizeof(i[0].x));
-		output.write((const char*)&i[0].y, sizeof(i[0].y));
+		innerPoints.push_back(i[0].x);
+		innerPoints.push_back(i[0].y);
 	}
 
-	// Save outer edges beggining position
-	for (auto& i : m_outerEdgesChain)
+	for (const auto& i : m_outerEdgesChain)
+	{
+		outerPoints.push_back(i[0].x);
+		outerPoints.push_back(i[0].y);
+	}
+
+	container.AddSection(m_innerEdgesSection, innerPoints);
+	container.AddSection(m_outerEdgesSection, outerPoints);
+
+	// Save checkpoints generated during validation together with the key of edges they were generated for
+	std::vector<float> corners;
+	corners.reserve(m_checkpoints.size() * std::tuple_size<Rectangle>::value * 2);
+	for (const auto& checkpoint : m_checkpoints)
 	{
-		output.write((const char*)&i[0].x, sizeof(i[0].x));
-		output.write((const char*)&i[0].y, sizeof(i[0].y));
+		for (const auto& corner : checkpoint)
+		{
+			corners.push_back(corner.x);
+			corners.push_back(corner.y);
+		}
 	}
 
+	const auto key = CalculateDerivedDataKey(innerPoints, outerPoints);
+	container.AddSection(m_derivedDataKeySection, key.data(), key.size());
+	container.AddSection(m_checkpointsSection, corners);
 	return true;
 }
 
+uint32_t MapBuilder::GetContainerType() const
+{
+	return m_containerType;
+}
+
 void MapBuilder::CreateDummyInternal()
 {
 	const auto windowSize = CoreWindow::GetWindowSize();
@@ -493,8 +625,9 @@ MapPrototype* MapBuilder::Get()
 
 	const auto innerEdgesChain = EdgesChainGenerator::Generate(m_innerEdgesChain, false);
 	const auto outerEdgesChain = EdgesChainGenerator::Generate(m_outerEdgesChain, true);
-	const auto checkpoints = RectangleCheckpointsGenerator::Generate(m_innerEdgesChain, m_outerEdgesChain);
-	return new MapPrototype(innerEdgesChain, outerEdgesChain, checkpoints);
+	if (m_checkpoints.empty())
+		m_checkpoints = RectangleCheckpointsGenerator::Generate(m_innerEdgesChain, m_outerEdgesChain);
+	return new MapPrototype(innerEdgesChain, outerEdgesChain, m_checkpoints);
 }
 
 bool MapBuilder::Initialize()
@@ -23,11 +23,19 @@ class MapBuilder final :
 
 	EdgeVector m_innerEdgesChain;
 	EdgeVector m_outerEdgesChain;
+	RectangleVector m_checkpoints; // Generated during validation or loaded from file, reused by Get and Save
 	bool m_vehiclePositioned;
 	sf::Vector2f m_vehicleCenter;
 	double m_vehicleAngle;
 	static std::pair<sf::Vector2f, sf::Vector2f> m_maxAllowedMapArea;
 	static std::pair<sf::Vector2f, sf::Vector2f> m_maxAllowedViewArea;
+	inline static const uint32_t m_containerType = BinaryContainer::MakeIdentifier("MAP ");
+	inline static const uint32_t m_vehicleSection = BinaryContainer::MakeIdentifier("VHCL"); // Vehicle center position and angle
+	inline static const uint32_t m_innerEdgesSection = BinaryContainer::MakeIdentifier("INNR"); // Beginnings of inner edges
+	inline static const uint32_t m_outerEdgesSection = BinaryContainer::MakeIdentifier("OUTR"); // Beginnings of outer edges
+	inline static const uint32_t m_derivedDataKeySection = BinaryContainer::MakeIdentifier("DKEY"); // Version of derived data and hash of edges it was derived from
+	inline static const uint32_t m_checkpointsSection = BinaryContainer::MakeIdentifier("CHKP"); // Corners of rectangle checkpoints
+	inline static const uint32_t m_derivedDataVersion = 1; // Has to be increased when checkpoints generation changes
 
 	class EdgesChainGenerator
 	{
@@ -47,6 +55,9 @@ class MapBuilder final :
 
 	public:
 
+		// Returns minimum width of rectangle checkpoint, it depends on window size
+		static float GetMinWidth();
+
 		// Generates rectangle checkpoints for given vector of edges chains
 		static RectangleVector Generate(const EdgeVector& innerEdgesChain, const EdgeVector& outerEdgesChain);
 	};
@@ -72,17 +83,33 @@ class MapBuilder final :
 	// Validate checkpoints by creating dummies
 	bool ValidateCheckpoints();
 
+	// Sets edges chains from interleaved coordinates of edges beginnings and validates them
+	// If checkpoints were loaded for the same edges then expensive intersection checks and checkpoints generation are skipped
+	bool LoadEdgesChains(const std::vector<float>& innerPoints, const std::vector<float>& outerPoints);
+
+	// Returns key of derived data, it changes if edges, checkpoints minimum width or derived data version change
+	static std::array<uint32_t, 2> CalculateDerivedDataKey(const std::vector<float>& innerPoints, const std::vector<float>& outerPoints);
+
+	// Loads checkpoints if they were saved for the same edges, returns false if they have to be generated again
+	bool LoadCheckpoints(const BinaryContainer& container, const std::vector<float>& innerPoints, const std::vector<float>& outerPoints);
+
 	// Validate internal fields
 	bool ValidateInternal();
 
 	// Clears internal fields
 	void ClearInternal();
 
-	// Loads map from file
+	// Loads map from legacy file
 	bool LoadInternal(std::ifstream& input);
 
-	// Saves map to file
-	bool SaveInternal(std::ofstream& output);
+	// Loads map from container
+	bool LoadInternal(const BinaryContainer& container);
+
+	// Saves map to container
+	bool SaveInternal(BinaryContainer& container);
+
+	// Returns container file type of map
+	uint32_t GetContainerType() const;
 
 	// Creates dummy map
 	void CreateDummyInternal();
@@ -0,0 +1,317 @@
+#include "PopulationArchive.hpp"
+#include "BinaryContainer.hpp"
+#include <algorithm>
+#include <cstddef>
+
+static_assert(sizeof(Neuron) == sizeof(uint64_t) && sizeof(ActivationFunctionIndex) <= sizeof(uint64_t), "Archive stores 64-bit values");
+
+PopulationArchive::PopulationArchive() :
+	m_weightsOffset(0),
+	m_numberOfWeights(0),
+	m_rowStride(0),
+	m_numberOfIndividuals(0)
+{
+	static_assert(sizeof(Header) == 64, "Header has to be 64 bytes long");
+	m_operationsMap.insert(std::pair(SUCCESS_SAVE_COMPLETED, "Success: correctly saved population archive!"));
+	m_operationsMap.insert(std::pair(SUCCESS_LOAD_COMPLETED, "Success: correctly loaded population archive!"));
+	m_operationsMap.insert(std::pair(ERROR_EMPTY_FILENAME, "Error: filename is empty!"));
+	m_operationsMap.insert(std::pair(ERROR_CANNOT_OPEN_FILE_FOR_WRITING, "Error: cannot open file for writing!"));
+	m_operationsMap.insert(std::pair(ERROR_CANNOT_OPEN_FILE_FOR_READING, "Error: cannot open file for reading!"));
+	m_operationsMap.insert(std::pair(ERROR_FILE_IS_NOT_POPULATION_ARCHIVE, "Error: file is not a population archive!"));
+	m_operationsMap.insert(std::pair(ERROR_UNSUPPORTED_FILE_VERSION, "Error: unsupported version of population archive!"));
+	m_operationsMap.insert(std::pair(ERROR_FILE_IS_CORRUPTED, "Error: population archive is corrupted!"));
+	m_operationsMap.insert(std::pair(ERROR_DIFFERENT_TOPOLOGY, "Error: population archive has different topology!"));
+	m_operationsMap.insert(std::pair(ERROR_ARCHIVE_IS_NOT_OPENED_FOR_APPENDING, "Error: population archive is not opened for appending!"));
+	m_lastOperationStatus = ERROR_UNKNOWN;
+}
+
+PopulationArchive::~PopulationArchive()
+{
+	Close();
+}
+
+bool PopulationArchive::Create(const std::string& filename,
+							   const NeuronLayerSizes& neuronLayerSizes,
+							   const ActivationFunctionIndexes& activationFunctionIndexes,
+							   const BiasVector& biasVector)
+{
+	Close();
+	if (filename.empty())
+	{
+		m_lastOperationStatus = ERROR_EMPTY_FILENAME;
+		return false;
+	}
+
+	const std::vector<char> topology = MakeTopology(neuronLayerSizes, activationFunctionIndexes, biasVector);
+	Header header = {};
+	std::memcpy(header.m_magic, m_magic, sizeof(header.m_magic));
+	header.m_version = m_version;
+	header.m_flags = BinaryContainer::IsLittleEndian() ? m_littleEndianFlag : 0;
+	header.m_topologyChecksum = BinaryContainer::CalculateChecksum(topology.data(), topology.size());
+	header.m_weightsOffset = sizeof(Header) + topology.size();
+	header.m_numberOfWeights = CalculateNumberOfWeights(neuronLayerSizes);
+	header.m_rowStride = Align(size_t(header.m_numberOfWeights), m_alignment / sizeof(Neuron));
+	header.m_numberOfIndividuals = 0;
+	header.m_numberOfLayers = neuronLayerSizes.size();
+
+	{
+		std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		output.write(topology.data(), std::streamsize(topology.size()));
+		if (!output)
+		{
+			m_lastOperationStatus = ERROR_CANNOT_OPEN_FILE_FOR_WRITING;
+			return false;
+		}
+	}
+
+	m_output.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+	if (!m_output.is_open())
+	{
+		m_lastOperationStatus = ERROR_CANNOT_OPEN_FILE_FOR_WRITING;
+		return false;
+	}
+
+	m_weightsOffset = size_t(header.m_weightsOffset);
+	m_numberOfWeights = size_t(header.m_numberOfWeights);
+	m_rowStride = size_t(header.m_rowStride);
+	m_numberOfIndividuals = 0;
+	m_neuronLayerSizes = neuronLayerSizes;
+	m_activationFunctionIndexes = activationFunctionIndexes;
+	m_biasVector = biasVector;
+	m_lastOperationStatus = SUCCESS_SAVE_COMPLETED;
+	return true;
+}
+
+bool PopulationArchive::OpenForAppending(const std::string& filename,
+										 const NeuronLayerSizes& neuronLayerSizes,
+										 const ActivationFunctionIndexes& activationFunctionIndexes,
+										 const BiasVector& biasVector)
+{
+	if (!Open(filename))
+		return false;
+
+	const bool sameTopology = m_neuronLayerSizes == neuronLayerSizes &&
+		m_activationFunctionIndexes == activationFunctionIndexes &&
+		m_biasVector == biasVector;
+	const size_t weightsOffset = m_weightsOffset;
+	const size_t numberOfWeights = m_numberOfWeights;
+	const size_t rowStride = m_rowStride;
+	const size_t numberOfIndividuals = m_numberOfIndividuals;
+	Close();
+	if (!sameTopology)
+	{
+		m_lastOperationStatus = ERROR_DIFFERENT_TOPOLOGY;
+		return false;
+	}
+
+	m_output.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+	if (!m_output.is_open())
+	{
+		m_lastOperationStatus = ERROR_CANNOT_OPEN_FILE_FOR_WRITING;
+		return false;
+	}
+
+	m_weightsOffset = weightsOffset;
+	m_numberOfWeights = numberOfWeights;
+	m_rowStride = rowStride;
+	m_numberOfIndividuals = numberOfIndividuals;
+	m_neuronLayerSizes = neuronLayerSizes;
+	m_activationFunctionIndexes = activationFunctionIndexes;
+	m_biasVector = biasVector;
+	m_lastOperationStatus = SUCCESS_SAVE_COMPLETED;
+	return true;
+}
+
+bool PopulationArchive::Append(const Neuron* individuals, size_t numberOfIndividuals)
+{
+	if (!m_output.is_open())
+	{
+		m_lastOperationStatus = ERROR_ARCHIVE_IS_NOT_OPENED_FOR_APPENDING;
+		return false;
+	}
+
+	// Rows are copied into one padded buffer and written with one write call
+	std::vector<Neuron> rows(numberOfIndividuals * m_rowStride, 0.0);
+	for (size_t i = 0; i < numberOfIndividuals; ++i)
+		std::copy(individuals + i * m_numberOfWeights, individuals + (i + 1) * m_numberOfWeights, rows.begin() + i * m_rowStride);
+
+	// Rows written after an interrupted append are overwritten, only counted rows belong to archive
+	m_output.seekp(std::streamoff(m_weightsOffset + m_numberOfIndividuals * m_rowStride * sizeof(Neuron)));
+	m_output.write(reinterpret_cast<const char*>(rows.data()), std::streamsize(rows.size() * sizeof(Neuron)));
+	m_output.flush();
+
+	const uint64_t totalNumberOfIndividuals = m_numberOfIndividuals + numberOfIndividuals;
+	m_output.seekp(std::streamoff(offsetof(Header, m_numberOfIndividuals)));
+	m_output.write(reinterpret_cast<const char*>(&totalNumberOfIndividuals), sizeof(totalNumberOfIndividuals));
+	m_output.flush();
+	if (!m_output)
+	{
+		m_lastOperationStatus = ERROR_CANNOT_OPEN_FILE_FOR_WRITING;
+		return false;
+	}
+
+	m_numberOfIndividuals = size_t(totalNumberOfIndividuals);
+	m_lastOperationStatus = SUCCESS_SAVE_COMPLETED;
+	return true;
+}
+
+bool PopulationArchive::Open(const std::string& filename)
+{
+	Close();
+	if (filename.empty())
+	{
+		m_lastOperationStatus = ERROR_EMPTY_FILENAME;
+		return false;
+	}
+
+	if (!m_mappedFile.Open(filename))
+	{
+		m_lastOperationStatus = ERROR_CANNOT_OPEN_FILE_FOR_READING;
+		return false;
+	}
+
+	if (!ReadHeader())
+	{
+		Close();
+		return false;
+	}
+
+	m_lastOperationStatus = SUCCESS_LOAD_COMPLETED;
+	return true;
+}
+
+void PopulationArchive::Close()
+{
+	if (m_output.is_open())
+		m_output.close();
+	m_output.clear();
+	m_mappedFile.Close();
+	m_weightsOffset = 0;
+	m_numberOfWeights = 0;
+	m_rowStride = 0;
+	m_numberOfIndividuals = 0;
+	m_neuronLayerSizes.clear();
+	m_activationFunctionIndexes.clear();
+	m_biasVector.clear();
+}
+
+std::pair<bool, std::string> PopulationArchive::GetLastOperationStatus()
+{
+	auto& description = m_operationsMap[m_lastOperationStatus];
+	switch (m_lastOperationStatus)
+	{
+		case SUCCESS_SAVE_COMPLETED:
+		case SUCCESS_LOAD_COMPLETED:
+			return std::make_pair(true, description);
+		default:
+			break;
+	}
+
+	return std::make_pair(false, description);
+}
+
+std::vector<char> PopulationArchive::MakeTopology(const NeuronLayerSizes& neuronLayerSizes,
+												  const ActivationFunctionIndexes& activationFunctionIndexes,
+												  const BiasVector& biasVector)
+{
+	std::vector<char> topology;
+	auto append = [&](const auto& values) {
+		for (const auto& value : values)
+		{
+			const uint64_t converted = uint64_t(value);
+			const char* bytes = reinterpret_cast<const char*>(&converted);
+			topology.insert(topology.end(), bytes, bytes + sizeof(converted));
+		}
+	};
+
+	append(neuronLayerSizes);
+	append(activationFunctionIndexes);
+	for (const auto& bias : biasVector)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&bias);
+		topology.insert(topology.end(), bytes, bytes + sizeof(bias));
+	}
+
+	topology.resize(Align(sizeof(Header) + topology.size(), m_alignment) - sizeof(Header), 0);
+	return topology;
+}
+
+size_t PopulationArchive::CalculateNumberOfWeights(const NeuronLayerSizes& neuronLayerSizes)
+{
+	size_t numberOfWeights = 0;
+	for (size_t i = 1; i < neuronLayerSizes.size(); ++i)
+		numberOfWeights += neuronLayerSizes[i - 1] * neuronLayerSizes[i];
+	return numberOfWeights;
+}
+
+bool PopulationArchive::ReadHeader()
+{
+	const char* data = m_mappedFile.GetData();
+	const size_t size = m_mappedFile.GetSize();
+	Header header;
+	if (size < sizeof(Header) || std::memcmp(data, m_magic, sizeof(header.m_magic)))
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_NOT_POPULATION_ARCHIVE;
+		return false;
+	}
+
+	std::memcpy(&header, data, sizeof(Header));
+	if (header.m_version > m_version || !(header.m_flags & m_littleEndianFlag) || !BinaryContainer::IsLittleEndian())
+	{
+		m_lastOperationStatus = ERROR_UNSUPPORTED_FILE_VERSION;
+		return false;
+	}
+
+	// Topology has to fit before weights, weights have to be aligned and the counted rows have to be present
+	const uint64_t numberOfLayers = header.m_numberOfLayers;
+	const uint64_t topologySize = numberOfLayers ? numberOfLayers * 3 * sizeof(uint64_t) - 2 * sizeof(uint64_t) : 0;
+	if (numberOfLayers < 2 ||
+		header.m_weightsOffset % m_alignment ||
+		header.m_weightsOffset < sizeof(Header) + topologySize ||
+		header.m_weightsOffset > size ||
+		header.m_rowStride < header.m_numberOfWeights ||
+		header.m_rowStride % (m_alignment / sizeof(Neuron)) ||
+		(header.m_rowStride && header.m_numberOfIndividuals > (size - header.m_weightsOffset) / sizeof(Neuron) / header.m_rowStride))
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	const char* topology = data + sizeof(Header);
+	if (BinaryContainer::CalculateChecksum(topology, size_t(header.m_weightsOffset) - sizeof(Header)) != header.m_topologyChecksum)
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	const size_t numberOfConnections = size_t(numberOfLayers) - 1;
+	m_neuronLayerSizes.resize(size_t(numberOfLayers));
+	m_activationFunctionIndexes.resize(numberOfConnections);
+	m_biasVector.resize(numberOfConnections);
+	for (size_t i = 0; i < m_neuronLayerSizes.size(); ++i, topology += sizeof(uint64_t))
+	{
+		uint64_t value;
+		std::memcpy(&value, topology, sizeof(value));
+		m_neuronLayerSizes[i] = size_t(value);
+	}
+	for (size_t i = 0; i < numberOfConnections; ++i, topology += sizeof(uint64_t))
+	{
+		uint64_t value;
+		std::memcpy(&value, topology, sizeof(value));
+		m_activationFunctionIndexes[i] = ActivationFunctionIndex(value);
+	}
+	std::memcpy(m_biasVector.data(), topology, numberOfConnections * sizeof(Bias));
+
+	if (CalculateNumberOfWeights(m_neuronLayerSizes) != header.m_numberOfWeights)
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	m_weightsOffset = size_t(header.m_weightsOffset);
+	m_numberOfWeights = size_t(header.m_numberOfWeights);
+	m_rowStride = size_t(header.m_rowStride);
+	m_numberOfIndividuals = size_t(header.m_numberOfIndividuals);
+	return true;
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "Neural.hpp"
+#include "ActivationFunctionContext.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <fstream>
+#include <map>
+
+// Archive of many individuals which share one artificial neural network topology
+// Layout: header (magic, version, flags, topology checksum, offsets and counts), topology (layer sizes, activation function indexes, biases), weights matrix
+// Weights matrix has one row per individual, rows are padded to 64 bytes so that every individual starts at a cache line
+// Archive is read through memory mapping, individuals are returned as pointers into the mapping without copying
+// Values are stored in native little-endian byte order, archives are not loaded on big-endian platforms
+class PopulationArchive final
+{
+public:
+
+	PopulationArchive();
+
+	~PopulationArchive();
+
+	// Creates archive with given topology and no individuals, existing file is overwritten
+	bool Create(const std::string& filename,
+				const NeuronLayerSizes& neuronLayerSizes,
+				const ActivationFunctionIndexes& activationFunctionIndexes,
+				const BiasVector& biasVector);
+
+	// Opens existing archive for appending, returns false if its topology is different from given one
+	bool OpenForAppending(const std::string& filename,
+						  const NeuronLayerSizes& neuronLayerSizes,
+						  const ActivationFunctionIndexes& activationFunctionIndexes,
+						  const BiasVector& biasVector);
+
+	// Appends individuals stored one after another, every individual has number of weights neurons
+	// Number of individuals in header is updated after rows are written so that archive is never in a partial state
+	bool Append(const Neuron* individuals, size_t numberOfIndividuals);
+
+	// Maps archive for reading, individuals appended later are visible after archive is opened again
+	bool Open(const std::string& filename);
+
+	// Closes archive opened for reading or appending
+	void Close();
+
+	// Returns true if archive is opened for reading
+	inline bool IsOpen() const
+	{
+		return m_mappedFile.IsOpen();
+	}
+
+	// Returns number of individuals
+	inline size_t GetNumberOfIndividuals() const
+	{
+		return m_numberOfIndividuals;
+	}
+
+	// Returns number of weights of every individual
+	inline size_t GetNumberOfWeights() const
+	{
+		return m_numberOfWeights;
+	}
+
+	// Returns weights of individual, pointer is valid until archive is closed
+	inline const Neuron* GetIndividual(size_t index) const
+	{
+		return reinterpret_cast<const Neuron*>(m_mappedFile.GetData() + m_weightsOffset) + index * m_rowStride;
+	}
+
+	// Returns neuron layer sizes
+	inline const NeuronLayerSizes& GetNeuronLayerSizes() const
+	{
+		return m_neuronLayerSizes;
+	}
+
+	// Returns activation function indexes
+	inline const ActivationFunctionIndexes& GetActivationFunctionIndexes() const
+	{
+		return m_activationFunctionIndexes;
+	}
+
+	// Returns bias vector
+	inline const BiasVector& GetBiasVector() const
+	{
+		return m_biasVector;
+	}
+
+	// Returns the result of last operation, true in case of success
+	std::pair<bool, std::string> GetLastOperationStatus();
+
+private:
+
+	// Header of archive, it is read directly from the mapping
+	struct Header
+	{
+		char m_magic[4];
+		uint16_t m_version;
+		uint16_t m_flags;
+		uint32_t m_topologyChecksum;
+		uint32_t m_reserved;
+		uint64_t m_weightsOffset; // Offset of the first row in bytes
+		uint64_t m_numberOfWeights;
+		uint64_t m_rowStride; // Number of neurons in row including padding
+		uint64_t m_numberOfIndividuals;
+		uint64_t m_numberOfLayers;
+		uint64_t m_padding;
+	};
+
+	// Serializes topology, padding is added so that weights matrix starts at 64 bytes boundary
+	static std::vector<char> MakeTopology(const NeuronLayerSizes& neuronLayerSizes,
+										  const ActivationFunctionIndexes& activationFunctionIndexes,
+										  const BiasVector& biasVector);
+
+	// Returns number of weights of topology
+	static size_t CalculateNumberOfWeights(const NeuronLayerSizes& neuronLayerSizes);
+
+	// Rounds value up to the multiple of alignment
+	inline static size_t Align(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// Fills fields from header and topology of mapped file, returns false if archive is incorrect
+	bool ReadHeader();
+
+	// Status
+	enum
+	{
+		ERROR_UNKNOWN,
+		SUCCESS_SAVE_COMPLETED,
+		SUCCESS_LOAD_COMPLETED,
+		ERROR_EMPTY_FILENAME,
+		ERROR_CANNOT_OPEN_FILE_FOR_WRITING,
+		ERROR_CANNOT_OPEN_FILE_FOR_READING,
+		ERROR_FILE_IS_NOT_POPULATION_ARCHIVE,
+		ERROR_UNSUPPORTED_FILE_VERSION,
+		ERROR_FILE_IS_CORRUPTED,
+		ERROR_DIFFERENT_TOPOLOGY,
+		ERROR_ARCHIVE_IS_NOT_OPENED_FOR_APPENDING,
+		LAST_ENUM_OPERATION_INDEX
+	};
+
+	inline static const char m_magic[5] = "AVSP";
+	inline static const uint16_t m_version = 1;
+	inline static const uint16_t m_littleEndianFlag = 1 << 0;
+	inline static const size_t m_alignment = 64;
+	std::fstream m_output; // Archive opened for appending
+	MappedFile m_mappedFile; // Archive opened for reading
+	size_t m_weightsOffset;
+	size_t m_numberOfWeights;
+	size_t m_rowStride;
+	size_t m_numberOfIndividuals;
+	NeuronLayerSizes m_neuronLayerSizes;
+	ActivationFunctionIndexes m_activationFunctionIndexes;
+	BiasVector m_biasVector;
+	size_t m_lastOperationStatus;
+	std::map<const size_t, const std::string> m_operationsMap;
+};
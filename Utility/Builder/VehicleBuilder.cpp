@@ -201,9 +201,6 @@ void VehicleBuilder::ClearInternal()
 
 bool VehicleBuilder::LoadInternal(std::ifstream& input)
 {
-	// Get window size
-	const auto windowSize = CoreWindow::GetWindowSize();
-	
 	// Read number of vehicle body points
 	size_t vehicleBodyNumberOfPoints = 0;
 	input.read((char*)&vehicleBodyNumberOfPoints, sizeof(vehicleBodyNumberOfPoints));
@@ -212,14 +209,72 @@ bool VehicleBuilder::LoadInternal(std::ifstream& input)
 		return false;
 
 	// Read vehicle body points
-	for (size_t i = 0; i < vehicleBodyNumberOfPoints; ++i)
+	std::vector<double> bodyPoints(vehicleBodyNumberOfPoints * 2);
+	input.read((char*)bodyPoints.data(), std::streamsize(bodyPoints.size() * sizeof(double)));
+
+	// Read number of vehicle sensors
+	size_t numberOfSensors = 0;
+	input.read((char*)&numberOfSensors, sizeof(numberOfSensors));
+
+	if (!ValidateNumberOfSensors(numberOfSensors))
+		return false;
+
+	// Read vehicle sensor's positions, angles and motion ranges
+	std::vector<double> sensorPoints(numberOfSensors * 2);
+	std::vector<double> sensorAngles(numberOfSensors);
+	std::vector<double> sensorMotionRanges(numberOfSensors);
+	input.read((char*)sensorPoints.data(), std::streamsize(sensorPoints.size() * sizeof(double)));
+	input.read((char*)sensorAngles.data(), std::streamsize(sensorAngles.size() * sizeof(double)));
+	input.read((char*)sensorMotionRanges.data(), std::streamsize(sensorMotionRanges.size() * sizeof(double)));
+	if (!input)
+	{
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	return LoadPrototype(bodyPoints, sensorPoints, sensorAngles, sensorMotionRanges);
+}
+
+bool VehicleBuilder::LoadInternal(const BinaryContainer& container)
+{
+	std::vector<double> bodyPoints;
+	std::vector<double> sensorPoints;
+	std::vector<double> sensorAngles;
+	std::vector<double> sensorMotionRanges;
+	if (!container.GetSection(m_bodySection, bodyPoints) ||
+		!container.GetSection(m_sensorPointsSection, sensorPoints) ||
+		!container.GetSection(m_sensorAnglesSection, sensorAngles) ||
+		!container.GetSection(m_sensorMotionRangesSection, sensorMotionRanges) ||
+		bodyPoints.size() % 2 ||
+		sensorPoints.size() != sensorAngles.size() * 2 ||
+		sensorMotionRanges.size() != sensorAngles.size())
 	{
-		double x = 0.0;
-		double y = 0.0;
-		input.read((char*)&x, sizeof(x));
-		input.read((char*)&y, sizeof(y));
-		x *= double(windowSize.x);
-		y *= double(windowSize.y);
+		m_lastOperationStatus = ERROR_FILE_IS_CORRUPTED;
+		return false;
+	}
+
+	if (!ValidateNumberOfBodyPoints(bodyPoints.size() / 2))
+		return false;
+
+	if (!ValidateNumberOfSensors(sensorAngles.size()))
+		return false;
+
+	return LoadPrototype(bodyPoints, sensorPoints, sensorAngles, sensorMotionRanges);
+}
+
+bool VehicleBuilder::LoadPrototype(const std::vector<double>& bodyPoints,
+								   const std::vector<double>& sensorPoints,
+								   const std::vector<double>& sensorAngles,
+								   const std::vector<double>& sensorMotionRanges)
+{
+	// Get window size
+	const auto windowSize = CoreWindow::GetWindowSize();
+
+	// Set vehicle body points
+	for (size_t i = 0; i < bodyPoints.size(); i += 2)
+	{
+		const double x = bodyPoints[i] * double(windowSize.x);
+		const double y = bodyPoints[i + 1] * double(windowSize.y);
 		m_prototype.AddBodyPoint(sf::Vector2f(float(x), float(y)));
 	}
 
@@ -232,22 +287,12 @@ bool VehicleBuilder::LoadInternal(std::ifstream& input)
 	if (!ValidateBodyAsConvexPolygon())
 		return false;
 
-	// Read number of vehicle sensors
-	size_t numberOfSensors = 0;
-	input.read((char*)&numberOfSensors, sizeof(numberOfSensors));
-
-	if (!ValidateNumberOfSensors(numberOfSensors))
-		return false;
-
-	// Read vehicle sensor's positions
+	// Set vehicle sensor's positions
+	const size_t numberOfSensors = sensorAngles.size();
 	for (size_t i = 0; i < numberOfSensors; ++i)
 	{
-		double x = 0.0;
-		double y = 0.0;
-		input.read((char*)&x, sizeof(x));
-		input.read((char*)&y, sizeof(y));
-		x *= double(windowSize.x);
-		y *= double(windowSize.y);
+		const double x = sensorPoints[i * 2] * double(windowSize.x);
+		const double y = sensorPoints[i * 2 + 1] * double(windowSize.y);
 		m_prototype.AddSensor(sf::Vector2f(float(x), float(y)), 0.0, GetDefaultSensorMotionRange());
 	}
 
@@ -257,81 +302,70 @@ bool VehicleBuilder::LoadInternal(std::ifstream& input)
 	if (!ValidateSensorPositionsOverBody())
 		return false;
 
-	// Read vehicle sensor's angles
+	// Set vehicle sensor's angles
 	for (size_t i = 0; i < numberOfSensors; ++i)
 	{
-		double angle = 0.0;
-		input.read((char*)&angle, sizeof(angle));
-
-		if (!ValidateSensorAngle(angle))
+		if (!ValidateSensorAngle(sensorAngles[i]))
 			return false;
 
-		m_prototype.SetSensorBeamAngle(i, angle);
+		m_prototype.SetSensorBeamAngle(i, sensorAngles[i]);
 	}
 
-	// Read vehicle sensor's motion range
+	// Set vehicle sensor's motion range
 	for (size_t i = 0; i < numberOfSensors; ++i)
 	{
-		double motionRange = 0.0;
-		input.read((char*)&motionRange, sizeof(motionRange));
-
-		if (!ValidateSensorMotionRange(motionRange))
+		if (!ValidateSensorMotionRange(sensorMotionRanges[i]))
 			return false;
 
-		m_prototype.SetSensorMotionRange(i, motionRange);
+		m_prototype.SetSensorMotionRange(i, sensorMotionRanges[i]);
 	}
 
 	return true;
 }
 
-bool VehicleBuilder::SaveInternal(std::ofstream& output)
+bool VehicleBuilder::SaveInternal(BinaryContainer& container)
 {
 	// Get window size
 	const auto windowSize = CoreWindow::GetWindowSize();
 
-	// Save number of vehicle body points
+	// Save vehicle body points, positions are relative to window size
 	const size_t vehicleBodyNumberOfPoints = m_prototype.GetNumberOfBodyPoints();
-	output.write((const char*)&vehicleBodyNumberOfPoints, sizeof(vehicleBodyNumberOfPoints));
-
-	// Save vehicle body points
+	std::vector<double> bodyPoints;
+	bodyPoints.reserve(vehicleBodyNumberOfPoints * 2);
 	for (size_t i = 0; i < vehicleBodyNumberOfPoints; ++i)
 	{
-		double x = double(m_prototype.GetBodyPoint(i).x) / double(windowSize.x);
-		double y = double(m_prototype.GetBodyPoint(i).y) / double(windowSize.y);
-		output.write((const char*)&x, sizeof(x));
-		output.write((const char*)&y, sizeof(y));
+		bodyPoints.push_back(double(m_prototype.GetBodyPoint(i).x) / double(windowSize.x));
+		bodyPoints.push_back(double(m_prototype.GetBodyPoint(i).y) / double(windowSize.y));
 	}
 
-	// Save number of vehicle sensors
+	// Save vehicle sensor's positions, angles and motion ranges
 	const size_t numberOfSensors = m_prototype.GetNumberOfSensors();
-	output.write((const char*)&numberOfSensors, sizeof(numberOfSensors));
-
-	// Save vehicle sensor's positions
+	std::vector<double> sensorPoints;
+	std::vector<double> sensorAngles;
+	std::vector<double> sensorMotionRanges;
+	sensorPoints.reserve(numberOfSensors * 2);
+	sensorAngles.reserve(numberOfSensors);
+	sensorMotionRanges.reserve(numberOfSensors);
 	for (size_t i = 0; i < numberOfSensors; ++i)
 	{
-		double x = double(m_prototype.GetSensorPoint(i).x) / double(windowSize.x);
-		double y = double(m_prototype.GetSensorPoint(i).y) / double(windowSize.y);
-		output.write((const char*)&x, sizeof(x));
-		output.write((const char*)&y, sizeof(y));
-	}
-
-	// Save vehicle sensor's angles
-	for (size_t i = 0; i < numberOfSensors; ++i)
-	{
-		double angle = m_prototype.GetSensorBeamAngle(i);
-		output.write((const char*)&angle, sizeof(angle));
-	}
-
-	// Save vehicle sensor's motion range
-	for (size_t i = 0; i < numberOfSensors; ++i)
-	{
-		double motionRange = m_prototype.GetSensorMotionRange(i);
-		output.write((const char*)&motionRange, sizeof(motionRange));
+		sensorPoints.push_back(double(m_prototype.GetSensorPoint(i).x) / double(windowSize.x));
+		sensorPoints.push_back(double(m_prototype.GetSensorPoint(i).y) / double(windowSize.y));
+		sensorAngles.push_back(m_prototype.GetSensorBeamAngle(i));
+		sensorMotionRanges.push_back(m_prototype.GetSensorMotionRange(i));
 	}
 
+	container.AddSection(m_bodySection, bodyPoints);
+	container.AddSection(m_sensorPointsSection, sensorPoints);
+	container.AddSection(m_sensorAnglesSection, sensorAngles);
+	container.AddSection(m_sensorMotionRangesSection, sensorMotionRanges);
 	return true;
 }
 
+uint32_t VehicleBuilder::GetContainerType() const
+{
+	return m_containerType;
+}
+
 void VehicleBuilder::CreateDummyInternal()
 {
 	sf::Vector2f dummySize = GetMaxBodyBound();
@@ -31,6 +31,11 @@ class VehicleBuilder final :
 	static sf::Vector2f m_defaultSensorSize;
 	static float m_maxMass;
 	static float m_maxInertia;
+	inline static const uint32_t m_containerType = BinaryContainer::MakeIdentifier("VHCL");
+	inline static const uint32_t m_bodySection = BinaryContainer::MakeIdentifier("BODY"); // Body points relative to window size
+	inline static const uint32_t m_sensorPointsSection = BinaryContainer::MakeIdentifier("SNSP"); // Sensor positions relative to window size
+	inline static const uint32_t m_sensorAnglesSection = BinaryContainer::MakeIdentifier("SNSA");
+	inline static const uint32_t m_sensorMotionRangesSection = BinaryContainer::MakeIdentifier("SNSM");
 
 	// Validates number of vehicle body points
 	bool ValidateNumberOfBodyPoints(size_t count);
@@ -62,11 +67,23 @@ class VehicleBuilder final :
 	// Clears internal fields
 	void ClearInternal();
 
-	// Sets internal fields from loaded file
+	// Sets internal fields from legacy file
 	bool LoadInternal(std::ifstream& input);
 
-	// Saves internal fields into the file
-	bool SaveInternal(std::ofstream& output);
+	// Sets internal fields from container
+	bool LoadInternal(const BinaryContainer& container);
+
+	// Sets vehicle prototype from coordinates relative to window size and validates it
+	bool LoadPrototype(const std::vector<double>& bodyPoints,
+					   const std::vector<double>& sensorPoints,
+					   const std::vector<double>& sensorAngles,
+					   const std::vector<double>& sensorMotionRanges);
+
+	// Saves internal fields into container
+	bool SaveInternal(BinaryContainer& container);
+
+	// Returns container file type of vehicle
+	uint32_t GetContainerType() const;
 
 	// Creates vehicle prototype dummy
 	void CreateDummyInternal();
@@ -207,12 +224,13 @@ public:
 	}
 
 	// Returns default color that will be used to color vehicle body based on provided mass
+	// Color is returned in current palette
 	inline static sf::Color CalculateDefaultColor(const float mass)
 	{
 		const float ratio = mass / m_maxMass;
 		constexpr sf::Uint8 ceiling = sf::Uint8(ColorContext::MaxChannelValue * 0.9f);
 		const sf::Uint8 channel = ColorContext::MaxChannelValue - sf::Uint8(ceiling * ratio);
-		return ColorContext::Create(channel, channel, channel, ColorContext::MaxChannelValue);
+		return ColorContext::Convert(ColorContext::Create(channel, channel, channel, ColorContext::MaxChannelValue));
 	}
 
 	// Slowly calculates vehicle mass based on provided vehicle body points
@@ -23,7 +23,7 @@ Neuron ActivationFunctionContext::Compute(const size_t index, const Neuron neuro
 {
 	if (index >= ACTIVATION_FUNCTIONS_COUNT)
 	{
-		CoreLogger::PrintError("Activation function index is out of range!");
+		LOG_RATE_LIMITED(CoreLogger::LEVEL_ERROR, "Activation function index is out of range!");
 		return m_activationFunctionTable[LINEAR_ACTIVATION_FUNCTION](neuron);
 	}
 
@@ -3,29 +3,102 @@
 
 namespace ColorContext
 {
+	const sf::Uint8 MaxChannelValue = 255;
+	const sf::Uint8 MinChannelValue = 0;
 	const sf::Color ClearBackground = sf::Color(0xFF, 0xFF, 0xFF, 0);
 	const sf::Color DarkBackground = sf::Color(0x19, 0x19, 0x19, 0xFF);
 	const sf::Color LightBackground = sf::Color(0xE5, 0xE5, 0xE5, 0xFF);
-	const sf::Color BeamBeggining = sf::Color(0xE5, 0xE5, 0xE5, 144);
-	const sf::Color BeamEnd = sf::Color(0xE5, 0xE5, 0xE5, 32);
 	const sf::Color BeamDisabled = ClearBackground;
-	const sf::Color VehicleSensorDefault = sf::Color(0xAA, 0x4A, 0x44, 0xFF);
-	const sf::Color VehicleSensorMarked = sf::Color(0x7F, 0xFF, 0x00, 0xFF);
-	const sf::Color LeaderVehicle = sf::Color(0x60, 0x83, 0x41, 0xFF);
-	const sf::Color ActiveText = sf::Color(0xFF, 0xAA, 0x1D, 0xFF);
-	const sf::Color InactiveText = sf::Color(0xC0, 0xC0, 0xC0, 0xFF);
-	const sf::Color PassiveText = sf::Color::White;
-	const sf::Color ErrorText = sf::Color(0xEE, 0x4B, 0x2B, 0xFF);
-	const sf::Color SuccessText = sf::Color(0x22, 0x8B, 0x22, 0xFF);
-	const sf::Color EdgeDefault = LightBackground;
-	const sf::Color EdgeMarked = ActiveText;
-	const sf::Color EdgeRemove = ErrorText;
-	const sf::Color NeuronDefault = DarkBackground;
-	const sf::Color NeuronActive = LightBackground;
-	const sf::Color Grid = sf::Color(0, 0, 255, 96);
-	const sf::Color WeightDefault = sf::Color(255, 255, 255, 128);
-	const sf::Uint8 MaxChannelValue = 255;
-	const sf::Uint8 MinChannelValue = 0;
+
+	// Palettes, light palette is the dark palette with inverted color channels
+	enum : size_t
+	{
+		DARK_PALETTE,
+		LIGHT_PALETTE,
+		NUMBER_OF_PALETTES
+	};
+
+	// Colors of dark palette
+	namespace DarkPalette
+	{
+		const sf::Color Background = DarkBackground;
+		const sf::Color BeamBeggining = sf::Color(0xE5, 0xE5, 0xE5, 144);
+		const sf::Color BeamEnd = sf::Color(0xE5, 0xE5, 0xE5, 32);
+		const sf::Color VehicleSensorDefault = sf::Color(0xAA, 0x4A, 0x44, 0xFF);
+		const sf::Color VehicleSensorMarked = sf::Color(0x7F, 0xFF, 0x00, 0xFF);
+		const sf::Color LeaderVehicle = sf::Color(0x60, 0x83, 0x41, 0xFF);
+		const sf::Color ActiveText = sf::Color(0xFF, 0xAA, 0x1D, 0xFF);
+		const sf::Color InactiveText = sf::Color(0xC0, 0xC0, 0xC0, 0xFF);
+		const sf::Color PassiveText = sf::Color::White;
+		const sf::Color ErrorText = sf::Color(0xEE, 0x4B, 0x2B, 0xFF);
+		const sf::Color SuccessText = sf::Color(0x22, 0x8B, 0x22, 0xFF);
+		const sf::Color EdgeDefault = LightBackground;
+		const sf::Color EdgeMarked = ActiveText;
+		const sf::Color EdgeRemove = ErrorText;
+		const sf::Color NeuronDefault = DarkBackground;
+		const sf::Color NeuronActive = LightBackground;
+		const sf::Color Grid = sf::Color(0, 0, 255, 96);
+		const sf::Color WeightDefault = sf::Color(255, 255, 255, 128);
+	}
+
+	// Colors of current palette, they are changed only by SetPalette
+	// Objects that cache colors have to convert them when current palette is different from palette they were created with
+	inline size_t CurrentPalette = DARK_PALETTE;
+	inline sf::Color Background = DarkPalette::Background;
+	inline sf::Color BeamBeggining = DarkPalette::BeamBeggining;
+	inline sf::Color BeamEnd = DarkPalette::BeamEnd;
+	inline sf::Color VehicleSensorDefault = DarkPalette::VehicleSensorDefault;
+	inline sf::Color VehicleSensorMarked = DarkPalette::VehicleSensorMarked;
+	inline sf::Color LeaderVehicle = DarkPalette::LeaderVehicle;
+	inline sf::Color ActiveText = DarkPalette::ActiveText;
+	inline sf::Color InactiveText = DarkPalette::InactiveText;
+	inline sf::Color PassiveText = DarkPalette::PassiveText;
+	inline sf::Color ErrorText = DarkPalette::ErrorText;
+	inline sf::Color SuccessText = DarkPalette::SuccessText;
+	inline sf::Color EdgeDefault = DarkPalette::EdgeDefault;
+	inline sf::Color EdgeMarked = DarkPalette::EdgeMarked;
+	inline sf::Color EdgeRemove = DarkPalette::EdgeRemove;
+	inline sf::Color NeuronDefault = DarkPalette::NeuronDefault;
+	inline sf::Color NeuronActive = DarkPalette::NeuronActive;
+	inline sf::Color Grid = DarkPalette::Grid;
+	inline sf::Color WeightDefault = DarkPalette::WeightDefault;
+
+	// Returns color of given palette converted to the current palette, alpha channel is kept
+	inline sf::Color Convert(sf::Color color, size_t palette = DARK_PALETTE)
+	{
+		if (palette != CurrentPalette)
+		{
+			color.r = MaxChannelValue - color.r;
+			color.g = MaxChannelValue - color.g;
+			color.b = MaxChannelValue - color.b;
+		}
+
+		return color;
+	}
+
+	// Sets current palette, colors of current palette are recalculated from dark palette
+	inline void SetPalette(size_t palette)
+	{
+		CurrentPalette = palette;
+		Background = Convert(DarkPalette::Background);
+		BeamBeggining = Convert(DarkPalette::BeamBeggining);
+		BeamEnd = Convert(DarkPalette::BeamEnd);
+		VehicleSensorDefault = Convert(DarkPalette::VehicleSensorDefault);
+		VehicleSensorMarked = Convert(DarkPalette::VehicleSensorMarked);
+		LeaderVehicle = Convert(DarkPalette::LeaderVehicle);
+		ActiveText = Convert(DarkPalette::ActiveText);
+		InactiveText = Convert(DarkPalette::InactiveText);
+		PassiveText = Convert(DarkPalette::PassiveText);
+		ErrorText = Convert(DarkPalette::ErrorText);
+		SuccessText = Convert(DarkPalette::SuccessText);
+		EdgeDefault = Convert(DarkPalette::EdgeDefault);
+		EdgeMarked = Convert(DarkPalette::EdgeMarked);
+		EdgeRemove = Convert(DarkPalette::EdgeRemove);
+		NeuronDefault = Convert(DarkPalette::NeuronDefault);
+		NeuronActive = Convert(DarkPalette::NeuronActive);
+		Grid = Convert(DarkPalette::Grid);
+		WeightDefault = Convert(DarkPalette::WeightDefault);
+	}
 
 	// Returns the result of two blended colors based on alpha factor
 	inline sf::Color BlendColors(sf::Color a, sf::Color b, float alpha)
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+
+// Read-only view of a whole file mapped into memory, pages are loaded by the operating system on first access
+// Mapping starts at a page boundary so data aligned inside the file stays aligned in memory
+class MappedFile final
+{
+public:
+
+	MappedFile();
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	const MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps file for reading, previously mapped file is closed, returns false if file cannot be opened or is empty
+	bool Open(const std::string& filename);
+
+	// Unmaps file
+	void Close();
+
+	// Returns true if file is mapped
+	inline bool IsOpen() const
+	{
+		return m_data != nullptr;
+	}
+
+	// Returns first byte of mapped file
+	inline const char* GetData() const
+	{
+		return m_data;
+	}
+
+	// Returns size of mapped file in bytes
+	inline size_t GetSize() const
+	{
+		return m_size;
+	}
+
+private:
+
+	const char* m_data;
+	size_t m_size;
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#endif
+};
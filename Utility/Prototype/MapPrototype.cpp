@@ -50,6 +50,7 @@ bool MapPrototype::AddInnerEdge(Edge edge)
 		m_innerEdgesChainCompleted = MathContext::IsEdgesChain(m_innerEdgesChain);
 		m_outerEdgesGaps.push_back(true);
 		m_outerEdgesChain.push_back({});
+		m_geometryChanged = true;
 		return true;
 	}
 
@@ -73,6 +74,7 @@ bool MapPrototype::AddInnerEdge(Edge edge)
 				m_outerEdgesChain.push_back({});
 			}
 
+			m_geometryChanged = true;
 			return true;
 		}
 	}
@@ -102,6 +104,7 @@ bool MapPrototype::AddOuterEdge(Edge edge)
 			m_outerEdgesGaps[0] = false;
 			m_outerEdgesChain[0] = edge;
 			m_outerEdgesChainCompleted = false;
+			m_geometryChanged = true;
 			return true;
 		}
 		
@@ -126,6 +129,7 @@ bool MapPrototype::AddOuterEdge(Edge edge)
 						m_outerEdgesGaps[i] = false;
 						m_outerEdgesChain[i] = edge;
 						m_outerEdgesChainCompleted = m_numberOfOuterEdges == numberOfOuterEdges && MathContext::IsEdgesChain(m_outerEdgesChain);
+						m_geometryChanged = true;
 						return true;
 					}
 				}
@@ -138,6 +142,7 @@ bool MapPrototype::AddOuterEdge(Edge edge)
 
 void MapPrototype::SetEdgesChains(const EdgeVector& innerEdgesChain, const EdgeVector& outerEdgesChain)
 {
+	m_geometryChanged = true;
 	m_innerEdgesChain = innerEdgesChain;
 	m_innerEdgesChainCompleted = MathContext::IsEdgesChain(m_innerEdgesChain);
 
@@ -314,6 +319,7 @@ bool MapPrototype::RemoveEdgesOnIntersection(const Edge& edge)
 			m_outerEdgesChain.resize(size);
 			m_innerEdgesChainCompleted = false;
 			m_outerEdgesChainCompleted = false;
+			m_geometryChanged = true;
 			return true;
 		}
 	}
@@ -344,6 +350,7 @@ bool MapPrototype::RemoveEdgesOnIntersection(const Edge& edge)
 			}
 
 			m_outerEdgesChainCompleted = false;
+			m_geometryChanged = true;
 			return true;
 		}
 	}
@@ -353,39 +360,86 @@ bool MapPrototype::RemoveEdgesOnIntersection(const Edge& edge)
 
 void MapPrototype::DrawEdges()
 {
+	if (m_geometryChanged || m_geometryPalette != ColorContext::CurrentPalette)
+		UpdateGeometry();
+
+	if (m_edgesVertices.empty())
+		return;
+
+	if (sf::VertexBuffer::isAvailable())
+		CoreWindow::Draw(m_edgesBuffer);
+	else
+		CoreWindow::Draw(m_edgesVertices.data(), m_edgesVertices.size(), sf::Lines);
+}
+
+void MapPrototype::DrawCheckpoints()
+{
+	if (m_geometryChanged || m_geometryPalette != ColorContext::CurrentPalette)
+		UpdateGeometry();
+
+	if (m_checkpointsVertices.empty())
+		return;
+
+	if (sf::VertexBuffer::isAvailable())
+		CoreWindow::Draw(m_checkpointsBuffer);
+	else
+		CoreWindow::Draw(m_checkpointsVertices.data(), m_checkpointsVertices.size(), sf::Triangles);
+}
+
+void MapPrototype::UpdateGeometry()
+{
+	// Edges, inner edge without its outer edge is marked
+	m_edgesVertices.clear();
 	for (size_t i = 0; i < m_innerEdgesChain.size(); ++i)
 	{
 		if (m_outerEdgesGaps[i])
 		{
-			m_markedEdgeShape[0].position = m_innerEdgesChain[i][0];
-			m_markedEdgeShape[1].position = m_innerEdgesChain[i][1];
-			CoreWindow::Draw(m_markedEdgeShape.data(), m_markedEdgeShape.size(), sf::Lines);
+			m_edgesVertices.push_back(sf::Vertex(m_innerEdgesChain[i][0], ColorContext::EdgeMarked));
+			m_edgesVertices.push_back(sf::Vertex(m_innerEdgesChain[i][1], ColorContext::EdgeMarked));
 		}
 		else
 		{
-			m_edgeShape[0].position = m_innerEdgesChain[i][0];
-			m_edgeShape[1].position = m_innerEdgesChain[i][1];
-			CoreWindow::Draw(m_edgeShape.data(), m_edgeShape.size(), sf::Lines);
-
-			m_edgeShape[0].position = m_outerEdgesChain[i][0];
-			m_edgeShape[1].position = m_outerEdgesChain[i][1];
-			CoreWindow::Draw(m_edgeShape.data(), m_edgeShape.size(), sf::Lines);
+			m_edgesVertices.push_back(sf::Vertex(m_innerEdgesChain[i][0], ColorContext::EdgeDefault));
+			m_edgesVertices.push_back(sf::Vertex(m_innerEdgesChain[i][1], ColorContext::EdgeDefault));
+			m_edgesVertices.push_back(sf::Vertex(m_outerEdgesChain[i][0], ColorContext::EdgeDefault));
+			m_edgesVertices.push_back(sf::Vertex(m_outerEdgesChain[i][1], ColorContext::EdgeDefault));
 		}
 	}
-}
 
-void MapPrototype::DrawCheckpoints()
-{
+	// Checkpoints, convex checkpoint is triangulated as a fan
+	m_checkpointsVertices.clear();
 	for (size_t i = 0; i < m_checkpoints.size(); ++i)
 	{
 		const sf::Uint8 red = ColorContext::MaxChannelValue * (i % 3);
 		const sf::Uint8 green = ColorContext::MaxChannelValue * ((i + 1) % 3);
 		const sf::Uint8 blue = ColorContext::MaxChannelValue * ((i + 2) % 3);
-		m_checkpointShape.setFillColor(ColorContext::Create(red, green, blue, 96));
-		for (size_t j = 0; j < m_checkpointShape.getPointCount(); ++j)
-			m_checkpointShape.setPoint(j, m_checkpoints[i][j]);
-		CoreWindow::Draw(m_checkpointShape);
+		const sf::Color color = ColorContext::Convert(ColorContext::Create(red, green, blue, 96));
+		for (size_t j = 1; j + 1 < m_checkpoints[i].size(); ++j)
+		{
+			m_checkpointsVertices.push_back(sf::Vertex(m_checkpoints[i][0], color));
+			m_checkpointsVertices.push_back(sf::Vertex(m_checkpoints[i][j], color));
+			m_checkpointsVertices.push_back(sf::Vertex(m_checkpoints[i][j + 1], color));
+		}
 	}
+
+	// Upload vertices once, buffers are drawn every frame with current view
+	if (sf::VertexBuffer::isAvailable())
+	{
+		auto Upload = [](sf::VertexBuffer& buffer, const std::vector<sf::Vertex>& vertices)
+		{
+			if (vertices.empty())
+				return;
+			if (buffer.getVertexCount() != vertices.size())
+				buffer.create(vertices.size());
+			buffer.update(vertices.data());
+		};
+
+		Upload(m_edgesBuffer, m_edgesVertices);
+		Upload(m_checkpointsBuffer, m_checkpointsVertices);
+	}
+
+	m_geometryChanged = false;
+	m_geometryPalette = ColorContext::CurrentPalette;
 }
 
 bool MapPrototype::IsCollision(const VehiclePrototype* vehiclePrototype)
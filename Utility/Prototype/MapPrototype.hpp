@@ -1,6 +1,7 @@
 #pragma once
 #include "ColorContext.hpp"
 #include "VehiclePrototype.hpp"
+#include <SFML/Graphics/VertexBuffer.hpp>
 
 class MapPrototype final
 {
@@ -11,12 +12,21 @@ class MapPrototype final
 	bool m_outerEdgesChainCompleted;
 	size_t m_numberOfOuterEdges;
 	std::vector<bool> m_outerEdgesGaps;
-	EdgeShape m_edgeShape;
-	EdgeShape m_markedEdgeShape;
-	sf::ConvexShape m_checkpointShape;
 	sf::Vector2f m_center;
 	sf::Vector2f m_size;
 
+	// Static geometry, rebuilt only when edges chains are edited or palette is switched
+	// Vertices are uploaded to the vertex buffers if they are available on the graphics card
+	std::vector<sf::Vertex> m_edgesVertices;
+	std::vector<sf::Vertex> m_checkpointsVertices;
+	sf::VertexBuffer m_edgesBuffer;
+	sf::VertexBuffer m_checkpointsBuffer;
+	bool m_geometryChanged;
+	size_t m_geometryPalette; // Palette of static geometry colors
+
+	// Rebuilds static geometry of edges and checkpoints
+	void UpdateGeometry();
+
 	// Searches for possible end point
 	bool FindEndPoint(sf::Vector2f point, const EdgeVector& edges, size_t& index) const;
 
@@ -31,12 +41,13 @@ public:
 				 const RectangleVector& checkpoints) :
 		m_checkpoints(checkpoints),
 		m_center(0.f, 0.f),
-		m_size(0.f, 0.f)
+		m_size(0.f, 0.f),
+		m_edgesBuffer(sf::Lines, sf::VertexBuffer::Static),
+		m_checkpointsBuffer(sf::Triangles, sf::VertexBuffer::Static),
+		m_geometryChanged(true),
+		m_geometryPalette(ColorContext::CurrentPalette)
 	{
 		SetEdgesChains(innerEdgesChain, outerEdgesChain);
-		m_edgeShape[0].color = m_edgeShape[1].color = ColorContext::EdgeDefault;
-		m_markedEdgeShape[0].color = m_markedEdgeShape[1].color = ColorContext::EdgeMarked;
-		m_checkpointShape.setPointCount(checkpoints.back().size());
 	}
 
 	MapPrototype() :
@@ -44,12 +55,12 @@ public:
 		m_outerEdgesChainCompleted(false),
 		m_numberOfOuterEdges(0),
 		m_center(0.f, 0.f),
-		m_size(0.f, 0.f)
+		m_size(0.f, 0.f),
+		m_edgesBuffer(sf::Lines, sf::VertexBuffer::Static),
+		m_checkpointsBuffer(sf::Triangles, sf::VertexBuffer::Static),
+		m_geometryChanged(true),
+		m_geometryPalette(ColorContext::CurrentPalette)
 	{
-		m_edgeShape[0].color = m_edgeShape[1].color = ColorContext::EdgeDefault;
-		m_markedEdgeShape[0].color = m_markedEdgeShape[1].color = ColorContext::EdgeMarked;
-		RectangleVector rectangle;
-		m_checkpointShape.setPointCount(rectangle.size());
 	}
 
 	// Adds inner edge to the inner edges chain container, returns true in case of success
@@ -133,10 +144,10 @@ public:
 	// Returns true if any edge was removed from container
 	bool RemoveEdgesOnIntersection(const Edge& edge);
 
-	// Draws edges in unoptimized manner
+	// Draws edges in one draw call, geometry is rebuilt only after edit
 	void DrawEdges();
 
-	// Draws checkpoints in unoptimized manner
+	// Draws checkpoints in one draw call, geometry is rebuilt only after edit
 	void DrawCheckpoints();
 
 	// Check edges collision vs vehicle prototype
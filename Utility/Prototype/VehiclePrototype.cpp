@@ -6,7 +6,8 @@
 
 VehiclePrototype::VehiclePrototype() :
 	m_center(CoreWindow::GetWindowSize() / 2.f),
-	m_angle(0.0)
+	m_angle(0.0),
+	m_bodyPalette(ColorContext::CurrentPalette)
 {
 	m_bodyShape.setPointCount(0);
 	m_beamShape[0].color = ColorContext::BeamBeggining;
@@ -57,6 +58,7 @@ bool VehiclePrototype::AddBodyPoint(sf::Vector2f point)
 	const auto mass = VehicleBuilder::CalculateMass(m_bodyPoints);
 	const auto color = VehicleBuilder::CalculateDefaultColor(mass);
 	m_bodyShape.setFillColor(color);
+	m_bodyPalette = ColorContext::CurrentPalette;
 	return true;
 }
 
@@ -75,6 +77,7 @@ bool VehiclePrototype::RemoveLastBodyPoint()
 		const auto mass = VehicleBuilder::CalculateMass(m_bodyPoints);
 		const auto color = VehicleBuilder::CalculateDefaultColor(mass);
 		m_bodyShape.setFillColor(color);
+		m_bodyPalette = ColorContext::CurrentPalette;
 		return true;
 	}
 
@@ -230,11 +233,18 @@ void VehiclePrototype::Update()
 
 void VehiclePrototype::DrawBody()
 {
+	if (m_bodyPalette != ColorContext::CurrentPalette)
+	{
+		m_bodyShape.setFillColor(ColorContext::Convert(m_bodyShape.getFillColor(), m_bodyPalette));
+		m_bodyPalette = ColorContext::CurrentPalette;
+	}
+
 	CoreWindow::Draw(m_bodyShape);
 }
 
 void VehiclePrototype::DrawSensors()
 {
+	m_sensorShape.setFillColor(ColorContext::VehicleSensorDefault);
 	for (const auto& beam : m_beamVector)
 	{
 		m_sensorShape.setPosition(beam[0] - VehicleBuilder::GetDefaultSensorSize());
@@ -244,6 +254,8 @@ void VehiclePrototype::DrawSensors()
 
 void VehiclePrototype::DrawBeams()
 {
+	m_beamShape[0].color = ColorContext::BeamBeggining;
+	m_beamShape[1].color = ColorContext::BeamEnd;
 	for (const auto& beam : m_beamVector)
 	{
 		m_beamShape[0].position = beam[0];
@@ -19,6 +19,7 @@ class VehiclePrototype final
 	
 	// Shapes
 	sf::ConvexShape m_bodyShape;
+	size_t m_bodyPalette; // Palette of body shape color
 	EdgeShape m_beamShape;
 	sf::CircleShape m_sensorShape;
 
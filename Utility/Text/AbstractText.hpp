@@ -1,6 +1,7 @@
 #pragma once
 #include "FontContext.hpp"
 #include "CoreWindow.hpp"
+#include "TextBatch.hpp"
 #include "CoreLogger.hpp"
 
 class AbstractText
@@ -10,7 +11,8 @@ protected:
 	const size_t m_size;
 	std::vector<sf::Text> m_texts;
 	std::vector<sf::Vector2f> m_textPositions;
-	
+	bool m_changed; // Set if glyphs of texts have to be rebuilt
+	size_t m_palette; // Palette of texts fill colors
 
 	// Validates number of components
 	void ValidateNumberOfComponents(std::vector<FontContext::Component>& components, const size_t requiredSize)
@@ -22,8 +24,30 @@ protected:
 		}
 	}
 
+	// Sets text string, text is marked as changed only if string is different
+	void SetString(size_t index, const sf::String& string)
+	{
+		if (m_texts[index].getString() != string)
+		{
+			m_texts[index].setString(string);
+			m_changed = true;
+		}
+	}
+
+	// Sets text fill color, text is marked as changed only if color is different
+	void SetFillColor(size_t index, const sf::Color& color)
+	{
+		if (m_texts[index].getFillColor() != color)
+		{
+			m_texts[index].setFillColor(color);
+			m_changed = true;
+		}
+	}
+
 	AbstractText(std::vector<std::string>& strings, size_t size) :
-		m_size(size)
+		m_size(size),
+		m_changed(true),
+		m_palette(ColorContext::CurrentPalette)
 	{
 		m_texts.resize(m_size);
 		m_textPositions.resize(m_size);
@@ -46,6 +70,18 @@ protected:
 	// Update internal implementation
 	virtual void UpdateInternal() = 0;
 
+	// Converts fill colors of texts if palette was switched since they were set
+	void UpdatePalette()
+	{
+		if (m_palette == ColorContext::CurrentPalette)
+			return;
+
+		for (auto& text : m_texts)
+			text.setFillColor(ColorContext::Convert(text.getFillColor(), m_palette));
+		m_palette = ColorContext::CurrentPalette;
+		m_changed = true;
+	}
+
 public:
 
 	virtual ~AbstractText()
@@ -58,18 +94,27 @@ public:
 	// Sets positions of texts
 	virtual void SetPosition(std::vector<FontContext::Component> components) = 0;
 
-	// Updates texts positions and calls internal update implementation
+	// Calls internal update implementation and updates texts positions that were changed
 	void Update()
 	{
+		UpdatePalette();
 		UpdateInternal();
 		for (size_t i = 0; i < m_size; ++i)
-			m_texts[i].setPosition(m_textPositions[i]);
+		{
+			if (m_texts[i].getPosition() != m_textPositions[i])
+			{
+				m_texts[i].setPosition(m_textPositions[i]);
+				m_changed = true;
+			}
+		}
 	}
 
-	// Draws texts
+	// Adds texts to the text batch, glyphs are rebuilt only if texts were changed
 	void Draw()
 	{
+		UpdatePalette();
 		for (size_t i = 0; i < m_size; ++i)
-			CoreWindow::DrawForeground(m_texts[i]);
+			TextBatch::Add(m_texts[i], m_changed);
+		m_changed = false;
 	}
 };
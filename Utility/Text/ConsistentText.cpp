@@ -11,11 +11,13 @@ ConsistentText::ConsistentText(std::vector<std::string> strings) :
 void ConsistentText::SetCharacterSize(unsigned int multiplier)
 {
 	m_texts[0].setCharacterSize(FontContext::GetCharacterSize(multiplier));
+	m_changed = true;
 }
 
 void ConsistentText::SetRotation(float rotation)
 {
 	m_texts[0].setRotation(rotation);
+	m_changed = true;
 }
 
 void ConsistentText::SetPosition(std::vector<FontContext::Component> components)
@@ -56,21 +56,21 @@ void DoubleText::UpdateInternal()
 	{
 		if (m_observer->Ready())
 		{
-			m_texts[VARIABLE_TEXT].setString(m_observer->Read());
+			SetString(VARIABLE_TEXT, m_observer->Read());
 			m_blendTimer->Reset();
 		}
 
 		m_blendTimer->Update();
-		m_texts[VARIABLE_TEXT].setFillColor(ColorContext::BlendColors(ColorContext::ActiveText, ColorContext::InactiveText, float(m_blendTimer->GetValue())));
+		SetFillColor(VARIABLE_TEXT, ColorContext::BlendColors(ColorContext::ActiveText, ColorContext::InactiveText, float(m_blendTimer->GetValue())));
 	}
 }
 
 void DoubleText::SetVariableTextInactiveColor()
 {
-	m_texts[VARIABLE_TEXT].setFillColor(ColorContext::InactiveText);
+	SetFillColor(VARIABLE_TEXT, ColorContext::InactiveText);
 }
 
 void DoubleText::SetVariableTextActiveColor()
 {
-	m_texts[VARIABLE_TEXT].setFillColor(ColorContext::ActiveText);
+	SetFillColor(VARIABLE_TEXT, ColorContext::ActiveText);
 }
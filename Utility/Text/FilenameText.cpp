@@ -54,7 +54,7 @@ void FilenameText<ReadOperations, WriteOperations>::Reset()
 
 	// Set to dummy filename string
 	m_filename = m_filenameDummy;
-	m_texts[VARIABLE_TEXT].setString(m_filename);
+	SetString(VARIABLE_TEXT, m_filename);
 
 	// Set variable text to inactive color
 	SetVariableTextInactiveColor();
@@ -138,7 +138,7 @@ void FilenameText<ReadOperations, WriteOperations>::OnControlKeyPressedEvent(sf:
 			if (m_filename.size() < m_maxFilenameLength)
 			{
 				m_filename += ConvertKeyToAscii(eventKey).second;
-				m_texts[VARIABLE_TEXT].setString(m_filename);
+				SetString(VARIABLE_TEXT, m_filename);
 			}
 		}
 		else
@@ -151,7 +151,7 @@ void FilenameText<ReadOperations, WriteOperations>::OnControlKeyPressedEvent(sf:
 					if (!m_filename.empty() && m_pressedBackspaceKeyTimer.Update())
 					{
 						m_filename.erase(m_filename.begin() + (m_filename.size() - 1));
-						m_texts[VARIABLE_TEXT].setString(m_filename);
+						SetString(VARIABLE_TEXT, m_filename);
 					}
 				}
 				else if (result->first == sf::Keyboard::LShift || result->first == sf::Keyboard::RShift)
@@ -161,7 +161,7 @@ void FilenameText<ReadOperations, WriteOperations>::OnControlKeyPressedEvent(sf:
 					if (m_filename.empty())
 					{
 						m_filename = m_filenameDummy;
-						m_texts[VARIABLE_TEXT].setString(m_filename);
+						SetString(VARIABLE_TEXT, m_filename);
 					}
 
 					m_pressedControlKeys[sf::Keyboard::Escape] = false;
@@ -21,16 +21,16 @@ void StatusText::SetErrorStatusText(std::string text)
 {
 	m_alphaTimer.Reset();
 	TripleText::Reset();
-	m_texts[STATUS_TEXT].setString(text);
-	m_texts[STATUS_TEXT].setFillColor(ColorContext::ErrorText);
+	SetString(STATUS_TEXT, text);
+	SetFillColor(STATUS_TEXT, ColorContext::ErrorText);
 }
 
 void StatusText::SetSuccessStatusText(std::string text)
 {
 	m_alphaTimer.Reset();
 	TripleText::Reset();
-	m_texts[STATUS_TEXT].setString(text);
-	m_texts[STATUS_TEXT].setFillColor(ColorContext::SuccessText);
+	SetString(STATUS_TEXT, text);
+	SetFillColor(STATUS_TEXT, ColorContext::SuccessText);
 }
 
 void StatusText::SetPosition(std::vector<FontContext::Component> components)
@@ -51,6 +51,6 @@ void StatusText::UpdateInternal()
 {
 	m_alphaTimer.Update();
 	auto alpha = ColorContext::MaxChannelValue - sf::Uint8(m_alphaTimer.GetValue());
-	m_texts[STATUS_TEXT].setFillColor(ColorContext::Create(m_texts[STATUS_TEXT].getFillColor(), alpha));
+	SetFillColor(STATUS_TEXT, ColorContext::Create(m_texts[STATUS_TEXT].getFillColor(), alpha));
 	TripleText::UpdateInternal();
 }
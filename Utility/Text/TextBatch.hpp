@@ -0,0 +1,157 @@
+#pragma once
+#include "FontContext.hpp"
+#include "CoreWindow.hpp"
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <vector>
+
+// Retained layer of heads-up display texts drawn on the foreground
+// Glyph quads of all texts drawn in a frame are kept in one vertex array per character size
+// Quads are rebuilt only if the set of drawn texts changed or one of the texts was modified
+class TextBatch final
+{
+	struct Layer
+	{
+		unsigned int m_characterSize;
+		sf::VertexArray m_vertices;
+	};
+
+	inline static std::vector<const sf::Text*> m_texts;
+	inline static std::vector<const sf::Text*> m_previousTexts;
+	inline static std::vector<Layer> m_layers;
+	inline static bool m_changed = true;
+
+	TextBatch();
+
+	// Returns vertex array of texts with given character size
+	inline static sf::VertexArray& GetLayer(unsigned int characterSize)
+	{
+		for (auto& layer : m_layers)
+		{
+			if (layer.m_characterSize == characterSize)
+				return layer.m_vertices;
+		}
+
+		m_layers.push_back({ characterSize, sf::VertexArray(sf::Triangles) });
+		return m_layers.back().m_vertices;
+	}
+
+	// Adds two triangles covering glyph, glyph is transformed with text transform
+	inline static void AddGlyph(sf::VertexArray& vertices, const sf::Transform& transform, float x, float y, const sf::Color& color, const sf::Glyph& glyph)
+	{
+		const float padding = 1.0f;
+		const float left = glyph.bounds.left - padding;
+		const float top = glyph.bounds.top - padding;
+		const float right = glyph.bounds.left + glyph.bounds.width + padding;
+		const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+		const float u1 = float(glyph.textureRect.left) - padding;
+		const float v1 = float(glyph.textureRect.top) - padding;
+		const float u2 = float(glyph.textureRect.left + glyph.textureRect.width) + padding;
+		const float v2 = float(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+		const sf::Vertex topLeft(transform.transformPoint(x + left, y + top), color, sf::Vector2f(u1, v1));
+		const sf::Vertex topRight(transform.transformPoint(x + right, y + top), color, sf::Vector2f(u2, v1));
+		const sf::Vertex bottomRight(transform.transformPoint(x + right, y + bottom), color, sf::Vector2f(u2, v2));
+		const sf::Vertex bottomLeft(transform.transformPoint(x + left, y + bottom), color, sf::Vector2f(u1, v2));
+		vertices.append(topLeft);
+		vertices.append(topRight);
+		vertices.append(bottomLeft);
+		vertices.append(bottomLeft);
+		vertices.append(topRight);
+		vertices.append(bottomRight);
+	}
+
+	// Adds glyph quads of text, layout follows sf::Text without styles and outline
+	inline static void AddText(const sf::Text& text)
+	{
+		const sf::Font* font = text.getFont();
+		const sf::String& string = text.getString();
+		if (!font || string.isEmpty())
+			return;
+
+		const unsigned int characterSize = text.getCharacterSize();
+		sf::VertexArray& vertices = GetLayer(characterSize);
+		const sf::Transform& transform = text.getTransform();
+		const sf::Color& color = text.getFillColor();
+		const float whitespaceWidth = font->getGlyph(L' ', characterSize, false).advance;
+		const float lineSpacing = font->getLineSpacing(characterSize);
+
+		float x = 0.0f;
+		float y = float(characterSize);
+		sf::Uint32 previousCharacter = 0;
+		for (size_t i = 0; i < string.getSize(); ++i)
+		{
+			const sf::Uint32 character = string[i];
+			if (character == L'\r')
+				continue;
+
+			x += font->getKerning(previousCharacter, character, characterSize);
+			previousCharacter = character;
+
+			switch (character)
+			{
+				case L' ':
+					x += whitespaceWidth;
+					continue;
+				case L'\t':
+					x += whitespaceWidth * 4;
+					continue;
+				case L'\n':
+					y += lineSpacing;
+					x = 0.0f;
+					continue;
+			}
+
+			const sf::Glyph& glyph = font->getGlyph(character, characterSize, false);
+			AddGlyph(vertices, transform, x, y, color, glyph);
+			x += glyph.advance;
+		}
+	}
+
+	// Rebuilds glyph quads of all texts drawn in current frame
+	inline static void Rebuild()
+	{
+		for (auto& layer : m_layers)
+			layer.m_vertices.clear();
+
+		for (const auto& text : m_texts)
+			AddText(*text);
+	}
+
+public:
+
+	TextBatch(TextBatch const&) = delete;
+
+	void operator=(TextBatch const&) = delete;
+
+	// Adds text to current frame, changed text causes quads to be rebuilt
+	inline static void Add(const sf::Text& text, bool changed)
+	{
+		m_texts.push_back(&text);
+		if (changed)
+			m_changed = true;
+	}
+
+	// Draws all texts added in current frame with one draw call per character size
+	inline static void Draw()
+	{
+		if (m_changed || m_texts != m_previousTexts)
+		{
+			Rebuild();
+			m_changed = false;
+		}
+
+		for (const auto& layer : m_layers)
+		{
+			if (!layer.m_vertices.getVertexCount())
+				continue;
+
+			sf::RenderStates states(&FontContext::GetFont().getTexture(layer.m_characterSize));
+			CoreWindow::DrawForeground(layer.m_vertices, states);
+		}
+
+		m_previousTexts.swap(m_texts);
+		m_texts.clear();
+	}
+};
@@ -0,0 +1,231 @@
+#pragma once
+#include "CoreLogger.hpp"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes captured frames to disk on its own thread
+// Frames wait in a bounded queue, if the queue is full the frame is dropped so that producer never waits for disk or PNG encoding
+// Neither pushing nor stopping waits for the writer thread, pixel buffers of written frames are reused
+class FrameWriter final
+{
+public:
+
+	// Frame formats
+	enum
+	{
+		PNG_FORMAT, // Every frame is written as separate numbered PNG file
+		RAW_FORMAT // Frames are appended as RGBA pixels to one stream file
+	};
+
+	FrameWriter(size_t capacity = 16) :
+		m_capacity(capacity),
+		m_running(false),
+		m_writing(false),
+		m_numberOfWrittenFrames(0),
+		m_numberOfDroppedFrames(0)
+	{
+	}
+
+	// Frames left in the queue are written before destruction
+	~FrameWriter()
+	{
+		Stop();
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	// Starts writer thread, if thread is already running nothing happens
+	// Thread that is still writing frames left by the previous stop continues with new frames
+	inline void Start()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_running)
+			return;
+		m_running = true;
+		m_numberOfWrittenFrames = 0;
+		m_numberOfDroppedFrames = 0;
+		if (m_writing)
+			return;
+
+		// Previous thread has already finished, it does not touch the mutex anymore
+		if (m_thread.joinable())
+			m_thread.join();
+		m_writing = true;
+		m_thread = std::thread([this] { Run(); });
+	}
+
+	// Stops accepting frames and returns immediately, writer thread finishes after frames left in the queue are written
+	inline void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+
+		m_condition.notify_one();
+	}
+
+	// Queues frame of given size, its pixels are filled by given function straight into reused pixel buffer
+	// Function receives buffer of RGBA pixels and is not called if frame is dropped
+	// Rows given from bottom to top are flipped by writer thread, returns false if the queue is full and frame was dropped
+	template<class FillFunction>
+	inline bool Push(sf::Vector2u size, bool bottomToTop, const std::string& filename, size_t format, FillFunction fillPixels)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_running || m_frames.size() >= m_capacity)
+		{
+			++m_numberOfDroppedFrames;
+			return false;
+		}
+
+		// Pixel buffers of written frames are reused so that capturing does not allocate
+		Frame frame;
+		if (!m_freeFrames.empty())
+		{
+			frame = std::move(m_freeFrames.back());
+			m_freeFrames.pop_back();
+		}
+		lock.unlock();
+
+		frame.m_pixels.resize(size_t(size.x) * size_t(size.y) * 4);
+		fillPixels(frame.m_pixels.data());
+		frame.m_size = size;
+		frame.m_bottomToTop = bottomToTop;
+		frame.m_filename = filename;
+		frame.m_format = format;
+
+		lock.lock();
+		m_frames.push_back(std::move(frame));
+		lock.unlock();
+		m_condition.notify_one();
+		return true;
+	}
+
+	// Returns number of frames written to disk
+	inline size_t GetNumberOfWrittenFrames()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_numberOfWrittenFrames;
+	}
+
+	// Returns number of frames dropped because the queue was full
+	inline size_t GetNumberOfDroppedFrames()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_numberOfDroppedFrames;
+	}
+
+private:
+
+	struct Frame
+	{
+		std::vector<sf::Uint8> m_pixels;
+		sf::Vector2u m_size;
+		bool m_bottomToTop = false;
+		std::string m_filename;
+		size_t m_format = PNG_FORMAT;
+	};
+
+	// Writes frames until writer is stopped and the queue is empty
+	inline void Run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_condition.wait(lock, [this] { return !m_running || !m_frames.empty(); });
+			if (m_frames.empty())
+			{
+				// Raw stream is closed before thread is marked as finished so that next thread can open it
+				m_rawStream.close();
+				m_rawFilename.clear();
+				m_writing = false;
+				break;
+			}
+
+			Frame frame = std::move(m_frames.front());
+			m_frames.pop_front();
+			lock.unlock();
+
+			if (frame.m_bottomToTop)
+				FlipRows(frame);
+			const bool success = Write(frame);
+
+			lock.lock();
+			if (success)
+				++m_numberOfWrittenFrames;
+			m_freeFrames.push_back(std::move(frame));
+		}
+	}
+
+	// Reverses order of pixel rows in place, called only by writer thread
+	inline static void FlipRows(Frame& frame)
+	{
+		const size_t rowSize = size_t(frame.m_size.x) * 4;
+		auto top = frame.m_pixels.begin();
+		auto bottom = frame.m_pixels.begin() + rowSize * (frame.m_size.y ? frame.m_size.y - 1 : 0);
+		for (; top < bottom; top += rowSize, bottom -= rowSize)
+			std::swap_ranges(top, top + rowSize, bottom);
+		frame.m_bottomToTop = false;
+	}
+
+	// Writes frame in its format, called only by writer thread
+	inline bool Write(const Frame& frame)
+	{
+		std::error_code errorCode;
+		const std::filesystem::path directory = std::filesystem::path(frame.m_filename).parent_path();
+		if (!directory.empty())
+			std::filesystem::create_directories(directory, errorCode);
+
+		if (frame.m_format == RAW_FORMAT)
+		{
+			if (frame.m_filename != m_rawFilename)
+			{
+				m_rawStream.close();
+				m_rawStream.open(frame.m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+				m_rawFilename = frame.m_filename;
+			}
+
+			if (!m_rawStream.is_open())
+			{
+				CoreLogger::PrintError("Cannot open frame stream \"" + frame.m_filename + "\"");
+				return false;
+			}
+
+			m_rawStream.write(reinterpret_cast<const char*>(frame.m_pixels.data()), std::streamsize(frame.m_pixels.size()));
+			return bool(m_rawStream);
+		}
+
+		sf::Image image;
+		image.create(frame.m_size.x, frame.m_size.y, frame.m_pixels.data());
+		if (!image.saveToFile(frame.m_filename))
+		{
+			CoreLogger::PrintError("Cannot save frame \"" + frame.m_filename + "\"");
+			return false;
+		}
+
+		return true;
+	}
+
+	const size_t m_capacity;
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Frame> m_frames;
+	std::vector<Frame> m_freeFrames;
+	bool m_running; // Set if frames are accepted
+	bool m_writing; // Set until writer thread finishes
+	size_t m_numberOfWrittenFrames;
+	size_t m_numberOfDroppedFrames;
+
+	// Raw stream, used only by writer thread
+	std::ofstream m_rawStream;
+	std::string m_rawFilename;
+};
@@ -0,0 +1,196 @@
+#include "JobSystem.hpp"
+#include "CoreLogger.hpp"
+#include "CoreProfiler.hpp"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace
+{
+	// Index of worker which runs on this thread, threads which are not workers have no index
+	const size_t NoWorkerIndex = size_t(-1);
+	thread_local size_t CurrentWorkerIndex = NoWorkerIndex;
+	thread_local const JobSystem* CurrentJobSystem = nullptr;
+}
+
+JobSystem::JobSystem(size_t numberOfWorkers, bool pinWorkers) :
+	m_numberOfQueuedJobs(0),
+	m_nextQueue(0),
+	m_running(true)
+{
+	// Threads which are not workers push their jobs into queues in round robin order, at least one queue is needed
+	const size_t numberOfQueues = std::max<size_t>(1, numberOfWorkers);
+	for (size_t i = 0; i < numberOfQueues; ++i)
+		m_queues.push_back(std::make_unique<WorkerQueue>());
+
+	for (size_t i = 0; i < numberOfWorkers; ++i)
+	{
+		m_workers.emplace_back([this, i] { Run(i); });
+		if (pinWorkers)
+			Pin(i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_running.store(false);
+	}
+
+	m_sleepCondition.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+void JobSystem::Initialize(size_t numberOfWorkers, bool pinWorkers)
+{
+	if (m_instanceCreated)
+	{
+		CoreLogger::PrintError("Job system is already initialized");
+		return;
+	}
+
+	m_requestedNumberOfWorkers = numberOfWorkers;
+	m_requestedPinWorkers = pinWorkers;
+	GetInstance();
+	CoreLogger::PrintSuccess("JobSystem initialized correctly with " + std::to_string(numberOfWorkers) + " workers");
+}
+
+JobSystem& JobSystem::GetInstance()
+{
+	static JobSystem instance(m_requestedNumberOfWorkers, m_requestedPinWorkers);
+	m_instanceCreated = true;
+	return instance;
+}
+
+size_t JobSystem::GetDefaultNumberOfWorkers()
+{
+	const size_t numberOfThreads = std::thread::hardware_concurrency();
+	return numberOfThreads > 1 ? numberOfThreads - 1 : 0;
+}
+
+void JobSystem::Submit(Job job, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->Increment();
+		job = [job = std::move(job), counter] {
+			job();
+			counter->Decrement();
+		};
+	}
+
+	// Workers push to their own deque, other threads spread jobs among all deques
+	size_t queueIndex = CurrentWorkerIndex;
+	if (CurrentJobSystem != this || queueIndex == NoWorkerIndex)
+		queueIndex = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+	// Job is counted before it is queued so that the counter never drops below the number of queued jobs
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_numberOfQueuedJobs.fetch_add(1, std::memory_order_release);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_queues[queueIndex]->m_mutex);
+		m_queues[queueIndex]->m_jobs.push_back(std::move(job));
+	}
+	m_sleepCondition.notify_one();
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	const size_t workerIndex = CurrentJobSystem == this ? CurrentWorkerIndex : NoWorkerIndex;
+	Job job;
+	while (!counter.IsFinished())
+	{
+		if (TakeJob(workerIndex, job))
+			job();
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::Run(size_t workerIndex)
+{
+	CurrentWorkerIndex = workerIndex;
+	CurrentJobSystem = this;
+	PROFILE_THREAD(("Worker " + std::to_string(workerIndex)).c_str());
+
+	Job job;
+	while (true)
+	{
+		if (TakeJob(workerIndex, job))
+		{
+			job();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepCondition.wait(lock, [this] { return m_numberOfQueuedJobs.load(std::memory_order_acquire) > 0 || !m_running.load(); });
+		if (!m_running.load() && m_numberOfQueuedJobs.load() == 0)
+			break;
+	}
+}
+
+bool JobSystem::TakeJob(size_t workerIndex, Job& job)
+{
+	if (m_numberOfQueuedJobs.load(std::memory_order_acquire) == 0)
+		return false;
+
+	// Own deque is used as a stack so that recently queued data is still in cache
+	if (workerIndex != NoWorkerIndex)
+	{
+		auto& queue = *m_queues[workerIndex];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (!queue.m_jobs.empty())
+		{
+			job = std::move(queue.m_jobs.back());
+			queue.m_jobs.pop_back();
+			m_numberOfQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	// Steal the oldest job, the oldest job usually represents the largest part of work
+	const size_t numberOfQueues = m_queues.size();
+	const size_t firstQueue = workerIndex != NoWorkerIndex ? workerIndex + 1 : 0;
+	for (size_t i = 0; i < numberOfQueues; ++i)
+	{
+		auto& queue = *m_queues[(firstQueue + i) % numberOfQueues];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (!queue.m_jobs.empty())
+		{
+			job = std::move(queue.m_jobs.front());
+			queue.m_jobs.pop_front();
+			m_numberOfQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Pin(size_t workerIndex)
+{
+	// Core 0 is left for the main thread
+	const size_t numberOfCores = std::max<size_t>(1, std::thread::hardware_concurrency());
+	const size_t core = (workerIndex + 1) % numberOfCores;
+#ifdef _WIN32
+	if (!SetThreadAffinityMask(m_workers[workerIndex].native_handle(), DWORD_PTR(1) << core))
+		CoreLogger::PrintWarning("Cannot set affinity of worker " + std::to_string(workerIndex));
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	if (pthread_setaffinity_np(m_workers[workerIndex].native_handle(), sizeof(cpu_set_t), &cpuSet))
+		CoreLogger::PrintWarning("Cannot set affinity of worker " + std::to_string(workerIndex));
+#else
+	(void)core;
+#endif
+}
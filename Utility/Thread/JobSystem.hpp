@@ -0,0 +1,229 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counter of unfinished jobs, used to wait for a group of jobs
+class JobCounter final
+{
+	std::atomic<size_t> m_count;
+
+public:
+
+	JobCounter() :
+		m_count(0)
+	{
+	}
+
+	// Returns true if all jobs of the group are finished
+	inline bool IsFinished() const
+	{
+		return m_count.load(std::memory_order_acquire) == 0;
+	}
+
+	// Adds unfinished job
+	inline void Increment()
+	{
+		m_count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Marks job as finished
+	inline void Decrement()
+	{
+		m_count.fetch_sub(1, std::memory_order_acq_rel);
+	}
+};
+
+// Central work-stealing scheduler shared by simulation, genetic algorithm and map processing
+// Every worker owns a deque, it takes its own jobs from the back and steals from the front of other deques
+// Thread which waits for jobs executes queued jobs meanwhile so that nested parallel loops do not deadlock
+class JobSystem final
+{
+public:
+
+	using Job = std::function<void()>;
+
+	// Creates workers, if number of workers is zero jobs are executed by threads which wait for them
+	// If workers are pinned every worker is bound to its own CPU core
+	JobSystem(size_t numberOfWorkers, bool pinWorkers = false);
+
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+
+	const JobSystem& operator=(const JobSystem&) = delete;
+
+	// Sets number of workers and CPU affinity of the shared job system, has to be called before its first use
+	// Default number of workers is number of hardware threads minus one
+	static void Initialize(size_t numberOfWorkers = GetDefaultNumberOfWorkers(), bool pinWorkers = false);
+
+	// Returns shared job system
+	static JobSystem& GetInstance();
+
+	// Returns number of hardware threads minus one, the calling thread is the remaining one
+	static size_t GetDefaultNumberOfWorkers();
+
+	// Returns number of workers
+	inline size_t GetNumberOfWorkers() const
+	{
+		return m_workers.size();
+	}
+
+	// Queues job, counter is incremented now and decremented when the job is finished
+	void Submit(Job job, JobCounter* counter = nullptr);
+
+	// Waits until all jobs counted by counter are finished, the calling thread executes queued jobs meanwhile
+	void Wait(const JobCounter& counter);
+
+	// Calls function(begin, end) for chunks of range [begin, end) in parallel and waits for all of them
+	// Chunks have at most grain size elements, the calling thread executes the first chunk
+	template<class Function>
+	void ParallelFor(size_t begin, size_t end, size_t grainSize, const Function& function)
+	{
+		if (begin >= end)
+			return;
+
+		grainSize = std::max<size_t>(1, grainSize);
+		if (m_workers.empty() || end - begin <= grainSize)
+		{
+			function(begin, end);
+			return;
+		}
+
+		JobCounter counter;
+		for (size_t chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += grainSize)
+		{
+			const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+			Submit([&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); }, &counter);
+		}
+
+		function(begin, begin + grainSize);
+		Wait(counter);
+	}
+
+	// Calls function(begin, end) in parallel with grain size chosen so that every thread gets a few chunks
+	template<class Function>
+	void ParallelFor(size_t begin, size_t end, const Function& function)
+	{
+		const size_t numberOfChunks = (m_workers.size() + 1) * 4;
+		ParallelFor(begin, end, (end > begin ? end - begin : 0) / numberOfChunks + 1, function);
+	}
+
+	// Queues function and returns future of its result
+	// Future should not be waited for inside a job, use counters instead so that the worker keeps executing jobs
+	template<class Function>
+	auto Async(Function function) -> std::future<decltype(function())>
+	{
+		using Result = decltype(function());
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+		auto future = task->get_future();
+
+		// Without workers nobody would execute the job, it is executed immediately
+		if (m_workers.empty())
+			(*task)();
+		else
+			Submit([task] { (*task)(); });
+		return future;
+	}
+
+private:
+
+	// Deque of one worker, front is stolen by other threads and back is used by the owner
+	struct WorkerQueue
+	{
+		std::mutex m_mutex;
+		std::deque<Job> m_jobs;
+	};
+
+	// Runs jobs until job system is destroyed
+	void Run(size_t workerIndex);
+
+	// Takes job from the back of own deque or steals job from the front of other deques
+	bool TakeJob(size_t workerIndex, Job& job);
+
+	// Binds worker thread to CPU core
+	void Pin(size_t workerIndex);
+
+	std::vector<std::thread> m_workers;
+	std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+	std::atomic<size_t> m_numberOfQueuedJobs;
+	std::atomic<size_t> m_nextQueue; // Queue used by next job submitted by thread which is not a worker
+	std::atomic<bool> m_running;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_sleepCondition;
+
+	inline static size_t m_requestedNumberOfWorkers = GetDefaultNumberOfWorkers();
+	inline static bool m_requestedPinWorkers = false;
+	inline static bool m_instanceCreated = false;
+};
+
+// Acyclic graph of jobs, job is queued when all jobs it depends on are finished
+class JobGraph final
+{
+	struct Node
+	{
+		JobSystem::Job m_job;
+		std::vector<size_t> m_dependents;
+		size_t m_numberOfDependencies;
+	};
+
+	std::vector<Node> m_nodes;
+
+public:
+
+	JobGraph()
+	{
+	}
+
+	~JobGraph()
+	{
+	}
+
+	// Adds job, returns its index
+	inline size_t AddJob(JobSystem::Job job)
+	{
+		m_nodes.push_back({ std::move(job), {}, 0 });
+		return m_nodes.size() - 1;
+	}
+
+	// Job with index job will be started after job with index dependency is finished
+	inline void AddDependency(size_t job, size_t dependency)
+	{
+		m_nodes[dependency].m_dependents.push_back(job);
+		++m_nodes[job].m_numberOfDependencies;
+	}
+
+	// Runs all jobs and waits until they are finished
+	void Run(JobSystem& jobSystem)
+	{
+		JobCounter counter;
+		std::vector<std::atomic<size_t>> pending(m_nodes.size());
+		for (size_t i = 0; i < m_nodes.size(); ++i)
+			pending[i].store(m_nodes[i].m_numberOfDependencies);
+
+		// Dependents are queued before the job is marked as finished so that counter cannot reach zero too early
+		std::function<void(size_t)> runNode = [&](size_t index) {
+			m_nodes[index].m_job();
+			for (const auto& dependent : m_nodes[index].m_dependents)
+			{
+				if (pending[dependent].fetch_sub(1) == 1)
+					jobSystem.Submit([&runNode, dependent] { runNode(dependent); }, &counter);
+			}
+		};
+
+		for (size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			if (!m_nodes[i].m_numberOfDependencies)
+				jobSystem.Submit([&runNode, i] { runNode(i); }, &counter);
+		}
+
+		jobSystem.Wait(counter);
+	}
+};
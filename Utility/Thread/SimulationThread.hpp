@@ -0,0 +1,76 @@
+#pragma once
+#include "CoreProfiler.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Thread which calls simulation function in a loop independently from rendering
+// Function receives real time elapsed since its previous call and returns false when simulation is finished
+class SimulationThread final
+{
+public:
+
+	SimulationThread() :
+		m_running(false),
+		m_finished(false)
+	{
+	}
+
+	~SimulationThread()
+	{
+		Stop();
+	}
+
+	// Starts thread, if thread is already running it is stopped first
+	inline void Start(std::function<bool(double)> function)
+	{
+		Stop();
+		m_running.store(true);
+		m_finished.store(false);
+		m_thread = std::thread([this, function] {
+			PROFILE_THREAD("Simulation");
+			auto previousTime = std::chrono::steady_clock::now();
+			while (m_running.load(std::memory_order_relaxed))
+			{
+				const auto currentTime = std::chrono::steady_clock::now();
+				const double elapsedTime = std::chrono::duration<double>(currentTime - previousTime).count();
+				previousTime = currentTime;
+				if (!function(elapsedTime))
+				{
+					m_finished.store(true);
+					break;
+				}
+
+				// Give time to other threads, simulation catches up with real time in the next call
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+	}
+
+	// Stops thread and waits until the last function call is finished
+	inline void Stop()
+	{
+		m_running.store(false);
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	// Returns true if thread is running
+	inline bool IsRunning() const
+	{
+		return m_running.load() && !m_finished.load();
+	}
+
+	// Returns true if simulation function reported that simulation is finished
+	inline bool IsFinished() const
+	{
+		return m_finished.load();
+	}
+
+private:
+
+	std::thread m_thread;
+	std::atomic<bool> m_running;
+	std::atomic<bool> m_finished;
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include "CoreLogger.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Statistics of one generation
+struct GenerationStatistics
+{
+	size_t m_generation = 0;
+	double m_highestFitnessRatio = 0.0; // Highest fitness overall in percents of max fitness
+	double m_meanFitnessRatio = 0.0;
+	double m_numberOfSucceededIndividualsRatio = 0.0; // In percents of population size
+	double m_bestTime = 0.0; // Best time overall for the highest fitness
+	double m_meanTime = 0.0;
+	double m_highestFitness = 0.0;
+	double m_meanFitness = 0.0;
+	size_t m_numberOfSucceededIndividuals = 0;
+};
+
+// Streams statistics of every generation to CSV file on its own thread
+// Rows are appended as soon as generation ends, file is flushed after every batch and synced to disk periodically
+// so that statistics of long runs survive a crash and can be read while the run is in progress
+class StatisticsWriter final
+{
+public:
+
+	StatisticsWriter(double syncInterval = 5.0) :
+		m_syncInterval(syncInterval),
+		m_running(false),
+		m_file(nullptr),
+		m_numberOfWrittenRecords(0)
+	{
+	}
+
+	~StatisticsWriter()
+	{
+		Stop();
+	}
+
+	StatisticsWriter(const StatisticsWriter&) = delete;
+
+	const StatisticsWriter& operator=(const StatisticsWriter&) = delete;
+
+	// Returns filename with given prefix and current local time, so that every run gets its own file
+	inline static std::string MakeFilename(const std::string& prefix)
+	{
+		char buffer[32] = {};
+		const std::time_t now = std::time(nullptr);
+		std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", std::localtime(&now));
+		return prefix + "_" + buffer + ".csv";
+	}
+
+	// Creates file with header row and starts writer thread, previous file is closed
+	inline bool Start(const std::string& filename)
+	{
+		Stop();
+		m_file = std::fopen(filename.c_str(), "w");
+		if (!m_file)
+		{
+			CoreLogger::PrintError("Cannot open statistics stream \"" + filename + "\"");
+			return false;
+		}
+
+		std::fputs(m_header, m_file);
+		std::fflush(m_file);
+		m_numberOfWrittenRecords = 0;
+		m_running = true;
+		m_thread = std::thread([this] { Run(); });
+		return true;
+	}
+
+	// Writes records which are left in the queue, syncs and closes file
+	inline void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+
+		m_condition.notify_one();
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+	// Queues statistics of generation, producer never waits for disk
+	inline void Push(const GenerationStatistics& statistics)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_running)
+				return;
+			m_records.push_back(statistics);
+		}
+		m_condition.notify_one();
+	}
+
+	// Returns number of records written to file
+	inline size_t GetNumberOfWrittenRecords()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_numberOfWrittenRecords;
+	}
+
+private:
+
+	// Writes queued records in batches until writer is stopped and the queue is empty
+	inline void Run()
+	{
+		auto lastSync = std::chrono::steady_clock::now();
+		bool synced = true;
+		std::deque<GenerationStatistics> records;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_condition.wait_for(lock, std::chrono::duration<double>(m_syncInterval), [this] { return !m_running || !m_records.empty(); });
+			records.swap(m_records);
+			const bool running = m_running;
+			lock.unlock();
+
+			for (const auto& record : records)
+				Write(record);
+			if (!records.empty())
+			{
+				std::fflush(m_file);
+				synced = false;
+			}
+
+			// Records already flushed are handed over to the disk from time to time and always at the end
+			const auto now = std::chrono::steady_clock::now();
+			if (!synced && (!running || std::chrono::duration<double>(now - lastSync).count() >= m_syncInterval))
+			{
+				Sync();
+				lastSync = now;
+				synced = true;
+			}
+
+			lock.lock();
+			m_numberOfWrittenRecords += records.size();
+			records.clear();
+			if (!running && m_records.empty())
+				break;
+		}
+		lock.unlock();
+
+		std::fclose(m_file);
+		m_file = nullptr;
+	}
+
+	// Formats record as one CSV row, called only by writer thread
+	inline void Write(const GenerationStatistics& record)
+	{
+		std::fprintf(m_file, "%zu;%f;%f;%f;%f;%f;%f;%f;%zu\n",
+			record.m_generation,
+			record.m_highestFitnessRatio,
+			record.m_meanFitnessRatio,
+			record.m_numberOfSucceededIndividualsRatio,
+			record.m_bestTime,
+			record.m_meanTime,
+			record.m_highestFitness,
+			record.m_meanFitness,
+			record.m_numberOfSucceededIndividuals);
+	}
+
+	// Forces flushed data to disk
+	inline void Sync()
+	{
+#ifdef _WIN32
+		_commit(_fileno(m_file));
+#else
+		fsync(fileno(m_file));
+#endif
+	}
+
+	inline static const char* const m_header = "generation;highest_fitness_ratio;mean_fitness_ratio;succeeded_individuals_ratio;best_time;mean_time;highest_fitness;mean_fitness;succeeded_individuals\n";
+	const double m_syncInterval; // Seconds
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<GenerationStatistics> m_records;
+	bool m_running;
+	std::FILE* m_file; // Used by writer thread while it runs
+	size_t m_numberOfWrittenRecords;
+};
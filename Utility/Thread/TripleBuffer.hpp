@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+// Lock-free single producer single consumer triple buffer
+// Producer fills back buffer and publishes it, consumer always reads the newest published buffer
+// Neither side ever waits for the other one
+template<class Type>
+class TripleBuffer final
+{
+public:
+
+	TripleBuffer() :
+		m_back(0),
+		m_middle(1),
+		m_front(2)
+	{
+	}
+
+	~TripleBuffer()
+	{
+	}
+
+	// Resets buffer indexes, can be called only when there is no producer and consumer running
+	inline void Reset()
+	{
+		m_back = 0;
+		m_middle.store(1);
+		m_front = 2;
+	}
+
+	// Returns buffer that is filled by producer
+	inline Type& GetBack()
+	{
+		return m_buffers[m_back];
+	}
+
+	// Publishes back buffer, producer gets buffer that was not consumed yet or already consumed one
+	inline void Publish()
+	{
+		m_back = m_middle.exchange(m_back | m_dirtyBit, std::memory_order_acq_rel) & m_indexMask;
+	}
+
+	// Takes the newest published buffer, returns false if nothing was published since last call
+	inline bool Consume()
+	{
+		if (!(m_middle.load(std::memory_order_acquire) & m_dirtyBit))
+			return false;
+
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & m_indexMask;
+		return true;
+	}
+
+	// Returns buffer that was consumed last time
+	inline const Type& GetFront() const
+	{
+		return m_buffers[m_front];
+	}
+
+private:
+
+	inline static const size_t m_dirtyBit = 4;
+	inline static const size_t m_indexMask = 3;
+	std::array<Type, 3> m_buffers;
+	size_t m_back; // Used only by producer
+	std::atomic<size_t> m_middle; // Shared buffer index with dirty bit set when it was published
+	size_t m_front; // Used only by consumer
+};
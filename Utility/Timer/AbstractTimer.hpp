@@ -55,6 +55,12 @@ public:
 		return m_value;
 	}
 
+	// Sets current value
+	inline void SetValue(double value)
+	{
+		m_value = value;
+	}
+
 	// Returns multiplier
 	inline double GetMultiplier() const
 	{
@@ -19,7 +19,13 @@ public:
 	// Updates value, in case of timeout calculation is keep on running
 	inline bool Update() override
 	{
-		m_value += CoreWindow::GetElapsedTime() * m_multiplier;
+		return Update(CoreWindow::GetElapsedTime());
+	}
+
+	// Updates value using specified elapsed time, in case of timeout calculation is keep on running
+	inline bool Update(double elapsedTime)
+	{
+		m_value += elapsedTime * m_multiplier;
 		if (m_value > m_timeout)
 		{
 			m_value = m_resetValue;
@@ -20,7 +20,13 @@ public:
 	// Update value with periodic function
 	inline bool Update() override
 	{
-		m_value += CoreWindow::GetElapsedTime() * m_multiplier * m_resetValue;
+		return Update(CoreWindow::GetElapsedTime());
+	}
+
+	// Update value with periodic function using specified elapsed time
+	inline bool Update(double elapsedTime)
+	{
+		m_value += elapsedTime * m_multiplier * m_resetValue;
 		if (m_value * m_resetValue > m_timeout)
 		{
 			m_value = m_timeout * m_resetValue;
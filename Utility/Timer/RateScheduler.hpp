@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+
+// Fixed step scheduler that decouples physics, sensor and controller rates from frame rate
+// Sensor and controller rates are rounded to the whole number of physics steps,
+// thanks to that ticks are the same on every machine no matter what the frame rate is
+class RateScheduler final
+{
+public:
+
+	explicit RateScheduler(size_t physicsRate = 600, size_t sensorRate = 60, size_t controllerRate = 60) :
+		m_maxNumberOfSteps(0)
+	{
+		SetRates(physicsRate, sensorRate, controllerRate);
+	}
+
+	~RateScheduler()
+	{
+	}
+
+	// Sets physics, sensor and controller rates (in hertz) and resets scheduler
+	inline void SetRates(size_t physicsRate, size_t sensorRate, size_t controllerRate)
+	{
+		m_physicsRate = physicsRate ? physicsRate : 1;
+		m_physicsTimeStep = 1.0 / double(m_physicsRate);
+		m_sensorInterval = CalculateInterval(sensorRate);
+		m_controllerInterval = CalculateInterval(controllerRate);
+		Reset();
+	}
+
+	// Resets accumulated time and step counter
+	inline void Reset()
+	{
+		m_accumulatedTime = 0.0;
+		m_step = 0;
+	}
+
+	// Sets max number of physics steps returned by single accumulation, zero means quarter of second
+	inline void SetMaxNumberOfSteps(size_t maxNumberOfSteps)
+	{
+		m_maxNumberOfSteps = maxNumberOfSteps;
+	}
+
+	// Returns max number of physics steps returned by single accumulation
+	inline size_t GetMaxNumberOfSteps() const
+	{
+		if (m_maxNumberOfSteps)
+			return m_maxNumberOfSteps;
+		return m_physicsRate / 4 ? m_physicsRate / 4 : 1;
+	}
+
+	// Accumulates elapsed time and returns number of physics steps that have to be performed
+	// After a stall number of steps is clamped and excess time is dropped, so that simulation does not fall behind forever
+	inline size_t Accumulate(double elapsedTime)
+	{
+		m_accumulatedTime += elapsedTime;
+		size_t numberOfSteps = size_t(m_accumulatedTime / m_physicsTimeStep);
+		const size_t maxNumberOfSteps = GetMaxNumberOfSteps();
+		if (numberOfSteps > maxNumberOfSteps)
+		{
+			numberOfSteps = maxNumberOfSteps;
+			m_accumulatedTime = 0.0;
+			return numberOfSteps;
+		}
+
+		m_accumulatedTime -= double(numberOfSteps) * m_physicsTimeStep;
+		return numberOfSteps;
+	}
+
+	// Returns true if sensors should be updated in current physics step
+	inline bool IsSensorTick() const
+	{
+		return m_step % m_sensorInterval == 0;
+	}
+
+	// Returns true if controller should be updated in current physics step
+	inline bool IsControllerTick() const
+	{
+		return m_step % m_controllerInterval == 0;
+	}
+
+	// Moves scheduler to the next physics step
+	inline void Step()
+	{
+		++m_step;
+	}
+
+	// Returns number of physics steps performed since last reset
+	inline size_t GetStep() const
+	{
+		return m_step;
+	}
+
+	// Returns physics rate
+	inline size_t GetPhysicsRate() const
+	{
+		return m_physicsRate;
+	}
+
+	// Returns physics time step
+	inline double GetPhysicsTimeStep() const
+	{
+		return m_physicsTimeStep;
+	}
+
+	// Returns number of physics steps between two sensor ticks
+	inline size_t GetSensorInterval() const
+	{
+		return m_sensorInterval;
+	}
+
+	// Returns number of physics steps between two controller ticks
+	inline size_t GetControllerInterval() const
+	{
+		return m_controllerInterval;
+	}
+
+	// Returns time between two sensor ticks
+	inline double GetSensorTimeStep() const
+	{
+		return m_physicsTimeStep * double(m_sensorInterval);
+	}
+
+	// Returns time between two controller ticks
+	inline double GetControllerTimeStep() const
+	{
+		return m_physicsTimeStep * double(m_controllerInterval);
+	}
+
+private:
+
+	// Calculates number of physics steps between two ticks of specified rate
+	inline size_t CalculateInterval(size_t rate) const
+	{
+		if (!rate || rate >= m_physicsRate)
+			return 1;
+		return size_t(double(m_physicsRate) / double(rate) + 0.5);
+	}
+
+	size_t m_physicsRate;
+	double m_physicsTimeStep;
+	size_t m_sensorInterval;
+	size_t m_controllerInterval;
+	size_t m_maxNumberOfSteps;
+	double m_accumulatedTime;
+	size_t m_step;
+};
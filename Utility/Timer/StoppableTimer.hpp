@@ -19,7 +19,13 @@ public:
 	// Updates value, in case of timeout calculation is stopped (value does not change)
 	inline bool Update() override
 	{
-		const double elapsedTime = CoreWindow::GetElapsedTime() * m_multiplier;
+		return Update(CoreWindow::GetElapsedTime());
+	}
+
+	// Updates value using specified elapsed time, in case of timeout calculation is stopped (value does not change)
+	inline bool Update(double elapsedTime)
+	{
+		elapsedTime *= m_multiplier;
 
 		if (m_value + elapsedTime >= m_timeout)
 			return true;
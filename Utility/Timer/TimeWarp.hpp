@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+// Time warp tells simulation thread how many physics steps should be performed per frame
+// Warp is changed by render thread and read by simulation thread, throughput is measured by simulation thread
+class TimeWarp final
+{
+public:
+
+	TimeWarp() :
+		m_warp(REAL_TIME_WARP)
+	{
+		Restart();
+	}
+
+	~TimeWarp()
+	{
+	}
+
+	// Sets real time warp
+	inline void Reset()
+	{
+		m_warp.store(REAL_TIME_WARP);
+	}
+
+	// Increases number of steps per frame
+	inline void Increase()
+	{
+		const size_t warp = m_warp.load();
+		if (warp < FRAME_BUDGET_WARP)
+			m_warp.store(warp + 1);
+	}
+
+	// Decreases number of steps per frame
+	inline void Decrease()
+	{
+		const size_t warp = m_warp.load();
+		if (warp > REAL_TIME_WARP)
+			m_warp.store(warp - 1);
+	}
+
+	// Returns true if number of steps is calculated from real elapsed time
+	inline bool IsRealTime() const
+	{
+		return m_warp.load() == REAL_TIME_WARP;
+	}
+
+	// Returns true if steps are performed for as long as frame budget allows
+	inline bool IsFrameBudget() const
+	{
+		return m_warp.load() == FRAME_BUDGET_WARP;
+	}
+
+	// Returns fixed number of steps per frame, zero is returned for real time and frame budget warps
+	inline size_t GetStepsPerFrame() const
+	{
+		return m_stepsPerFrame[m_warp.load()];
+	}
+
+	// Returns time in which steps of one frame should be performed in case of frame budget warp
+	inline static double GetFrameBudget()
+	{
+		return 1.0 / 60.0;
+	}
+
+	// Returns time warp as a string
+	inline std::string ToString() const
+	{
+		const size_t warp = m_warp.load();
+		if (warp == REAL_TIME_WARP)
+			return "Real time";
+		if (warp == FRAME_BUDGET_WARP)
+			return "Max steps per frame";
+		return std::to_string(m_stepsPerFrame[warp]) + " steps per frame";
+	}
+
+	// Resets frame time and throughput measurement, should be called when simulation is started
+	inline void Restart()
+	{
+		m_frameTime = 0.0;
+		m_measuredSteps = 0;
+		m_measuredSimulatedTime = 0.0;
+		m_measuredTime = 0.0;
+		m_simulatedSecondsPerSecond = 0.0;
+		m_stepsPerSecond = 0.0;
+	}
+
+	// Accumulates elapsed time, returns true if steps of the next frame should be performed
+	inline bool UpdateFrame(double elapsedTime)
+	{
+		m_frameTime += elapsedTime;
+		if (m_frameTime < GetFrameBudget())
+			return false;
+		m_frameTime = 0.0;
+		return true;
+	}
+
+	// Adds steps performed within elapsed time, throughput is recalculated once per second
+	inline void MeasureThroughput(size_t numberOfSteps, double simulatedTime, double elapsedTime)
+	{
+		m_measuredSteps += numberOfSteps;
+		m_measuredSimulatedTime += simulatedTime;
+		m_measuredTime += elapsedTime;
+		if (m_measuredTime >= 1.0)
+		{
+			m_simulatedSecondsPerSecond = m_measuredSimulatedTime / m_measuredTime;
+			m_stepsPerSecond = double(m_measuredSteps) / m_measuredTime;
+			m_measuredSteps = 0;
+			m_measuredSimulatedTime = 0.0;
+			m_measuredTime = 0.0;
+		}
+	}
+
+	// Returns simulated seconds per real second
+	inline double GetSimulatedSecondsPerSecond() const
+	{
+		return m_simulatedSecondsPerSecond;
+	}
+
+	// Returns physics steps per real second
+	inline double GetStepsPerSecond() const
+	{
+		return m_stepsPerSecond;
+	}
+
+	// Returns throughput as a string
+	inline static std::string ToThroughputString(double simulatedSecondsPerSecond, double stepsPerSecond)
+	{
+		const size_t tenths = size_t(simulatedSecondsPerSecond * 10.0 + 0.5);
+		return std::to_string(tenths / 10) + "." + std::to_string(tenths % 10) + " sim-s/s, " + std::to_string(size_t(stepsPerSecond + 0.5)) + " steps/s";
+	}
+
+private:
+
+	enum
+	{
+		REAL_TIME_WARP,
+		FRAME_BUDGET_WARP = 8,
+		WARPS_COUNT
+	};
+
+	static constexpr std::array<size_t, WARPS_COUNT> m_stepsPerFrame = { 0, 10, 25, 50, 100, 250, 500, 1000, 0 };
+	std::atomic<size_t> m_warp;
+
+	// Frame time and throughput, used only by simulation thread
+	double m_frameTime;
+	size_t m_measuredSteps;
+	double m_measuredSimulatedTime;
+	double m_measuredTime;
+	double m_simulatedSecondsPerSecond;
+	double m_stepsPerSecond;
+};